@@ -73,6 +73,13 @@
 #define FILE_SEPARATOR		"/"
 #endif /* __riscos */
 
+/* The size of the stdio buffers of the input and output streams */
+#if defined(__dos)
+#define STREAM_BUFFER_SIZE	BUFSIZ
+#else
+#define STREAM_BUFFER_SIZE	65536
+#endif /* __dos */
+
 /* PNG chunk names */
 #define PNG_CN_IDAT		0x49444154
 #define PNG_CN_IEND		0x49454e44
@@ -252,6 +259,9 @@
 /* Prototypes */
 
 /* asc85enc.c */
+extern void	vASCII85SetBinary(BOOL);
+extern size_t	tGetASCII85Length(void);
+extern void	vASCII85EncodeBuffer(FILE *, const UCHAR *, size_t);
 extern void	vASCII85EncodeByte(FILE *, int);
 extern void	vASCII85EncodeArray(FILE *, FILE *, size_t);
 extern void	vASCII85EncodeFile(FILE *, FILE *, size_t);
@@ -286,6 +296,8 @@ extern BOOL	bAdd2DataBlockList(const data_block_type *);
 extern ULONG	ulGetDataOffset(FILE *);
 extern BOOL	bSetDataOffset(FILE *, ULONG);
 extern int	iNextByte(FILE *);
+extern const UCHAR	*aucNextBytes(FILE *, size_t, size_t *);
+extern size_t	tNextBytes(FILE *, UCHAR *, size_t);
 extern USHORT	usNextWord(FILE *);
 extern ULONG	ulNextLong(FILE *);
 extern USHORT	usNextWordBE(FILE *);
@@ -309,8 +321,10 @@ extern void	vCreateDocumentInfoList(const document_block_type *);
 extern UCHAR	ucGetDopHdrFtrSpecification(void);
 /* draw.c & output.c */
 extern BOOL	bAddDummyImage(diagram_type *, const imagedata_type *);
+extern BOOL	bAddRepeatedImage(diagram_type *,
+			ULONG, const imagedata_type *);
 extern diagram_type *pCreateDiagram(const char *, const char *);
-extern void	vPrologue2(diagram_type *, int);
+extern void	vPrologue2(diagram_type *, FILE *, int);
 extern void	vMove2NextLine(diagram_type *, drawfile_fontref, USHORT);
 extern void	vSubstring2Diagram(diagram_type *,
 			char *, size_t, long, UCHAR, USHORT,
@@ -342,7 +356,8 @@ extern void	vScaleButtonClick(mouse_block *, diagram_type *);
 extern BOOL	bScaleKeyPressed(event_pollblock *, void *);
 extern BOOL	bScaleEventHandler(event_pollblock *, void *);
 #else
-extern void	vImagePrologue(diagram_type *, const imagedata_type *);
+extern void	vImagePrologue(diagram_type *,
+			ULONG, const imagedata_type *);
 extern void	vImageEpilogue(diagram_type *);
 extern void	vDestroyDiagram(diagram_type *);
 #endif /* __riscos */
@@ -366,6 +381,7 @@ extern void	vSubstringFMT(diagram_type *, const char *, size_t, long,
 extern void	vDestroyFontInfoList(void);
 extern void	vCorrectFontValues(font_block_type *);
 extern void	vAdd2FontInfoList(const font_block_type *);
+extern void	vSetFontInfoStreaming(BOOL);
 extern const font_block_type	*pGetNextFontInfoListItem(
 					const font_block_type *);
 /* fonts.c */
@@ -416,6 +432,7 @@ extern image_info_enum	eExamineImage(FILE *, ULONG, imagedata_type *);
 /* imgtrans */
 extern BOOL	bTranslateImage(diagram_type *,
 			FILE *, BOOL, ULONG, const imagedata_type *);
+extern BOOL	bExtractImages(FILE *, long, const char *, const char *);
 /* jpeg2eps.c & jpeg2spr.c */
 extern BOOL	bTranslateJPEG(diagram_type *,
 			FILE *, ULONG, size_t, const imagedata_type *);
@@ -441,6 +458,8 @@ extern BOOL	bReadBytes(UCHAR *, size_t, ULONG, FILE *);
 extern BOOL	bReadBuffer(FILE *, ULONG, const ULONG *, size_t, size_t,
 			UCHAR *, ULONG, size_t);
 extern ULONG	ulColor2Color(UCHAR);
+extern void	vResetSplit(output_type *);
+extern void	vUpdateSplit(output_type *, size_t);
 extern output_type *pSplitList(output_type *);
 extern size_t	tNumber2Roman(UINT, BOOL, char *);
 extern size_t	tNumber2Alpha(UINT, BOOL, char *);
@@ -486,9 +505,12 @@ extern void	vCreateInfoDictionary(diagram_type *, int);
 extern void	vProloguePDF(diagram_type *,
 			const char *, const options_type *);
 extern void	vEpiloguePDF(diagram_type *);
-extern void	vImageProloguePDF(diagram_type *, const imagedata_type *);
+extern void	vImageProloguePDF(diagram_type *,
+			ULONG, const imagedata_type *);
 extern void	vImageEpiloguePDF(diagram_type *);
 extern BOOL	bAddDummyImagePDF(diagram_type *, const imagedata_type *);
+extern BOOL	bAddRepeatedImagePDF(diagram_type *,
+			ULONG, const imagedata_type *);
 extern void	vAddFontsPDF(diagram_type *);
 extern void	vMove2NextLinePDF(diagram_type *, USHORT);
 extern void	vSubstringPDF(diagram_type *,
@@ -501,6 +523,9 @@ extern void	vEndOfPagePDF(diagram_type *, BOOL);
 extern void	vDestroyPictInfoList(void);
 extern void	vAdd2PictInfoList(const picture_block_type *);
 extern ULONG	ulGetPictInfoListItem(ULONG);
+extern size_t	tCountPictInfoListItems(ULONG);
+extern const picture_block_type	*pGetNextPictInfoListItem(
+					const picture_block_type *);
 /* png2eps.c & png2spr.c */
 extern BOOL	bTranslatePNG(diagram_type *,
 			FILE *, ULONG, size_t, const imagedata_type *);
@@ -508,10 +533,13 @@ extern BOOL	bTranslatePNG(diagram_type *,
 extern void	vProloguePS(diagram_type *,
 			const char *, const char *, const options_type *);
 extern void	vEpiloguePS(diagram_type *);
-extern void	vImageProloguePS(diagram_type *, const imagedata_type *);
+extern void	vImageProloguePS(diagram_type *,
+			ULONG, const imagedata_type *);
 extern void	vImageEpiloguePS(diagram_type *);
 extern BOOL	bAddDummyImagePS(diagram_type *, const imagedata_type *);
-extern void	vAddFontsPS(diagram_type *);
+extern BOOL	bAddRepeatedImagePS(diagram_type *,
+			ULONG, const imagedata_type *);
+extern void	vAddFontsPS(diagram_type *, FILE *);
 extern void	vMove2NextLinePS(diagram_type *, USHORT);
 extern void	vSubstringPS(diagram_type *,
 				char *, size_t, long, UCHAR, USHORT,
@@ -572,23 +600,38 @@ extern void	vGet8StyleInfo(int,
 extern void	vGet8LstInfo(FILE *, const pps_info_type *,
 			const ULONG *, size_t, const ULONG *, size_t,
 			const UCHAR *);
-extern void	vGet8PapInfo(FILE *, const pps_info_type *,
-			const ULONG *, size_t, const ULONG *, size_t,
-			const UCHAR *);
 extern void	vGet8FontInfo(int, USHORT,
 			const UCHAR *, int, font_block_type *);
-extern void	vGet8ChrInfo(FILE *, const pps_info_type *,
+extern void	vGet8PapChrInfo(FILE *, const pps_info_type *,
 			const ULONG *, size_t, const ULONG *, size_t,
-			const UCHAR *);
+			const UCHAR *, BOOL, BOOL);
+extern void	vDestroy8ChrStream(void);
+extern BOOL	bGet8NextChrPage(void);
 /* properties.c */
+extern size_t	tGetFkpRuns(const UCHAR *, size_t, fkp_run_type *);
+extern int	iGetSprmLength(const UCHAR *, int, const UCHAR *);
+extern void	vDecodeGrpprl(const sprm_table_type *, sprm_target_enum,
+			const UCHAR *, int, void *);
+extern void	vSetFontToggle(font_block_type *, USHORT, UCHAR);
 extern void	vGetPropertyInfo(FILE *, const pps_info_type *,
 			const ULONG *, size_t, const ULONG *, size_t,
 			const UCHAR *, int);
 extern row_info_enum	ePropMod2RowInfo(USHORT, int);
+extern void	vDestroyPropertyCache(void);
+extern BOOL	bGetCachedFontInfo(USHORT, const UCHAR *, int,
+			font_block_type *);
+extern void	vAdd2FontInfoCache(USHORT, const UCHAR *, int,
+			const font_block_type *);
+extern BOOL	bGetCachedStyleInfo(USHORT, const UCHAR *, int,
+			style_block_type *);
+extern void	vAdd2StyleInfoCache(USHORT, const UCHAR *, int,
+			const style_block_type *);
 /* propmod.c */
 extern void	vDestroyPropModList(void);
 extern void	vAdd2PropModList(const UCHAR *);
 extern const UCHAR	*aucReadPropModListItem(USHORT);
+extern int	iGetPropModRowInfo(USHORT);
+extern void	vSetPropModRowInfo(USHORT, row_info_enum);
 /* rowlist.c */
 extern void	vDestroyRowInfoList(void);
 extern void	vAdd2RowInfoList(const row_block_type *);
@@ -620,6 +663,13 @@ extern const section_block_type *
 		pGetSectionInfo(const section_block_type *, ULONG);
 extern size_t	tGetNumberOfSections(void);
 extern UCHAR	ucGetSepHdrFtrSpecification(size_t);
+/* stats.c */
+extern void	vResetStatistics(BOOL);
+extern void	vStartPhase(stats_phase_enum);
+extern void	vStopPhase(stats_phase_enum);
+extern void	vCountRead(ULONG, size_t);
+extern void	vCountListItem(stats_list_enum);
+extern void	vPrintStatistics(FILE *, const char *, long);
 /* stylelist.c */
 extern void	vDestroyStyleInfoList(void);
 extern level_type_enum	eGetNumType(UCHAR);
@@ -714,6 +764,18 @@ extern void	*xcalloc(size_t, size_t);
 extern void 	*xrealloc(void *, size_t);
 extern char	*xstrdup(const char *);
 extern void 	*xfree(void *);
+extern void	vResetAllocStatistics(void);
+extern void	vPrintAllocStatistics(FILE *);
+#if defined(ALLOC_PROFILE)
+extern void	*xmalloc_at(size_t, const char *, int);
+extern void	*xcalloc_at(size_t, size_t, const char *, int);
+extern void	*xrealloc_at(void *, size_t, const char *, int);
+extern char	*xstrdup_at(const char *, const char *, int);
+#define xmalloc(s)	xmalloc_at((s), __FILE__, __LINE__)
+#define xcalloc(n,s)	xcalloc_at((n), (s), __FILE__, __LINE__)
+#define xrealloc(p,s)	xrealloc_at((p), (s), __FILE__, __LINE__)
+#define xstrdup(s)	xstrdup_at((s), __FILE__, __LINE__)
+#endif /* ALLOC_PROFILE */
 /* xml.c */
 extern void	vCreateBookIntro(diagram_type *, int);
 extern void	vPrologueXML(diagram_type *, const options_type *);
@@ -16,11 +16,14 @@
 #include <stdio.h>
 #include "antiword.h"
 
-static const ULONG	aulPower85[5] = {
-	1UL, 85UL, 85UL * 85, 85UL * 85 * 85, 85UL * 85 * 85 * 85,
-};
+#define LINE_LENGTH	64	/* Number of characters in an output line */
+
 static int	iOutBytes = 0;	/* Number of characters in an output line */
-static char	cCharPrev = '\0';
+static char	acLine[LINE_LENGTH + 3];	/* Room for the End Of Data */
+static UCHAR	aucGroup[4];	/* The bytes of an incomplete group */
+static int	iInGroup = 0;	/* Number of bytes in an incomplete group */
+static BOOL	bBinary = FALSE;	/* Copy the bytes without encoding */
+static size_t	tOutputLength = 0;	/* Number of bytes written */
 
 /*
  * Two percent characters at the start of a line will cause trouble
@@ -33,109 +36,214 @@ static char	cCharPrev = '\0';
  */
 
 /*
- * vOutputByte - output one byte
+ * vFlushLine - write the collected characters and end the line
  */
 static void
-vOutputByte(ULONG ulChar, FILE *pOutFile)
+vFlushLine(FILE *pOutFile)
 {
-	if (iOutBytes == 1 && cCharPrev == '%' && ulChar == (ULONG)'%') {
-		if (putc('\n', pOutFile) != EOF) {
-			iOutBytes = 0;
+	acLine[iOutBytes++] = '\n';
+	tOutputLength += fwrite(acLine, 1, (size_t)iOutBytes, pOutFile);
+	iOutBytes = 0;
+} /* end of vFlushLine */
+
+/*
+ * vOutputChars - output the characters of one group
+ */
+static void
+vOutputChars(const char *acChars, int iCount, FILE *pOutFile)
+{
+	int	iIndex;
+
+	if (iOutBytes >= 2 && iOutBytes + iCount <= LINE_LENGTH) {
+		/* Not near the start of a line: no percent check needed */
+		for (iIndex = 0; iIndex < iCount; iIndex++) {
+			acLine[iOutBytes++] = acChars[iIndex];
+		}
+		if (iOutBytes >= LINE_LENGTH) {
+			vFlushLine(pOutFile);
+		}
+		return;
+	}
+
+	for (iIndex = 0; iIndex < iCount; iIndex++) {
+		if (iOutBytes == 1 &&
+		    acLine[0] == '%' && acChars[iIndex] == '%') {
+			vFlushLine(pOutFile);
+		}
+		acLine[iOutBytes++] = acChars[iIndex];
+		if (iOutBytes >= LINE_LENGTH) {
+			vFlushLine(pOutFile);
 		}
 	}
-	if (putc((int)ulChar, pOutFile) == EOF) {
+} /* end of vOutputChars */
+
+/*
+ * vEncodeGroup - ASCII 85 encode one group of (at most) four bytes
+ *
+ * A complete group becomes five characters, an incomplete group of
+ * iBytes bytes becomes iBytes + 1 characters
+ */
+static void
+vEncodeGroup(ULONG ulValue, int iBytes, FILE *pOutFile)
+{
+	char	acChars[5];
+	int	iIndex;
+
+	fail(iBytes < 1 || iBytes > 4);
+
+	if (iBytes == 4 && ulValue == 0) {
+		vOutputChars("z", 1, pOutFile); /* Shortcut for 0 */
+		return;
+	}
+	for (iIndex = 4; iIndex >= 0; iIndex--) {
+		acChars[iIndex] = (char)(ulValue % 85 + '!');
+		ulValue /= 85;
+	}
+	vOutputChars(acChars, iBytes + 1, pOutFile);
+} /* end of vEncodeGroup */
+
+/*
+ * vASCII85SetBinary - start a new block of encoded output
+ *
+ * When bBinaryOutput is TRUE, the bytes are copied without encoding and
+ * there is no End Of Data marker (for binary formats like PDF)
+ */
+void
+vASCII85SetBinary(BOOL bBinaryOutput)
+{
+	bBinary = bBinaryOutput;
+	tOutputLength = 0;
+} /* end of vASCII85SetBinary */
+
+/*
+ * tGetASCII85Length - get the number of bytes written in the current block
+ */
+size_t
+tGetASCII85Length(void)
+{
+	return tOutputLength;
+} /* end of tGetASCII85Length */
+
+/*
+ * vASCII85EncodeBuffer - ASCII 85 encode a number of bytes
+ */
+void
+vASCII85EncodeBuffer(FILE *pOutFile, const UCHAR *aucBytes, size_t tLength)
+{
+	ULONG	ulValue;
+
+	fail(pOutFile == NULL);
+	fail(aucBytes == NULL && tLength != 0);
+	fail(iInGroup < 0);
+	fail(iInGroup > 3);
+
+	if (bBinary) {
+		fail(iInGroup != 0);
+		tOutputLength += fwrite(aucBytes, 1, tLength, pOutFile);
 		return;
 	}
-	iOutBytes++;
-	if (iOutBytes > 63) {
-		if (putc('\n', pOutFile) != EOF) {
-			iOutBytes = 0;
+
+	/* Complete the group left by the previous call */
+	while (iInGroup > 0 && tLength > 0) {
+		aucGroup[iInGroup++] = *aucBytes++;
+		tLength--;
+		if (iInGroup >= 4) {
+			ulValue = ((ULONG)aucGroup[0] << 24) |
+				((ULONG)aucGroup[1] << 16) |
+				((ULONG)aucGroup[2] << 8) |
+				(ULONG)aucGroup[3];
+			vEncodeGroup(ulValue, 4, pOutFile);
+			iInGroup = 0;
 		}
 	}
-	cCharPrev = (char)ulChar;
-} /* end of vOutputByte */
+
+	/* Encode the complete groups */
+	while (tLength >= 4) {
+		ulValue = ((ULONG)aucBytes[0] << 24) |
+			((ULONG)aucBytes[1] << 16) |
+			((ULONG)aucBytes[2] << 8) |
+			(ULONG)aucBytes[3];
+		vEncodeGroup(ulValue, 4, pOutFile);
+		aucBytes += 4;
+		tLength -= 4;
+	}
+
+	/* Keep the rest for the next call */
+	while (tLength > 0) {
+		aucGroup[iInGroup++] = *aucBytes++;
+		tLength--;
+	}
+} /* end of vASCII85EncodeBuffer */
 
 /*
  * vASCII85EncodeByte - ASCII 85 encode a byte
+ *
+ * EOF marks the end of the data
  */
 void
 vASCII85EncodeByte(FILE *pOutFile, int iByte)
 {
-	static ULONG	ulBuffer[4] = { 0, 0, 0, 0 };
-	static int	iInBuffer = 0;
-	ULONG	ulValue, ulTmp;
+	UCHAR	ucByte;
+	ULONG	ulValue;
 	int	iIndex;
 
 	fail(pOutFile == NULL);
-	fail(iInBuffer < 0);
-	fail(iInBuffer > 3);
-
-	if (iByte == EOF) {
-		/* End Of File, time to clean up */
-		if (iInBuffer > 0 && iInBuffer < 4) {
-			/* Encode the remaining bytes */
-			ulValue = 0;
-			for (iIndex = iInBuffer - 1; iIndex >= 0; iIndex--) {
-				ulValue |=
-					ulBuffer[iIndex] << (8 * (3 - iIndex));
-			}
-			for (iIndex = 4; iIndex >= 4 - iInBuffer; iIndex--) {
-				ulTmp = ulValue / aulPower85[iIndex];
-				vOutputByte(ulTmp + '!', pOutFile);
-				ulValue -= ulTmp * aulPower85[iIndex];
-			}
-		}
-		/* Add the End Of Data marker */
-		(void)putc('~', pOutFile);
-		(void)putc('>', pOutFile);
-		(void)putc('\n', pOutFile);
-		/* Reset the control variables */
-		iInBuffer = 0;
-		iOutBytes = 0;
-		cCharPrev = '\0';
+	fail(iInGroup < 0);
+	fail(iInGroup > 3);
+
+	if (iByte != EOF) {
+		ucByte = (UCHAR)iByte;
+		vASCII85EncodeBuffer(pOutFile, &ucByte, 1);
 		return;
 	}
 
-	ulBuffer[iInBuffer] = (ULONG)iByte & 0xff;
-	iInBuffer++;
-
-	if (iInBuffer >= 4) {
-		ulValue = (ulBuffer[0] << 24) | (ulBuffer[1] << 16) |
-			(ulBuffer[2] << 8) | ulBuffer[3];
-		if (ulValue == 0) {
-			vOutputByte((ULONG)'z', pOutFile); /* Shortcut for 0 */
-		} else {
-			for (iIndex = 4; iIndex >= 0; iIndex--) {
-				ulTmp = ulValue / aulPower85[iIndex];
-				vOutputByte(ulTmp + '!', pOutFile);
-				ulValue -= ulTmp * aulPower85[iIndex];
-			}
+	if (bBinary) {
+		fail(iInGroup != 0);
+		return;
+	}
+
+	/* End Of File, time to clean up */
+	if (iInGroup > 0) {
+		/* Encode the remaining bytes */
+		ulValue = 0;
+		for (iIndex = 0; iIndex < iInGroup; iIndex++) {
+			ulValue |= (ULONG)aucGroup[iIndex] << (8 * (3 - iIndex));
 		}
-		/* Reset the buffer */
-		iInBuffer = 0;
+		vEncodeGroup(ulValue, iInGroup, pOutFile);
 	}
+	/* Add the End Of Data marker */
+	acLine[iOutBytes++] = '~';
+	acLine[iOutBytes++] = '>';
+	acLine[iOutBytes++] = '\n';
+	tOutputLength += fwrite(acLine, 1, (size_t)iOutBytes, pOutFile);
+	/* Reset the control variables */
+	iInGroup = 0;
+	iOutBytes = 0;
 } /* end of vASCII85EncodeByte */
 
 /*
  * vASCII85EncodeArray - ASCII 85 encode a byte array
+ *
+ * The bytes are taken straight from the data block list
  */
 void
 vASCII85EncodeArray(FILE *pInFile, FILE *pOutFile, size_t tLength)
 {
-	size_t	tCount;
-	int	iByte;
+	const UCHAR	*aucBytes;
+	size_t	tBytes;
 
 	fail(pInFile == NULL);
 	fail(pOutFile == NULL);
 
 	DBG_DEC(tLength);
 
-	for (tCount = 0; tCount < tLength; tCount++) {
-		iByte = iNextByte(pInFile);
-		if (iByte == EOF) {
+	while (tLength > 0) {
+		aucBytes = aucNextBytes(pInFile, tLength, &tBytes);
+		if (aucBytes == NULL) {
 			break;
 		}
-		vASCII85EncodeByte(pOutFile, iByte);
+		vASCII85EncodeBuffer(pOutFile, aucBytes, tBytes);
+		tLength -= tBytes;
 	}
 } /* end of vASCII85EncodeArray */
 
@@ -132,6 +132,7 @@ bAdd2TextBlockList(const text_block_type *pTextBlock)
 		return TRUE;
 	}
 	/* Make a new block */
+	vCountListItem(stats_list_text_blocks);
 	pListMember = xmalloc(sizeof(list_mem_type));
 	/* Add the block to the list */
 	pListMember->tInfo = *pTextBlock;
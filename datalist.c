@@ -7,6 +7,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 #include "antiword.h"
 
@@ -205,6 +206,69 @@ iNextByte(FILE *pFile)
 	return (int)aucBlock[tByteNext++];
 } /* end of iNextByte */
 
+/*
+ * aucNextBytes - get the next bytes from the data block list
+ *
+ * Returns a pointer to at most tMaxBytes bytes from the current block and
+ * sets *ptLength to their number; returns NULL at the end of the list
+ */
+const UCHAR *
+aucNextBytes(FILE *pFile, size_t tMaxBytes, size_t *ptLength)
+{
+	const UCHAR	*aucBytes;
+	size_t	tAvailable;
+
+	fail(ptLength == NULL);
+
+	*ptLength = 0;
+	if (tMaxBytes == 0) {
+		return NULL;
+	}
+	/* Let iNextByte do the block handling */
+	if (iNextByte(pFile) == EOF) {
+		return NULL;
+	}
+	tByteNext--;
+	/* The number of valid bytes left in the last block read */
+	tAvailable = (size_t)(pBlockCurrent->tInfo.ulLength - ulBlockOffset);
+	if (tAvailable > sizeof(aucBlock)) {
+		tAvailable = sizeof(aucBlock);
+	}
+	tAvailable -= tByteNext;
+	if (tAvailable > tMaxBytes) {
+		tAvailable = tMaxBytes;
+	}
+	aucBytes = aucBlock + tByteNext;
+	tByteNext += tAvailable;
+	*ptLength = tAvailable;
+	return aucBytes;
+} /* end of aucNextBytes */
+
+/*
+ * tNextBytes - get a number of bytes from the data block list
+ *
+ * Returns the number of bytes copied, less than tLength at the end of the data
+ */
+size_t
+tNextBytes(FILE *pFile, UCHAR *aucBuffer, size_t tLength)
+{
+	const UCHAR	*aucBytes;
+	size_t	tRead, tBytes;
+
+	fail(aucBuffer == NULL && tLength != 0);
+
+	tRead = 0;
+	while (tRead < tLength) {
+		aucBytes = aucNextBytes(pFile, tLength - tRead, &tBytes);
+		if (aucBytes == NULL) {
+			break;
+		}
+		memcpy(aucBuffer + tRead, aucBytes, tBytes);
+		tRead += tBytes;
+	}
+	return tRead;
+} /* end of tNextBytes */
+
 /*
  * usNextWord - get the next word from the data block list
  *
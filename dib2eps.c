@@ -14,6 +14,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include "antiword.h"
 
 
@@ -23,8 +24,9 @@
 static void
 vDecode1bpp(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 {
-	size_t	tPadding;
-	int	iX, iY, iN, iByte, iTmp, iEighthWidth, iUse;
+	UCHAR	*aucRow, *aucPixels;
+	size_t	tPadding, tRead, tPixels, tIndex;
+	int	iY, iEighthWidth;
 
 	DBG_MSG("vDecode1bpp");
 
@@ -38,36 +40,30 @@ vDecode1bpp(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 	iEighthWidth = (pImg->iWidth + 7) / 8;
 	tPadding = (size_t)(ROUND4(iEighthWidth) - iEighthWidth);
 
+	aucRow = xmalloc((size_t)iEighthWidth);
+	aucPixels = xmalloc((size_t)iEighthWidth * 8);
+
 	for (iY = 0; iY < pImg->iHeight; iY++) {
-		for (iX = 0; iX < iEighthWidth; iX++) {
-			iByte = iNextByte(pInFile);
-			if (iByte == EOF) {
-				vASCII85EncodeByte(pOutFile, EOF);
-				return;
-			}
-			if (iX == iEighthWidth - 1 && pImg->iWidth % 8 != 0) {
-				iUse = pImg->iWidth % 8;
-			} else {
-				iUse = 8;
-			}
-			for (iN = 0; iN < iUse; iN++) {
-				switch (iN) {
-				case 0: iTmp = (iByte & 0x80) / 128; break;
-				case 1: iTmp = (iByte & 0x40) / 64; break;
-				case 2: iTmp = (iByte & 0x20) / 32; break;
-				case 3: iTmp = (iByte & 0x10) / 16; break;
-				case 4: iTmp = (iByte & 0x08) / 8; break;
-				case 5: iTmp = (iByte & 0x04) / 4; break;
-				case 6: iTmp = (iByte & 0x02) / 2; break;
-				case 7: iTmp = (iByte & 0x01); break;
-				default: iTmp = 0; break;
-				}
-				vASCII85EncodeByte(pOutFile, iTmp);
-			}
+		tRead = tNextBytes(pInFile, aucRow, (size_t)iEighthWidth);
+		/* Expand the bits into one byte per pixel */
+		for (tIndex = 0; tIndex < tRead * 8; tIndex++) {
+			aucPixels[tIndex] = (UCHAR)
+				((aucRow[tIndex / 8] >> (7 - tIndex % 8)) & 0x01);
+		}
+		tPixels = tRead * 8;
+		if (tPixels > (size_t)pImg->iWidth) {
+			tPixels = (size_t)pImg->iWidth;
+		}
+		vASCII85EncodeBuffer(pOutFile, aucPixels, tPixels);
+		if (tRead < (size_t)iEighthWidth) {
+			break;
 		}
 		(void)tSkipBytes(pInFile, tPadding);
 	}
 	vASCII85EncodeByte(pOutFile, EOF);
+
+	aucPixels = xfree(aucPixels);
+	aucRow = xfree(aucRow);
 } /* end of vDecode1bpp */
 
 /*
@@ -76,8 +72,9 @@ vDecode1bpp(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 static void
 vDecode4bpp(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 {
-	size_t	tPadding;
-	int	iX, iY, iN, iByte, iTmp, iHalfWidth, iUse;
+	UCHAR	*aucRow, *aucPixels;
+	size_t	tPadding, tRead, tPixels, tIndex;
+	int	iY, iHalfWidth;
 
 	DBG_MSG("vDecode4bpp");
 
@@ -92,30 +89,30 @@ vDecode4bpp(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 	iHalfWidth = (pImg->iWidth + 1) / 2;
 	tPadding = (size_t)(ROUND4(iHalfWidth) - iHalfWidth);
 
+	aucRow = xmalloc((size_t)iHalfWidth);
+	aucPixels = xmalloc((size_t)iHalfWidth * 2);
+
 	for (iY = 0; iY < pImg->iHeight; iY++) {
-		for (iX = 0; iX < iHalfWidth; iX++) {
-			iByte = iNextByte(pInFile);
-			if (iByte == EOF) {
-				vASCII85EncodeByte(pOutFile, EOF);
-				return;
-			}
-			if (iX == iHalfWidth - 1 && odd(pImg->iWidth)) {
-				iUse = 1;
-			} else {
-				iUse = 2;
-			}
-			for (iN = 0; iN < iUse; iN++) {
-				if (odd(iN)) {
-					iTmp = iByte & 0x0f;
-				} else {
-					iTmp = (iByte & 0xf0) / 16;
-				}
-				vASCII85EncodeByte(pOutFile, iTmp);
-			}
+		tRead = tNextBytes(pInFile, aucRow, (size_t)iHalfWidth);
+		/* Expand the nibbles into one byte per pixel */
+		for (tIndex = 0; tIndex < tRead; tIndex++) {
+			aucPixels[tIndex * 2] = aucRow[tIndex] >> 4;
+			aucPixels[tIndex * 2 + 1] = aucRow[tIndex] & 0x0f;
+		}
+		tPixels = tRead * 2;
+		if (tPixels > (size_t)pImg->iWidth) {
+			tPixels = (size_t)pImg->iWidth;
+		}
+		vASCII85EncodeBuffer(pOutFile, aucPixels, tPixels);
+		if (tRead < (size_t)iHalfWidth) {
+			break;
 		}
 		(void)tSkipBytes(pInFile, tPadding);
 	}
 	vASCII85EncodeByte(pOutFile, EOF);
+
+	aucPixels = xfree(aucPixels);
+	aucRow = xfree(aucRow);
 } /* end of vDecode4bpp */
 
 /*
@@ -124,8 +121,9 @@ vDecode4bpp(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 static void
 vDecode8bpp(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 {
-	size_t	tPadding;
-	int	iX, iY, iByte;
+	UCHAR	*aucRow;
+	size_t	tPadding, tRead;
+	int	iY;
 
 	DBG_MSG("vDecode8bpp");
 
@@ -139,18 +137,19 @@ vDecode8bpp(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 
 	tPadding = (size_t)(ROUND4(pImg->iWidth) - pImg->iWidth);
 
+	aucRow = xmalloc((size_t)pImg->iWidth);
+
 	for (iY = 0; iY < pImg->iHeight; iY++) {
-		for (iX = 0; iX < pImg->iWidth; iX++) {
-			iByte = iNextByte(pInFile);
-			if (iByte == EOF) {
-				vASCII85EncodeByte(pOutFile, EOF);
-				return;
-			}
-			vASCII85EncodeByte(pOutFile, iByte);
+		tRead = tNextBytes(pInFile, aucRow, (size_t)pImg->iWidth);
+		vASCII85EncodeBuffer(pOutFile, aucRow, tRead);
+		if (tRead < (size_t)pImg->iWidth) {
+			break;
 		}
 		(void)tSkipBytes(pInFile, tPadding);
 	}
 	vASCII85EncodeByte(pOutFile, EOF);
+
+	aucRow = xfree(aucRow);
 } /* end of vDecode8bpp */
 
 /*
@@ -159,8 +158,10 @@ vDecode8bpp(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 static void
 vDecode24bpp(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 {
-	size_t	tPadding;
-	int	iX, iY, iBlue, iGreen, iRed, iTripleWidth;
+	UCHAR	*aucRow;
+	size_t	tPadding, tRead, tIndex;
+	int	iY, iTripleWidth;
+	UCHAR	ucBlue;
 
 	DBG_MSG("vDecode24bpp");
 
@@ -175,31 +176,27 @@ vDecode24bpp(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 	iTripleWidth = pImg->iWidth * 3;
 	tPadding = (size_t)(ROUND4(iTripleWidth) - iTripleWidth);
 
+	aucRow = xmalloc((size_t)iTripleWidth);
+
 	for (iY = 0; iY < pImg->iHeight; iY++) {
-		for (iX = 0; iX < pImg->iWidth; iX++) {
-			/* Change from BGR order to RGB order */
-			iBlue = iNextByte(pInFile);
-			if (iBlue == EOF) {
-				vASCII85EncodeByte(pOutFile, EOF);
-				return;
-			}
-			iGreen = iNextByte(pInFile);
-			if (iGreen == EOF) {
-				vASCII85EncodeByte(pOutFile, EOF);
-				return;
-			}
-			iRed = iNextByte(pInFile);
-			if (iRed == EOF) {
-				vASCII85EncodeByte(pOutFile, EOF);
-				return;
-			}
-			vASCII85EncodeByte(pOutFile, iRed);
-			vASCII85EncodeByte(pOutFile, iGreen);
-			vASCII85EncodeByte(pOutFile, iBlue);
+		tRead = tNextBytes(pInFile, aucRow, (size_t)iTripleWidth);
+		/* Only complete pixels */
+		tRead -= tRead % 3;
+		/* Change from BGR order to RGB order */
+		for (tIndex = 0; tIndex < tRead; tIndex += 3) {
+			ucBlue = aucRow[tIndex];
+			aucRow[tIndex] = aucRow[tIndex + 2];
+			aucRow[tIndex + 2] = ucBlue;
+		}
+		vASCII85EncodeBuffer(pOutFile, aucRow, tRead);
+		if (tRead < (size_t)iTripleWidth) {
+			break;
 		}
 		(void)tSkipBytes(pInFile, tPadding);
 	}
 	vASCII85EncodeByte(pOutFile, EOF);
+
+	aucRow = xfree(aucRow);
 } /* end of vDecode24bpp */
 
 /*
@@ -208,6 +205,7 @@ vDecode24bpp(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 static void
 vDecodeRle4(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 {
+	UCHAR	*aucPixels;
 	int	iX, iY, iByte, iTmp, iRunLength, iRun;
 	BOOL	bEOF, bEOL;
 
@@ -221,6 +219,9 @@ vDecodeRle4(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 	DBG_DEC(pImg->iWidth);
 	DBG_DEC(pImg->iHeight);
 
+	/* The pixels of one row */
+	aucPixels = xmalloc((size_t)pImg->iWidth);
+
 	bEOF = FALSE;
 
 	for (iY =  0; iY < pImg->iHeight && !bEOF; iY++) {
@@ -229,8 +230,8 @@ vDecodeRle4(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 		while (!bEOL) {
 			iRunLength = iNextByte(pInFile);
 			if (iRunLength == EOF) {
-				vASCII85EncodeByte(pOutFile, EOF);
-				return;
+				bEOF = TRUE;
+				break;
 			}
 			if (iRunLength != 0) {
 				/*
@@ -239,8 +240,8 @@ vDecodeRle4(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 				 */
 				iByte = iNextByte(pInFile);
 				if (iByte == EOF) {
-					vASCII85EncodeByte(pOutFile, EOF);
-					return;
+					bEOF = TRUE;
+					break;
 				}
 				for (iRun = 0; iRun < iRunLength; iRun++) {
 					if (odd(iRun)) {
@@ -249,7 +250,7 @@ vDecodeRle4(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 						iTmp = (iByte & 0xf0) / 16;
 					}
 					if (iX < pImg->iWidth) {
-						vASCII85EncodeByte(pOutFile, iTmp);
+						aucPixels[iX] = (UCHAR)iTmp;
 					}
 					iX++;
 				}
@@ -258,8 +259,8 @@ vDecodeRle4(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 			/* Literal or escape */
 			iRunLength = iNextByte(pInFile);
 			if (iRunLength == EOF) {
-				vASCII85EncodeByte(pOutFile, EOF);
-				return;
+				bEOF = TRUE;
+				break;
 			}
 			if (iRunLength == 0) {		/* End of line escape */
 				bEOL = TRUE;
@@ -278,16 +279,19 @@ vDecodeRle4(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 					} else {
 						iByte = iNextByte(pInFile);
 						if (iByte == EOF) {
-							vASCII85EncodeByte(pOutFile, EOF);
-							return;
+							bEOF = TRUE;
+							break;
 						}
 						iTmp = (iByte & 0xf0) / 16;
 					}
 					if (iX < pImg->iWidth) {
-						vASCII85EncodeByte(pOutFile, iTmp);
+						aucPixels[iX] = (UCHAR)iTmp;
 					}
 					iX++;
 				}
+				if (bEOF) {
+					break;
+				}
 				/* Padding if the number of bytes is odd */
 				if (odd((iRunLength + 1) / 2)) {
 					(void)tSkipBytes(pInFile, 1);
@@ -295,8 +299,12 @@ vDecodeRle4(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 			}
 		}
 		DBG_DEC_C(iX != pImg->iWidth, iX);
+		vASCII85EncodeBuffer(pOutFile, aucPixels,
+				(size_t)min(iX, pImg->iWidth));
 	}
 	vASCII85EncodeByte(pOutFile, EOF);
+
+	aucPixels = xfree(aucPixels);
 } /* end of vDecodeRle4 */
 
 /*
@@ -305,7 +313,9 @@ vDecodeRle4(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 static void
 vDecodeRle8(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 {
-	int	iX, iY, iByte, iRunLength, iRun;
+	UCHAR	*aucPixels;
+	size_t	tWanted, tRead;
+	int	iX, iY, iByte, iRunLength;
 	BOOL	bEOF, bEOL;
 
 	DBG_MSG("vDecodeRle8");
@@ -318,6 +328,9 @@ vDecodeRle8(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 	DBG_DEC(pImg->iWidth);
 	DBG_DEC(pImg->iHeight);
 
+	/* The pixels of one row */
+	aucPixels = xmalloc((size_t)pImg->iWidth);
+
 	bEOF = FALSE;
 
 	for (iY = 0; iY < pImg->iHeight && !bEOF; iY++) {
@@ -326,8 +339,8 @@ vDecodeRle8(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 		while (!bEOL) {
 			iRunLength = iNextByte(pInFile);
 			if (iRunLength == EOF) {
-				vASCII85EncodeByte(pOutFile, EOF);
-				return;
+				bEOF = TRUE;
+				break;
 			}
 			if (iRunLength != 0) {
 				/*
@@ -336,22 +349,21 @@ vDecodeRle8(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 				 */
 				iByte = iNextByte(pInFile);
 				if (iByte == EOF) {
-					vASCII85EncodeByte(pOutFile, EOF);
-					return;
+					bEOF = TRUE;
+					break;
 				}
-				for (iRun = 0; iRun < iRunLength; iRun++) {
-					if (iX < pImg->iWidth) {
-						vASCII85EncodeByte(pOutFile, iByte);
-					}
-					iX++;
+				if (iX < pImg->iWidth) {
+					memset(aucPixels + iX, iByte,
+					(size_t)min(iRunLength, pImg->iWidth - iX));
 				}
+				iX += iRunLength;
 				continue;
 			}
 			/* Literal or escape */
 			iRunLength = iNextByte(pInFile);
 			if (iRunLength == EOF) {
-				vASCII85EncodeByte(pOutFile, EOF);
-				return;
+				bEOF = TRUE;
+				break;
 			}
 			if (iRunLength == 0) {		/* End of line escape */
 				bEOL = TRUE;
@@ -363,17 +375,23 @@ vDecodeRle8(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 				bEOF = TRUE;
 				bEOL = TRUE;
 			} else {			/* Literal packet */
-				for (iRun = 0; iRun < iRunLength; iRun++) {
-					iByte = iNextByte(pInFile);
-					if (iByte == EOF) {
-						vASCII85EncodeByte(pOutFile, EOF);
-						return;
-					}
-					if (iX < pImg->iWidth) {
-						vASCII85EncodeByte(pOutFile, iByte);
-					}
-					iX++;
+				/* Read the visible part, skip the rest */
+				tWanted = 0;
+				if (iX < pImg->iWidth) {
+					tWanted = (size_t)
+					min(iRunLength, pImg->iWidth - iX);
+				}
+				tRead = tNextBytes(pInFile,
+						aucPixels + iX, tWanted);
+				if (tRead < tWanted ||
+				    tSkipBytes(pInFile,
+				    (size_t)iRunLength - tWanted) !=
+				    (size_t)iRunLength - tWanted) {
+					iX += (int)tRead;
+					bEOF = TRUE;
+					break;
 				}
+				iX += iRunLength;
 				/* Padding if the number of bytes is odd */
 				if (odd(iRunLength)) {
 					(void)tSkipBytes(pInFile, 1);
@@ -381,8 +399,12 @@ vDecodeRle8(FILE *pInFile, FILE *pOutFile, const imagedata_type *pImg)
 			}
 		}
 		DBG_DEC_C(iX != pImg->iWidth, iX);
+		vASCII85EncodeBuffer(pOutFile, aucPixels,
+				(size_t)min(iX, pImg->iWidth));
 	}
 	vASCII85EncodeByte(pOutFile, EOF);
+
+	aucPixels = xfree(aucPixels);
 } /* end of vDecodeRle8 */
 
 /*
@@ -501,7 +523,7 @@ bTranslateDIB(diagram_type *pDiag, FILE *pInFile,
 		return FALSE;
 	}
 
-	vImagePrologue(pDiag, pImg);
+	vImagePrologue(pDiag, ulFileOffset, pImg);
 	vDecodeDIB(pInFile, pDiag->pOutFile, pImg);
 	vImageEpilogue(pDiag);
 
@@ -273,7 +273,7 @@ vExtendDiagramSize(diagram_type *pDiag, size_t tSize)
  * vPrologue2 - prologue part 2; add a font list to a diagram
  */
 void
-vPrologue2(diagram_type *pDiag, int iWordVersion)
+vPrologue2(diagram_type *pDiag, FILE *pFile, int iWordVersion)
 {
 	drawfile_object	*pNew;
 	const font_table_type	*pTmp;
@@ -551,6 +551,20 @@ bAddDummyImage(diagram_type *pDiag, const imagedata_type *pImg)
 	return TRUE;
 } /* end of bAddDummyImage */
 
+/*
+ * bAddRepeatedImage - add an image that has been translated before
+ *
+ * The images are not remembered, so every image is translated again
+ *
+ * return TRUE when successful, otherwise FALSE
+ */
+BOOL
+bAddRepeatedImage(diagram_type *pDiag, ULONG ulFileOffset,
+	const imagedata_type *pImg)
+{
+	return FALSE;
+} /* end of bAddRepeatedImage */
+
 /*
  * vMove2NextLine - move to the next line
  */
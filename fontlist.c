@@ -23,6 +23,8 @@ typedef struct font_desc_tag {
 /* Variables needed to write the Font Information List */
 static font_mem_type	*pAnchor = NULL;
 static font_mem_type	*pFontLast = NULL;
+/* Decode the fonts on demand and free the ones that have been used */
+static BOOL		bStreaming = FALSE;
 
 
 /*
@@ -45,8 +47,21 @@ vDestroyFontInfoList(void)
 	pAnchor = NULL;
 	/* Reset all control variables */
 	pFontLast = NULL;
+	bStreaming = FALSE;
 } /* end of vDestroyFontInfoList */
 
+/*
+ * vSetFontInfoStreaming - decode the font information on demand
+ *
+ * When streaming, the list asks for the next page of character information
+ * when it runs dry and it frees the records that have been passed
+ */
+void
+vSetFontInfoStreaming(BOOL bStream)
+{
+	bStreaming = bStream;
+} /* end of vSetFontInfoStreaming */
+
 /*
  * vCorrectFontValues - correct font values to values Antiword can use
  */
@@ -128,6 +143,7 @@ vAdd2FontInfoList(const font_block_type *pFontBlock)
 	}
 
 	/* Create list member */
+	vCountListItem(stats_list_fonts);
 	pListMember = xmalloc(sizeof(font_mem_type));
 	/* Fill the list member */
 	pListMember->tInfo = *pFontBlock;
@@ -150,10 +166,14 @@ vAdd2FontInfoList(const font_block_type *pFontBlock)
 const font_block_type *
 pGetNextFontInfoListItem(const font_block_type *pCurr)
 {
-	const font_mem_type	*pRecord;
+	font_mem_type	*pRecord, *pNext;
 	size_t	tOffset;
 
 	if (pCurr == NULL) {
+		while (pAnchor == NULL && bStreaming && bGet8NextChrPage()) {
+			/* Decode until there is a record */
+			continue;
+		}
 		if (pAnchor == NULL) {
 			/* There are no records */
 			return NULL;
@@ -165,6 +185,19 @@ pGetNextFontInfoListItem(const font_block_type *pCurr)
 	/* Many casts to prevent alignment warnings */
 	pRecord = (font_mem_type *)(void *)((char *)pCurr - tOffset);
 	fail(pCurr != &pRecord->tInfo);
+	if (bStreaming) {
+		while (pRecord->pNext == NULL && bGet8NextChrPage()) {
+			/* Decode until there is a successor */
+			continue;
+		}
+		/* Nobody looks back past the given record */
+		while (pAnchor != pRecord) {
+			fail(pAnchor == NULL);
+			pNext = pAnchor->pNext;
+			pAnchor = xfree(pAnchor);
+			pAnchor = pNext;
+		}
+	}
 	if (pRecord->pNext == NULL) {
 		/* The last record has no successor */
 		return NULL;
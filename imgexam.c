@@ -542,6 +542,10 @@ bExaminePNG(FILE *pFile, imagedata_type *pImg)
 			}
 			(void)tSkipBytes(pFile, 4);
 			break;
+		case PNG_CN_IDAT:
+			pImg->tDataLength += tLength;
+			(void)tSkipBytes(pFile, tLength + 4);
+			break;
 		default:
 			(void)tSkipBytes(pFile, tLength + 4);
 			break;
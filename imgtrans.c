@@ -3,10 +3,11 @@
  * Copyright (C) 2000-2002 A.J. van Os; Released under GPL
  *
  * Description:
- * Generic functions to translate Word images
+ * Generic functions to translate and extract Word images
  */
 
 #include <stdio.h>
+#include <string.h>
 #include "antiword.h"
 
 
@@ -39,6 +40,12 @@ bTranslateImage(diagram_type *pDiag, FILE *pFile, BOOL bMinimalInformation,
 		return bAddDummyImage(pDiag, pImg);
 	}
 
+	if (bAddRepeatedImage(pDiag,
+			ulFileOffsetImage + pImg->tPosition, pImg)) {
+		/* Translated before, no need to do it again */
+		return TRUE;
+	}
+
 	switch (pImg->eImageType) {
 	case imagetype_is_dib:
 		return bTranslateDIB(pDiag, pFile,
@@ -69,3 +76,195 @@ bTranslateImage(diagram_type *pDiag, FILE *pFile, BOOL bMinimalInformation,
 		return bAddDummyImage(pDiag, pImg);
 	}
 } /* end of bTranslateImage */
+
+/*
+ * szGetImageExtension - get the file extension for an extracted image
+ *
+ * Returns NULL when images of this type are not extracted
+ */
+static const char *
+szGetImageExtension(imagetype_enum eImageType)
+{
+	switch (eImageType) {
+	case imagetype_is_dib:
+		return "bmp";
+	case imagetype_is_jpeg:
+		return "jpg";
+	case imagetype_is_png:
+		return "png";
+	default:
+		return NULL;
+	}
+} /* end of szGetImageExtension */
+
+/*
+ * bWriteBMPHeader - write the file header that turns a DIB into a BMP
+ *
+ * return TRUE when sucessful, otherwise FALSE
+ */
+static BOOL
+bWriteBMPHeader(FILE *pInFile, FILE *pOutFile,
+	ULONG ulFileOffset, size_t tLength, const imagedata_type *pImg)
+{
+	ULONG	ulHeaderSize, ulFileSize, ulBitsOffset;
+	int	iIndex;
+	UCHAR	aucHeader[14];
+
+	/* The bitmap info header starts with its own size */
+	if (!bSetDataOffset(pInFile, ulFileOffset)) {
+		return FALSE;
+	}
+	ulHeaderSize = ulNextLong(pInFile);
+	ulFileSize = (ULONG)sizeof(aucHeader) + (ULONG)tLength;
+	ulBitsOffset = (ULONG)sizeof(aucHeader) + ulHeaderSize;
+	if (pImg->uiBitsPerComponent <= 8) {
+		/* Add the colortable */
+		ulBitsOffset += (ULONG)pImg->iColorsUsed *
+				(ulHeaderSize > 12 ? 4 : 3);
+	}
+
+	aucHeader[0] = (UCHAR)'B';
+	aucHeader[1] = (UCHAR)'M';
+	for (iIndex = 0; iIndex < 4; iIndex++) {
+		aucHeader[2 + iIndex] = (UCHAR)(ulFileSize >> (8 * iIndex));
+		aucHeader[6 + iIndex] = 0;
+		aucHeader[10 + iIndex] = (UCHAR)(ulBitsOffset >> (8 * iIndex));
+	}
+	return fwrite(aucHeader, 1, sizeof(aucHeader), pOutFile) ==
+							sizeof(aucHeader);
+} /* end of bWriteBMPHeader */
+
+/*
+ * bCopyImageData - copy the image data to the given file
+ *
+ * return TRUE when sucessful, otherwise FALSE
+ */
+static BOOL
+bCopyImageData(FILE *pInFile, FILE *pOutFile,
+	ULONG ulFileOffset, size_t tLength)
+{
+	const UCHAR	*aucBytes;
+	size_t	tBytes;
+
+	if (!bSetDataOffset(pInFile, ulFileOffset)) {
+		return FALSE;
+	}
+	while (tLength != 0) {
+		/* Copy straight from the data block buffer */
+		aucBytes = aucNextBytes(pInFile, tLength, &tBytes);
+		if (aucBytes == NULL) {
+			return FALSE;
+		}
+		if (fwrite(aucBytes, 1, tBytes, pOutFile) != tBytes) {
+			return FALSE;
+		}
+		tLength -= tBytes;
+	}
+	return TRUE;
+} /* end of bCopyImageData */
+
+/*
+ * bExtractImages - write the images of a Word document to separate files
+ *
+ * JPEG and PNG images are written as they are, DIB images are written as
+ * BMP files. The files are named <szName>-<number>.<extension> and are
+ * written in the directory szDirectory. There is no text conversion.
+ *
+ * return TRUE when sucessful, otherwise FALSE
+ */
+BOOL
+bExtractImages(FILE *pFile, long lFilesize,
+	const char *szDirectory, const char *szName)
+{
+	const picture_block_type	*pPicture;
+	const char	*szExtension;
+	char	*szFilename;
+	ULONG	*aulDone;
+	FILE	*pOutFile;
+	imagedata_type	tImage;
+	ULONG	ulFileOffsetImage, ulFileOffset;
+	size_t	tDone, tMaxDone, tIndex, tLength;
+	int	iImageCount;
+	BOOL	bSuccess;
+
+	fail(pFile == NULL || lFilesize <= 0);
+	fail(szDirectory == NULL || szName == NULL);
+
+	DBG_MSG("bExtractImages");
+
+	vStartPhase(stats_phase_init_document);
+	if (iInitDocument(pFile, lFilesize) < 0) {
+		vStopPhase(stats_phase_init_document);
+		return FALSE;
+	}
+	vStopPhase(stats_phase_init_document);
+
+	vStartPhase(stats_phase_images);
+	szFilename = xmalloc(strlen(szDirectory) + strlen(szName) + 20);
+	aulDone = NULL;
+	tDone = 0;
+	tMaxDone = 0;
+	iImageCount = 0;
+	bSuccess = TRUE;
+
+	for (pPicture = pGetNextPictInfoListItem(NULL);
+	     pPicture != NULL;
+	     pPicture = pGetNextPictInfoListItem(pPicture)) {
+		ulFileOffsetImage = pPicture->ulFileOffsetPicture;
+		/* Every image is written only once */
+		for (tIndex = 0; tIndex < tDone; tIndex++) {
+			if (aulDone[tIndex] == ulFileOffsetImage) {
+				break;
+			}
+		}
+		if (tIndex < tDone) {
+			continue;
+		}
+		if (tDone >= tMaxDone) {
+			tMaxDone = tMaxDone == 0 ? 16 : tMaxDone * 2;
+			aulDone = xrealloc(aulDone, tMaxDone * sizeof(ULONG));
+		}
+		aulDone[tDone++] = ulFileOffsetImage;
+
+		if (eExamineImage(pFile, ulFileOffsetImage, &tImage) !=
+		    image_full_information) {
+			continue;
+		}
+		szExtension = szGetImageExtension(tImage.eImageType);
+		if (szExtension == NULL) {
+			DBG_DEC(tImage.eImageType);
+			continue;
+		}
+		fail(tImage.tPosition > tImage.tLength);
+		ulFileOffset = ulFileOffsetImage + tImage.tPosition;
+		tLength = tImage.tLength - tImage.tPosition;
+
+		iImageCount++;
+		sprintf(szFilename, "%s%s%s-%03d.%s",
+			szDirectory, FILE_SEPARATOR, szName,
+			iImageCount, szExtension);
+		pOutFile = fopen(szFilename, "wb");
+		if (pOutFile == NULL) {
+			werr(0, "I can't open '%s' for writing", szFilename);
+			bSuccess = FALSE;
+			continue;
+		}
+		if ((tImage.eImageType == imagetype_is_dib &&
+		     !bWriteBMPHeader(pFile, pOutFile,
+					ulFileOffset, tLength, &tImage)) ||
+		    !bCopyImageData(pFile, pOutFile, ulFileOffset, tLength)) {
+			werr(0, "I can't write the image '%s'", szFilename);
+			bSuccess = FALSE;
+		}
+		if (fclose(pOutFile) != 0) {
+			werr(0, "I can't close '%s'", szFilename);
+			bSuccess = FALSE;
+		}
+	}
+
+	aulDone = xfree(aulDone);
+	szFilename = xfree(szFilename);
+	vStopPhase(stats_phase_images);
+	vFreeDocument();
+	return bSuccess;
+} /* end of bExtractImages */
@@ -66,7 +66,7 @@ bTranslateJPEG(diagram_type *pDiag, FILE *pFile,
 		return FALSE;
 	}
 
-	vImagePrologue(pDiag, pImg);
+	vImagePrologue(pDiag, ulFileOffset, pImg);
 	vASCII85EncodeFile(pFile, pDiag->pOutFile, tPictureLen);
 	vImageEpilogue(pDiag);
 
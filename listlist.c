@@ -9,8 +9,12 @@
  * This list only exists when the Word document is saved by Word 8 or later
  */
 
+#include <stdlib.h>
 #include "antiword.h"
 
+/* The number of levels of a list */
+#define LIST_LEVELS	9
+
 /*
  * Private structure to hide the way the information
  * is stored from the rest of the program
@@ -23,11 +27,15 @@ typedef struct list_desc_tag {
 	struct list_desc_tag	*pNext;
 } list_desc_type;
 
+typedef struct istd_entry_tag {
+	const list_block_type	*pInfo;
+	size_t			tSeqNumber;	/* Position in the list */
+	USHORT			usIstd;
+} istd_entry_type;
+
 typedef struct list_value_tag {
-	USHORT			usValue;
-	USHORT			usListIndex;
-	UCHAR			ucListLevel;
-	struct list_value_tag	*pNext;
+	USHORT	ausValue[LIST_LEVELS];
+	USHORT	usInUse;	/* One bit per level with a value */
 } list_value_type;
 
 /* Variables needed to describe the LFO list (pllfo) */
@@ -36,13 +44,30 @@ static USHORT		usLfoLen = 0;
 /* Variables needed to write the List Information List */
 static list_desc_type	*pAnchor = NULL;
 static list_desc_type	*pBlockLast = NULL;
-/* Variable needed for numbering new lists */
-static list_value_type	*pValues = NULL;
+/* Variables needed to find the list information without a search */
+static const list_block_type	**apLevelTable = NULL;
+static istd_entry_type	*atIstdTable = NULL;
+static size_t		tIstdTableLen = 0;
+/* Variable needed for numbering new lists, one record per LFO */
+static list_value_type	*atValues = NULL;
 /* Variables needed for numbering old lists */
 static int	iOldListSeqNumber = 0;
 static USHORT	usOldListValue = 0;
 
 
+/*
+ * vDestroyListTables - destroy the lookup tables
+ *
+ * They are built again when they are needed
+ */
+static void
+vDestroyListTables(void)
+{
+	apLevelTable = xfree(apLevelTable);
+	atIstdTable = xfree(atIstdTable);
+	tIstdTableLen = 0;
+} /* end of vDestroyListTables */
+
 /*
  * vDestroyListInfoList - destroy the List Information List
  */
@@ -50,10 +75,11 @@ void
 vDestroyListInfoList(void)
 {
 	list_desc_type	*pCurr, *pNext;
-	list_value_type	*pValueCurr, *pValueNext;
 
 	DBG_MSG("vDestroyListInfoList");
 
+	vDestroyListTables();
+
 	/* Free the LFO list */
 	usLfoLen = 0;
 	aulLfoList = xfree(aulLfoList);
@@ -69,14 +95,8 @@ vDestroyListInfoList(void)
 	/* Reset all control variables */
 	pBlockLast = NULL;
 
-	/* Free the values list */
-	pValueCurr = pValues;
-	while (pValueCurr != NULL) {
-		pValueNext = pValueCurr->pNext;
-		pValueCurr = xfree(pValueCurr);
-		pValueCurr = pValueNext;
-	}
-	pValues = NULL;
+	/* Free the values */
+	atValues = xfree(atValues);
 	/* Reset the values for the old lists */
 	iOldListSeqNumber = 0;
 	usOldListValue = 0;
@@ -105,6 +125,9 @@ vBuildLfoList(const UCHAR *aucBuffer, size_t tBufLen)
 		DBG_DEC(tBufLen);
 		return;
 	}
+	vDestroyListTables();
+	atValues = xfree(atValues);
+	aulLfoList = xfree(aulLfoList);
 	aulLfoList = xcalloc(tRecords, sizeof(ULONG));
 	for (iIndex = 0; iIndex < (int)tRecords; iIndex++) {
 		aulLfoList[iIndex] = ulGetLong(4 + 16 * iIndex, aucBuffer);
@@ -133,6 +156,9 @@ vAdd2ListInfoList(ULONG ulListID, USHORT usIstd, UCHAR ucListLevel,
 	NO_DBG_HEX(pListBlock->ucNFC);
 	NO_DBG_HEX(pListBlock->usListChar);
 
+	/* The lookup tables are out of date now */
+	vDestroyListTables();
+
 	/* Create list member */
 	pListMember = xmalloc(sizeof(list_desc_type));
 	/* Fill the list member */
@@ -156,6 +182,148 @@ vAdd2ListInfoList(ULONG ulListID, USHORT usIstd, UCHAR ucListLevel,
 	pBlockLast = pListMember;
 } /* end of vAdd2ListInfoList */
 
+/*
+ * vBuildLevelTable - build the table with the information per LFO and level
+ *
+ * Per LFO and level the table holds the first record with the list ID of the
+ * LFO and that level. Without such a record it holds the last record with
+ * that list ID and level zero, if any.
+ */
+static void
+vBuildLevelTable(void)
+{
+	const list_desc_type	*pCurr;
+	const list_block_type	**apLevel;
+	const list_block_type	*pNearMatch;
+	USHORT	usIndex;
+	UCHAR	ucLevel;
+
+	fail(apLevelTable != NULL);
+
+	apLevelTable = xcalloc((size_t)usLfoLen * LIST_LEVELS,
+				sizeof(const list_block_type *));
+	for (usIndex = 0; usIndex < usLfoLen; usIndex++) {
+		apLevel = apLevelTable + (size_t)usIndex * LIST_LEVELS;
+		pNearMatch = NULL;
+		for (pCurr = pAnchor; pCurr != NULL; pCurr = pCurr->pNext) {
+			if (pCurr->ulListID != aulLfoList[usIndex]) {
+				/* No match */
+				continue;
+			}
+			if (pCurr->ucListLevel < LIST_LEVELS &&
+			    apLevel[pCurr->ucListLevel] == NULL) {
+				/* First exact match */
+				apLevel[pCurr->ucListLevel] = &pCurr->tInfo;
+			}
+			if (pCurr->ucListLevel == 0) {
+				/* Near match */
+				pNearMatch = &pCurr->tInfo;
+			}
+		}
+		/* No exact match, use a near match if any */
+		for (ucLevel = 0; ucLevel < LIST_LEVELS; ucLevel++) {
+			if (apLevel[ucLevel] == NULL) {
+				apLevel[ucLevel] = pNearMatch;
+			}
+		}
+	}
+} /* end of vBuildLevelTable */
+
+/*
+ * iCompareIstd - compare the istd of two records of the istd table
+ *
+ * Compares two records. For use by bsearch(3C).
+ *
+ * returns -1 if rec1 < rec2, 0 if rec1 == rec2, 1 if rec1 > rec2
+ */
+static int
+iCompareIstd(const void *pvRecord1, const void *pvRecord2)
+{
+	USHORT	usIstd1, usIstd2;
+
+	usIstd1 = ((const istd_entry_type *)pvRecord1)->usIstd;
+	usIstd2 = ((const istd_entry_type *)pvRecord2)->usIstd;
+
+	if (usIstd1 < usIstd2) {
+		return -1;
+	}
+	if (usIstd1 > usIstd2) {
+		return 1;
+	}
+	return 0;
+} /* end of iCompareIstd */
+
+/*
+ * iCompareIstdSeq - compare two records of the istd table
+ *
+ * Compares on istd first and on the position in the list second.
+ * For use by qsort(3C).
+ *
+ * returns -1 if rec1 < rec2, 0 if rec1 == rec2, 1 if rec1 > rec2
+ */
+static int
+iCompareIstdSeq(const void *pvRecord1, const void *pvRecord2)
+{
+	size_t	tSeqNumber1, tSeqNumber2;
+	int	iResult;
+
+	iResult = iCompareIstd(pvRecord1, pvRecord2);
+	if (iResult != 0) {
+		return iResult;
+	}
+	tSeqNumber1 = ((const istd_entry_type *)pvRecord1)->tSeqNumber;
+	tSeqNumber2 = ((const istd_entry_type *)pvRecord2)->tSeqNumber;
+
+	if (tSeqNumber1 < tSeqNumber2) {
+		return -1;
+	}
+	if (tSeqNumber1 > tSeqNumber2) {
+		return 1;
+	}
+	return 0;
+} /* end of iCompareIstdSeq */
+
+/*
+ * vBuildIstdTable - build the table with the information per istd
+ *
+ * The table is sorted on istd and holds the first record with every istd
+ */
+static void
+vBuildIstdTable(void)
+{
+	const list_desc_type	*pCurr;
+	size_t	tLen, tIndex, tNext;
+
+	fail(atIstdTable != NULL);
+
+	tLen = 0;
+	for (pCurr = pAnchor; pCurr != NULL; pCurr = pCurr->pNext) {
+		tLen++;
+	}
+	if (tLen == 0) {
+		return;
+	}
+	atIstdTable = xcalloc(tLen, sizeof(istd_entry_type));
+	tIndex = 0;
+	for (pCurr = pAnchor; pCurr != NULL; pCurr = pCurr->pNext) {
+		atIstdTable[tIndex].pInfo = &pCurr->tInfo;
+		atIstdTable[tIndex].tSeqNumber = tIndex;
+		atIstdTable[tIndex].usIstd = pCurr->usIstd;
+		tIndex++;
+	}
+	qsort(atIstdTable, tLen, sizeof(istd_entry_type), iCompareIstdSeq);
+	/* Keep only the first record of every istd */
+	tNext = 1;
+	for (tIndex = 1; tIndex < tLen; tIndex++) {
+		if (atIstdTable[tIndex].usIstd !=
+		    atIstdTable[tNext - 1].usIstd) {
+			atIstdTable[tNext] = atIstdTable[tIndex];
+			tNext++;
+		}
+	}
+	tIstdTableLen = tNext;
+} /* end of vBuildIstdTable */
+
 /*
  * Get a matching record from the List Information List
  *
@@ -164,10 +332,6 @@ vAdd2ListInfoList(ULONG ulListID, USHORT usIstd, UCHAR ucListLevel,
 const list_block_type *
 pGetListInfo(USHORT usListIndex, UCHAR ucListLevel)
 {
-	list_desc_type	*pCurr;
-	list_block_type	*pNearMatch;
-	ULONG	ulListID;
-
 	if (usListIndex == 0) {
 		return NULL;
 	}
@@ -177,26 +341,13 @@ pGetListInfo(USHORT usListIndex, UCHAR ucListLevel)
 		return NULL;
 	}
 	fail(aulLfoList == NULL);
-	ulListID = aulLfoList[usListIndex - 1];
-	NO_DBG_HEX(ulListID);
+	NO_DBG_HEX(aulLfoList[usListIndex - 1]);
 
-	pNearMatch = NULL;
-	for (pCurr = pAnchor; pCurr != NULL; pCurr = pCurr->pNext) {
-		if (pCurr->ulListID != ulListID) {
-			/* No match */
-			continue;
-		}
-		if (pCurr->ucListLevel == ucListLevel) {
-			/* Exact match */
-			return &pCurr->tInfo;
-		}
-		if (pCurr->ucListLevel == 0) {
-			/* Near match */
-			pNearMatch = &pCurr->tInfo;
-		}
+	if (apLevelTable == NULL) {
+		vBuildLevelTable();
 	}
-	/* No exact match, use a near match if any */
-	return pNearMatch;
+	return apLevelTable[(size_t)(usListIndex - 1) * LIST_LEVELS +
+				ucListLevel];
 } /* end of pGetListInfo */
 
 /*
@@ -207,18 +358,30 @@ pGetListInfo(USHORT usListIndex, UCHAR ucListLevel)
 const list_block_type *
 pGetListInfoByIstd(USHORT usIstd)
 {
-	list_desc_type	*pCurr;
+	istd_entry_type	tKey;
+	const istd_entry_type	*pEntry;
 
 	if (usIstd == ISTD_INVALID || usIstd == STI_NIL || usIstd == STI_USER) {
 		return NULL;
 	}
 
-	for (pCurr = pAnchor; pCurr != NULL; pCurr = pCurr->pNext) {
-		if (pCurr->usIstd == usIstd) {
-			return &pCurr->tInfo;
-		}
+	if (atIstdTable == NULL) {
+		vBuildIstdTable();
 	}
-	return NULL;
+	if (tIstdTableLen == 0) {
+		return NULL;
+	}
+	tKey.pInfo = NULL;
+	tKey.tSeqNumber = 0;
+	tKey.usIstd = usIstd;
+	pEntry = (const istd_entry_type *)bsearch(&tKey,
+			atIstdTable,
+			tIstdTableLen, sizeof(atIstdTable[0]),
+			iCompareIstd);
+	if (pEntry == NULL) {
+		return NULL;
+	}
+	return pEntry->pInfo;
 } /* end of pGetListInfoByIstd */
 
 /*
@@ -227,34 +390,17 @@ pGetListInfoByIstd(USHORT usIstd)
 static void
 vRestartListValues(USHORT usListIndex, UCHAR ucListLevel)
 {
-	list_value_type	*pPrev, *pCurr, *pNext;
-	int		iCounter;
+	list_value_type	*pValue;
 
-	iCounter = 0;
-	pPrev = NULL;
-	pCurr = pValues;
+	fail(atValues == NULL);
+	fail(usListIndex == 0 || usListIndex - 1 >= usLfoLen);
+	fail(ucListLevel >= LIST_LEVELS);
 
-	while (pCurr != NULL) {
-		if (pCurr->usListIndex != usListIndex ||
-		    pCurr->ucListLevel <= ucListLevel) {
-			pPrev = pCurr;
-			pCurr = pCurr->pNext;
-			continue;
-		}
-		/* Reset the level by deleting the record */
-		pNext = pCurr->pNext;
-		if (pPrev == NULL) {
-			pValues = pNext;
-		} else {
-			pPrev->pNext = pNext;
-		}
-		DBG_DEC(pCurr->usListIndex);
-		DBG_DEC(pCurr->ucListLevel);
-		pCurr = xfree(pCurr);
-		pCurr = pNext;
-		iCounter++;
-	}
-	DBG_DEC_C(iCounter > 0, iCounter);
+	pValue = &atValues[usListIndex - 1];
+	DBG_HEX_C((pValue->usInUse >> (ucListLevel + 1)) != 0,
+		pValue->usInUse);
+	/* Reset the levels by forgetting their values */
+	pValue->usInUse &= (USHORT)(BIT(ucListLevel + 1) - 1);
 } /* end of vRestartListValues */
 
 /*
@@ -266,8 +412,8 @@ USHORT
 usGetListValue(int iListSeqNumber, int iWordVersion,
 	const style_block_type *pStyle)
 {
-	list_value_type	*pCurr;
-	USHORT		usValue;
+	list_value_type	*pValue;
+	USHORT		usValue, usBit;
 
 	fail(iListSeqNumber < 0);
 	fail(iListSeqNumber < iOldListSeqNumber);
@@ -301,28 +447,20 @@ usGetListValue(int iListSeqNumber, int iWordVersion,
 		return 0;
 	}
 
-	for (pCurr = pValues; pCurr != NULL; pCurr = pCurr->pNext) {
-		if (pCurr->usListIndex == pStyle->usListIndex &&
-		    pCurr->ucListLevel == pStyle->ucListLevel) {
-			/* Record found; increment and return the value */
-			pCurr->usValue++;
-			usValue = pCurr->usValue;
-			if (!pStyle->bNoRestart) {
-				vRestartListValues(pStyle->usListIndex,
-						pStyle->ucListLevel);
-			}
-			return usValue;
-		}
+	if (atValues == NULL) {
+		atValues = xcalloc((size_t)usLfoLen, sizeof(list_value_type));
 	}
-
-	/* Record not found; create it and add it to the front of the list */
-	pCurr = xmalloc(sizeof(list_value_type));
-	pCurr->usValue = pStyle->usStartAt;
-	pCurr->usListIndex = pStyle->usListIndex;
-	pCurr->ucListLevel = pStyle->ucListLevel;
-	pCurr->pNext = pValues;
-	pValues = pCurr;
-	usValue = pCurr->usValue;
+	pValue = &atValues[pStyle->usListIndex - 1];
+	usBit = (USHORT)BIT(pStyle->ucListLevel);
+	if ((pValue->usInUse & usBit) != 0) {
+		/* Value found; increment it */
+		pValue->ausValue[pStyle->ucListLevel]++;
+	} else {
+		/* Value not found; start the level */
+		pValue->ausValue[pStyle->ucListLevel] = pStyle->usStartAt;
+		pValue->usInUse |= usBit;
+	}
+	usValue = pValue->ausValue[pStyle->ucListLevel];
 	if (!pStyle->bNoRestart) {
 		vRestartListValues(pStyle->usListIndex, pStyle->ucListLevel);
 	}
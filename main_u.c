@@ -25,6 +25,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #if defined(__dos)
 #include <fcntl.h>
 #include <io.h>
@@ -67,7 +68,7 @@ vUsage(void)
 		"\tUsage: %s [switches] wordfile1 [wordfile2 ...]\n", szTask);
 	fprintf(stderr,
 		"\tSwitches: [-f|-t|-a papersize|-p papersize|-x dtd]"
-		"[-m mapping][-w #][-i #][-Ls]\n");
+		"[-m mapping][-w #][-i #][-z #][-e dir][-blLsS]\n");
 	fprintf(stderr, "\t\t-f formatted text output\n");
 	fprintf(stderr, "\t\t-t text output (default)\n");
 	fprintf(stderr, "\t\t-a <paper size name> Adobe PDF output\n");
@@ -78,9 +79,14 @@ vUsage(void)
 	fprintf(stderr, "\t\t-m <mapping> character mapping file\n");
 	fprintf(stderr, "\t\t-w <width> in characters of text output\n");
 	fprintf(stderr, "\t\t-i <level> image level (PostScript only)\n");
+	fprintf(stderr, "\t\t-z <level> compression level (PDF only)\n");
+	fprintf(stderr, "\t\t-b binary image data (PostScript only)\n");
+	fprintf(stderr, "\t\t-e <dir> extract the images into a directory\n");
+	fprintf(stderr, "\t\t-l low memory use (formatted text and XML only)\n");
 	fprintf(stderr, "\t\t-L use landscape mode (PostScript only)\n");
 	fprintf(stderr, "\t\t-r Show removed text\n");
 	fprintf(stderr, "\t\t-s Show hidden (by Word) text\n");
+	fprintf(stderr, "\t\t-S Show conversion statistics on stderr\n");
 } /* end of vUsage */
 
 /*
@@ -142,6 +148,35 @@ pStdin2TmpFile(long *lFilesize)
 	return pTmpFile;
 } /* end of pStdin2TmpFile */
 
+/*
+ * szGetImageName - get the start of the names of the extracted images
+ *
+ * This is the name of the Word file without the directories and extension
+ * Returns an allocated string
+ */
+static char *
+szGetImageName(const char *szFilename)
+{
+	const char	*szLeafname;
+	char	*szName, *pcDot;
+
+	if (szFilename[0] == '-' && szFilename[1] == '\0') {
+		return xstrdup("stdin");
+	}
+	szLeafname = strrchr(szFilename, FILE_SEPARATOR[0]);
+	if (szLeafname == NULL) {
+		szLeafname = szFilename;
+	} else {
+		szLeafname++;
+	}
+	szName = xstrdup(szLeafname);
+	pcDot = strrchr(szName, '.');
+	if (pcDot != NULL && pcDot != szName) {
+		*pcDot = '\0';
+	}
+	return szName;
+} /* end of szGetImageName */
+
 /*
  * bProcessFile - process a single file
  *
@@ -152,7 +187,9 @@ bProcessFile(const char *szFilename)
 {
 	FILE		*pFile;
 	diagram_type	*pDiag;
-	long		lFilesize;
+	options_type	tOptions;
+	char		*szImageName;
+	long		lFilesize, lOutputStart, lOutputEnd;
 	int		iWordVersion;
 	BOOL		bResult;
 
@@ -160,6 +197,9 @@ bProcessFile(const char *szFilename)
 
 	DBG_MSG(szFilename);
 
+	vGetOptions(&tOptions);
+	vResetStatistics(tOptions.bShowStatistics);
+
 	if (szFilename[0] == '-' && szFilename[1] == '\0') {
 		pFile = pStdin2TmpFile(&lFilesize);
 		if (pFile == NULL) {
@@ -172,6 +212,8 @@ bProcessFile(const char *szFilename)
 			werr(0, "I can't open '%s' for reading", szFilename);
 			return FALSE;
 		}
+		/* Most reads are small, so let stdio fetch large chunks */
+		(void)setvbuf(pFile, NULL, _IOFBF, STREAM_BUFFER_SIZE);
 
 		lFilesize = lGetFilesize(szFilename);
 		if (lFilesize < 0) {
@@ -205,14 +247,32 @@ bProcessFile(const char *szFilename)
 	/* Reset any reading done during file testing */
 	rewind(pFile);
 
-	pDiag = pCreateDiagram(szTask, szFilename);
-	if (pDiag == NULL) {
-		(void)fclose(pFile);
-		return FALSE;
+	/* Only known when the output is a regular file */
+	lOutputStart = ftell(stdout);
+
+	if (tOptions.szExtractDirectory != NULL) {
+		/* Only write the images to files */
+		szImageName = szGetImageName(szFilename);
+		bResult = bExtractImages(pFile, lFilesize,
+				tOptions.szExtractDirectory, szImageName);
+		szImageName = xfree(szImageName);
+	} else {
+		pDiag = pCreateDiagram(szTask, szFilename);
+		if (pDiag == NULL) {
+			(void)fclose(pFile);
+			return FALSE;
+		}
+
+		bResult = bWordDecryptor(pFile, lFilesize, pDiag);
+		vDestroyDiagram(pDiag);
 	}
 
-	bResult = bWordDecryptor(pFile, lFilesize, pDiag);
-	vDestroyDiagram(pDiag);
+	if (tOptions.bShowStatistics) {
+		lOutputEnd = ftell(stdout);
+		vPrintStatistics(stderr, szFilename,
+			lOutputStart < 0 || lOutputEnd < 0 ?
+			-1 : lOutputEnd - lOutputStart);
+	}
 
 	(void)fclose(pFile);
 	return bResult;
@@ -282,6 +342,9 @@ main(int argc, char **argv)
 	bUseXML = tOptions.eConversionType == conversion_xml;
 	iGoodCount = 0;
 
+	/* Decoding produces many small writes, collect them before output */
+	(void)setvbuf(stdout, NULL, _IOFBF, STREAM_BUFFER_SIZE);
+
 #if defined(__dos)
 	if (tOptions.eConversionType == conversion_pdf) {
 		/* PDF must be written as a binary stream */
@@ -187,6 +187,7 @@ bReadBytes(UCHAR *aucBytes, size_t tMemb, ULONG ulOffset, FILE *pFile)
 	if (ulOffset > (ULONG)LONG_MAX) {
 		return FALSE;
 	}
+	vCountRead(ulOffset, tMemb);
 	if (fseek(pFile, (long)ulOffset, SEEK_SET) != 0) {
 		return FALSE;
 	}
@@ -305,16 +306,76 @@ iFindSplit(const char *szString, size_t tStringLen)
 	return -1;
 } /* end of iFindSplit */
 
+/*
+ * vResetSplit - forget the split information of an empty string
+ */
+void
+vResetSplit(output_type *pOutput)
+{
+	fail(pOutput == NULL);
+	fail(pOutput->tNextFree != 0);
+
+	pOutput->bSplitKnown = TRUE;
+	pOutput->tSplitIndex = 0;
+	pOutput->lSplitWidth = 0;
+	pOutput->tSplitKeep = 0;
+	pOutput->lSplitKeepWidth = 0;
+	pOutput->tNonSpace = 0;
+	pOutput->lNonSpaceWidth = 0;
+} /* end of vResetSplit */
+
+/*
+ * vUpdateSplit - update the split information after storing a character
+ *
+ * The character is made of the last tLen bytes of the string and its width
+ * is already part of the string width
+ */
+void
+vUpdateSplit(output_type *pOutput, size_t tLen)
+{
+	size_t	tIndex;
+	char	cChar;
+
+	fail(pOutput == NULL);
+	fail(tLen > pOutput->tNextFree);
+
+	if (!pOutput->bSplitKnown) {
+		return;
+	}
+	for (tIndex = pOutput->tNextFree - tLen;
+	     tIndex < pOutput->tNextFree;
+	     tIndex++) {
+		cChar = pOutput->szStorage[tIndex];
+		if (!isspace((int)(UCHAR)cChar)) {
+			pOutput->tNonSpace = tIndex + 1;
+			pOutput->lNonSpaceWidth = pOutput->lStringWidth;
+		}
+		/* The same rules as iFindSplit */
+		if (tIndex >= 1 &&
+		    (cChar == ' ' ||
+		     (cChar == '-' &&
+		      pOutput->szStorage[tIndex - 1] != ' '))) {
+			pOutput->tSplitIndex = tIndex + 1;
+			pOutput->lSplitWidth = pOutput->lStringWidth;
+			pOutput->tSplitKeep = pOutput->tNonSpace;
+			pOutput->lSplitKeepWidth = pOutput->lNonSpaceWidth;
+		}
+	}
+} /* end of vUpdateSplit */
+
 /*
  * pSplitList - split the specified list in a printable part and a leftover part
  *
+ * The split information of a string is used when it is known, so only
+ * strings that were split before have to be searched again
+ *
  * returns the pointer to the leftover part
  */
 output_type *
 pSplitList(output_type *pAnchor)
 {
 	output_type	*pCurr, *pLeftOver;
-	int		iIndex;
+	int		iIndex, iKeep;
 
  	fail(pAnchor == NULL);
 
@@ -322,7 +383,11 @@ pSplitList(output_type *pAnchor)
 		;	/* EMPTY */
 	iIndex = -1;
 	for (; pCurr != NULL; pCurr = pCurr->pPrev) {
-		iIndex = iFindSplit(pCurr->szStorage, pCurr->tNextFree);
+		if (pCurr->bSplitKnown) {
+			iIndex = (int)pCurr->tSplitIndex - 1;
+		} else {
+			iIndex = iFindSplit(pCurr->szStorage, pCurr->tNextFree);
+		}
 		if (iIndex >= 0) {
 			break;
 		}
@@ -347,11 +412,42 @@ pSplitList(output_type *pAnchor)
 	pLeftOver->usFontStyle = pCurr->usFontStyle;
 	pLeftOver->tFontRef = pCurr->tFontRef;
 	pLeftOver->usFontSize = pCurr->usFontSize;
-	pLeftOver->lStringWidth = lComputeStringWidth(
+	/* The leftover part has no place to split */
+	pLeftOver->bSplitKnown = TRUE;
+	pLeftOver->tSplitIndex = 0;
+	pLeftOver->lSplitWidth = 0;
+	pLeftOver->tSplitKeep = 0;
+	pLeftOver->lSplitKeepWidth = 0;
+	if (pCurr->bSplitKnown) {
+		pLeftOver->lStringWidth =
+			pCurr->lStringWidth - pCurr->lSplitWidth;
+		if (pCurr->tNonSpace > (size_t)iIndex + 1) {
+			pLeftOver->tNonSpace =
+				pCurr->tNonSpace - (size_t)iIndex - 1;
+			pLeftOver->lNonSpaceWidth =
+				pCurr->lNonSpaceWidth - pCurr->lSplitWidth;
+		} else {
+			pLeftOver->tNonSpace = 0;
+			pLeftOver->lNonSpaceWidth = 0;
+		}
+	} else {
+		pLeftOver->lStringWidth = lComputeStringWidth(
 					pLeftOver->szStorage,
 					pLeftOver->tNextFree,
 					pLeftOver->tFontRef,
 					pLeftOver->usFontSize);
+		iKeep = (int)pLeftOver->tNextFree - 1;
+		while (iKeep >= 0 &&
+		       isspace((int)(UCHAR)pLeftOver->szStorage[iKeep])) {
+			iKeep--;
+		}
+		pLeftOver->tNonSpace = (size_t)iKeep + 1;
+		pLeftOver->lNonSpaceWidth = lComputeStringWidth(
+					pLeftOver->szStorage,
+					pLeftOver->tNonSpace,
+					pLeftOver->tFontRef,
+					pLeftOver->usFontSize);
+	}
 	pLeftOver->pPrev = NULL;
 	pLeftOver->pNext = pCurr->pNext;
 	if (pLeftOver->pNext != NULL) {
@@ -361,17 +457,29 @@ pSplitList(output_type *pAnchor)
 
 	NO_DBG_MSG("pAnchor");
 	NO_DBG_HEX(pCurr->szStorage[iIndex]);
-	while (iIndex >= 0 && isspace((int)(UCHAR)pCurr->szStorage[iIndex])) {
-		iIndex--;
-	}
-	pCurr->tNextFree = (size_t)iIndex + 1;
-	pCurr->szStorage[pCurr->tNextFree] = '\0';
-	NO_DBG_MSG(pCurr->szStorage);
-	pCurr->lStringWidth = lComputeStringWidth(
+	if (pCurr->bSplitKnown) {
+		pCurr->tNextFree = pCurr->tSplitKeep;
+		pCurr->lStringWidth = pCurr->lSplitKeepWidth;
+	} else {
+		while (iIndex >= 0 &&
+		       isspace((int)(UCHAR)pCurr->szStorage[iIndex])) {
+			iIndex--;
+		}
+		pCurr->tNextFree = (size_t)iIndex + 1;
+		pCurr->lStringWidth = lComputeStringWidth(
 					pCurr->szStorage,
 					pCurr->tNextFree,
 					pCurr->tFontRef,
 					pCurr->usFontSize);
+	}
+	pCurr->szStorage[pCurr->tNextFree] = '\0';
+	NO_DBG_MSG(pCurr->szStorage);
+	if (pCurr->tNextFree == 0) {
+		vResetSplit(pCurr);
+	} else {
+		/* Search this string when it has to be split again */
+		pCurr->bSplitKnown = FALSE;
+	}
 	pCurr->pNext = NULL;
 	fail(!bCheckDoubleLinkedList(pAnchor));
 
@@ -78,6 +78,11 @@ static const options_type	tOptionsDefault = {
 	INT_MAX,
 	INT_MAX,
 	level_default,
+	FALSE,
+	0,
+	FALSE,
+	NULL,
+	FALSE,
 #if defined(__riscos)
 	TRUE,
 	DEFAULT_SCALE_FACTOR,
@@ -388,7 +393,7 @@ iReadOptions(int argc, char **argv)
 	strncpy(szLeafname, szGetDefaultMappingFile(), sizeof(szLeafname) - 1);
 	szLeafname[sizeof(szLeafname) - 1] = '\0';
 /* Command line */
-	while ((iChar = getopt(argc, argv, "La:fhi:m:p:rstw:x:")) != -1) {
+	while ((iChar = getopt(argc, argv, "La:be:fhi:lm:p:rsStw:x:z:")) != -1) {
 		switch (iChar) {
 		case 'L':
 			tOptionsCurr.bUseLandscape = TRUE;
@@ -399,6 +404,15 @@ iReadOptions(int argc, char **argv)
 				return -1;
 			}
 			break;
+		case 'b':
+			tOptionsCurr.bBinaryImages = TRUE;
+			break;
+		case 'e':
+			tOptionsCurr.szExtractDirectory = optarg;
+			break;
+		case 'l':
+			tOptionsCurr.bStreamFontInfo = TRUE;
+			break;
 		case 'f':
 			tOptionsCurr.eConversionType = conversion_fmt_text;
 			break;
@@ -449,6 +463,9 @@ iReadOptions(int argc, char **argv)
 		case 's':
 			tOptionsCurr.bHideHiddenText = FALSE;
 			break;
+		case 'S':
+			tOptionsCurr.bShowStatistics = TRUE;
+			break;
 		case 't':
 			tOptionsCurr.eConversionType = conversion_text;
 			break;
@@ -464,6 +481,18 @@ iReadOptions(int argc, char **argv)
 				DBG_DEC(tOptionsCurr.iParagraphBreak);
 			}
 			break;
+		case 'z':
+			iTmp = (int)strtol(optarg, &pcChar, 10);
+			if (*pcChar == '\0') {
+				if (iTmp < 0) {
+					iTmp = 0;
+				} else if (iTmp > 9) {
+					iTmp = 9;
+				}
+				tOptionsCurr.iCompressionLevel = iTmp;
+				DBG_DEC(tOptionsCurr.iCompressionLevel);
+			}
+			break;
 		case 'x':
 			if (STREQ(optarg, "db")) {
 				tOptionsCurr.iParagraphBreak = 0;
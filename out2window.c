@@ -11,8 +11,27 @@
 #include <ctype.h>
 #include "antiword.h"
 
+/*
+ * Private structure to hide the way the column layout of a table row
+ * is stored from the rest of the program
+ */
+typedef struct table_layout_tag {
+	BOOL	bValid;
+	drawfile_fontref	tFontRef;
+	USHORT	usFontSize;
+	double	dMagnify;
+	int	iNbrOfColumns;
+	/* The column widths of the row in twips */
+	short	asColumnWidth[TABLE_COLUMN_MAX];
+	/* The column widths of the layout in characters */
+	size_t	atColumnWidthMax[TABLE_COLUMN_MAX];
+	size_t	tColumnWidthTotal;
+} table_layout_type;
+
 /* Used for numbering the chapters */
 static unsigned int	auiHdrCounter[9];
+/* The column layout of the previous table row */
+static table_layout_type	tLayout;
 
 
 /*
@@ -458,83 +477,92 @@ vRemoveRowEnd(char *szRowTxt)
 } /* end of vRemoveRowEnd */
 
 /*
- * tComputeStringLengthMax - max string length in relation to max column width
+ * tWrapColumnText - get the part of the column text for the next line
+ *
+ * A single pass over the text gives the number of bytes that fit the column,
+ * the last place to break the line and the width in columns of both.
+ * A newline that ends the text of the line is replaced by a space.
  *
- * Return the maximum string length
+ * Returns the number of bytes to print, their width in ptWidth
  */
 static size_t
-tComputeStringLengthMax(const char *szString, size_t tColumnWidthMax)
+tWrapColumnText(char *szString, size_t tColumnWidthMax, size_t *ptWidth)
 {
-	const char	*pcTmp;
-	size_t	tLengthMax, tLenPrev, tLen, tWidth;
+	size_t	tLen, tWidth, tCharLen, tCharWidth;
+	size_t	tKeep, tKeepWidth, tSpace, tSpaceWidth;
+	size_t	tBreak, tBreakWidth;
+	BOOL	bSpace, bBreak;
 
-	TRACE_MSG("tComputeStringLengthMax");
+	TRACE_MSG("tWrapColumnText");
 
 	fail(szString == NULL);
 	fail(tColumnWidthMax == 0);
-
-	pcTmp = strchr(szString, '\n');
-	if (pcTmp != NULL) {
-		tLengthMax = (size_t)(pcTmp - szString + 1);
-	} else {
-		tLengthMax = strlen(szString);
-	}
-	if (tLengthMax == 0) {
-		return 0;
-	}
+	fail(ptWidth == NULL);
 
 	tLen = 0;
 	tWidth = 0;
-	for (;;) {
-		tLenPrev = tLen;
-		tLen += tGetCharacterLength(szString + tLen);
-		DBG_DEC_C(tLen > tLengthMax, tLen);
-		DBG_DEC_C(tLen > tLengthMax, tLengthMax);
-		fail(tLen > tLengthMax);
-		tWidth = tCountColumns(szString, tLen);
-		if (tWidth > tColumnWidthMax) {
-			return tLenPrev;
+	tKeep = 0;
+	tKeepWidth = 0;
+	tSpace = 0;
+	tSpaceWidth = 0;
+	tBreak = 0;
+	tBreakWidth = 0;
+	bSpace = FALSE;
+	bBreak = FALSE;
+	while (szString[tLen] != '\0') {
+		tCharLen = tGetCharacterLength(szString + tLen);
+		fail(tCharLen == 0);
+		tCharWidth = tCountColumns(szString + tLen, tCharLen);
+		if (tWidth + tCharWidth > tColumnWidthMax) {
+			/* This character does not fit anymore */
+			break;
 		}
-		if (tLen >= tLengthMax) {
-			return tLengthMax;
+		if (szString[tLen] == ' ') {
+			tSpace = tLen;
+			tSpaceWidth = tWidth;
+			bSpace = TRUE;
+		} else if (szString[tLen] != '\n') {
+			/* The text up to here is worth keeping */
+			tKeep = tLen + tCharLen;
+			tKeepWidth = tWidth + tCharWidth;
+			if (bSpace) {
+				tBreak = tSpace;
+				tBreakWidth = tSpaceWidth;
+				bBreak = TRUE;
+			}
+		}
+		tLen += tCharLen;
+		tWidth += tCharWidth;
+		if (szString[tLen - tCharLen] == '\n') {
+			/* The newline ends the text of this line */
+			break;
 		}
 	}
-} /* end of tComputeStringLengthMax */
+	NO_DBG_DEC(tLen);
 
-/*
- * tGetBreakingPoint - get the number of bytes that fit the column
- *
- * Returns the number of bytes that fit the column
- */
-static size_t
-tGetBreakingPoint(const char *szString,
-	size_t tLen, size_t tWidth, size_t tColumnWidthMax)
-{
-	int	iIndex;
-
-	TRACE_MSG("tGetBreakingPoint");
+	/* Remove the white-space from the end of the line */
+	if (tLen > tKeep && szString[tLen - 1] == '\n') {
+		szString[tLen - 1] = ' ';
+	}
 
-	fail(szString == NULL);
-	fail(tLen > strlen(szString));
-	fail(tWidth > tColumnWidthMax);
-
-	if (tWidth < tColumnWidthMax ||
-	    (tWidth == tColumnWidthMax &&
-	     (szString[tLen] == ' ' ||
-	      szString[tLen] == '\n' ||
-	      szString[tLen] == '\0'))) {
-		/* The string already fits, do nothing */
-		return tLen;
-	}
-	/* Search for a breaking point */
-	for (iIndex = (int)tLen - 1; iIndex >= 0; iIndex--) {
-		if (szString[iIndex] == ' ') {
-			return (size_t)iIndex;
-		}
+	if (tKeepWidth < tColumnWidthMax ||
+	    (tKeepWidth == tColumnWidthMax &&
+	     (szString[tKeep] == ' ' ||
+	      szString[tKeep] == '\n' ||
+	      szString[tKeep] == '\0'))) {
+		/* The text already fits, do nothing */
+		*ptWidth = tKeepWidth;
+		return tKeep;
+	}
+	if (bBreak) {
+		/* Break the line at the last space */
+		*ptWidth = tBreakWidth;
+		return tBreak;
 	}
 	/* No breaking point found, just fill the column */
-	return tLen;
-} /* end of tGetBreakingPoint */
+	*ptWidth = tKeepWidth;
+	return tKeep;
+} /* end of tWrapColumnText */
 
 /*
  * tComputeColumnWidthMax - compute the maximum column width
@@ -565,6 +593,63 @@ tComputeColumnWidthMax(short sWidth, long lCharWidth, double dFactor)
 	return tColumnWidthMax;
 } /* end of tComputeColumnWidthMax */
 
+/*
+ * pGetTableLayout - get the column layout of a table row
+ *
+ * The rows of a table usually have the same shape, so the layout of the
+ * previous row is used again when the shape and the font are the same
+ */
+static const table_layout_type *
+pGetTableLayout(const output_type *pOutput, const row_block_type *pRowInfo,
+	int iNbrOfColumns, double dMagnify)
+{
+	long	lCharWidthLarge, lCharWidthSmall;
+	int	iIndex;
+
+	TRACE_MSG("pGetTableLayout");
+
+	fail(pOutput == NULL || pRowInfo == NULL);
+	fail(iNbrOfColumns <= 0 || iNbrOfColumns > TABLE_COLUMN_MAX);
+
+	if (tLayout.bValid &&
+	    tLayout.tFontRef == pOutput->tFontRef &&
+	    tLayout.usFontSize == pOutput->usFontSize &&
+	    tLayout.dMagnify == dMagnify &&
+	    tLayout.iNbrOfColumns == iNbrOfColumns &&
+	    memcmp(tLayout.asColumnWidth, pRowInfo->asColumnWidth,
+		(size_t)iNbrOfColumns * sizeof(short)) == 0) {
+		/* Same shape as the previous row */
+		return &tLayout;
+	}
+
+	/* Character sizes */
+	lCharWidthLarge = lComputeStringWidth("W", 1,
+				pOutput->tFontRef, pOutput->usFontSize);
+	NO_DBG_DEC(lCharWidthLarge);
+	lCharWidthSmall = lComputeStringWidth("i", 1,
+				pOutput->tFontRef, pOutput->usFontSize);
+	NO_DBG_DEC(lCharWidthSmall);
+	/* For the time being: use a fixed width font */
+	fail(lCharWidthLarge != lCharWidthSmall);
+
+	/* Fill the table with maximum column widths */
+	tLayout.tColumnWidthTotal = 0;
+	for (iIndex = 0; iIndex < iNbrOfColumns; iIndex++) {
+		tLayout.asColumnWidth[iIndex] = pRowInfo->asColumnWidth[iIndex];
+		tLayout.atColumnWidthMax[iIndex] = tComputeColumnWidthMax(
+					pRowInfo->asColumnWidth[iIndex],
+					lCharWidthLarge,
+					dMagnify);
+		tLayout.tColumnWidthTotal += tLayout.atColumnWidthMax[iIndex];
+	}
+	tLayout.tFontRef = pOutput->tFontRef;
+	tLayout.usFontSize = pOutput->usFontSize;
+	tLayout.dMagnify = dMagnify;
+	tLayout.iNbrOfColumns = iNbrOfColumns;
+	tLayout.bValid = TRUE;
+	return &tLayout;
+} /* end of pGetTableLayout */
+
 /*
  * vTableRow2Window - put a table row into a diagram
  */
@@ -573,12 +658,11 @@ vTableRow2Window(diagram_type *pDiag, output_type *pOutput,
 	const row_block_type *pRowInfo,
 	conversion_type eConversionType, int iParagraphBreak)
 {
+	const table_layout_type	*pLayout;
 	output_type	tRow;
 	char	*aszColTxt[TABLE_COLUMN_MAX];
 	char	*szLine, *pcTxt;
 	double	dMagnify;
-	long	lCharWidthLarge, lCharWidthSmall;
-	size_t	tColumnWidthTotal, atColumnWidthMax[TABLE_COLUMN_MAX];
 	size_t	tSize, tColumnWidthMax, tWidth, tLen;
 	int	iIndex, iNbrOfColumns, iTmp;
 	BOOL	bNotReady;
@@ -590,16 +674,6 @@ vTableRow2Window(diagram_type *pDiag, output_type *pOutput,
 	fail(pOutput->pNext != NULL);
 	fail(iParagraphBreak < 0);
 
-	/* Character sizes */
-	lCharWidthLarge = lComputeStringWidth("W", 1,
-				pOutput->tFontRef, pOutput->usFontSize);
-	NO_DBG_DEC(lCharWidthLarge);
-	lCharWidthSmall = lComputeStringWidth("i", 1,
-				pOutput->tFontRef, pOutput->usFontSize);
-	NO_DBG_DEC(lCharWidthSmall);
-	/* For the time being: use a fixed width font */
-	fail(lCharWidthLarge != lCharWidthSmall);
-
 	vRemoveRowEnd(pOutput->szStorage);
 
 	/* Split the row text into a set of column texts */
@@ -662,20 +736,14 @@ vTableRow2Window(diagram_type *pDiag, output_type *pOutput,
 	} else {
 		dMagnify = 1.0;
 	}
-	tColumnWidthTotal = 0;
-	for (iIndex = 0; iIndex < iNbrOfColumns; iIndex++) {
-		atColumnWidthMax[iIndex] = tComputeColumnWidthMax(
-					pRowInfo->asColumnWidth[iIndex],
-					lCharWidthLarge,
-					dMagnify);
-		tColumnWidthTotal += atColumnWidthMax[iIndex];
-	}
+	pLayout = pGetTableLayout(pOutput, pRowInfo, iNbrOfColumns, dMagnify);
 
 	/*
 	 * Get enough space for the row.
 	 * Worst case: three bytes per UTF-8 character
 	 */
-	tSize = 3 * (1 + tColumnWidthTotal + (size_t)iNbrOfColumns + 3);
+	tSize = 3 *
+		(1 + pLayout->tColumnWidthTotal + (size_t)iNbrOfColumns + 3);
 	szLine = xmalloc(tSize);
 
 	do {
@@ -684,7 +752,7 @@ vTableRow2Window(diagram_type *pDiag, output_type *pOutput,
 		pcTxt = szLine;
 		*pcTxt++ = TABLE_SEPARATOR_CHAR;
 		for (iIndex = 0; iIndex < iNbrOfColumns; iIndex++) {
-			tColumnWidthMax = atColumnWidthMax[iIndex];
+			tColumnWidthMax = pLayout->atColumnWidthMax[iIndex];
 			if (aszColTxt[iIndex] == NULL) {
 				/* Add an empty column */
 				for (iTmp = 0;
@@ -697,20 +765,10 @@ vTableRow2Window(diagram_type *pDiag, output_type *pOutput,
 				continue;
 			}
 			/* Compute the length and width of the column text */
-			tLen = tComputeStringLengthMax(
-					aszColTxt[iIndex], tColumnWidthMax);
+			tLen = tWrapColumnText(aszColTxt[iIndex],
+					tColumnWidthMax, &tWidth);
 			NO_DBG_DEC(tLen);
-			while (tLen != 0 &&
-					(aszColTxt[iIndex][tLen - 1] == '\n' ||
-					 aszColTxt[iIndex][tLen - 1] == ' ')) {
-				aszColTxt[iIndex][tLen - 1] = ' ';
-				tLen--;
-			}
-			tWidth = tCountColumns(aszColTxt[iIndex], tLen);
 			fail(tWidth > tColumnWidthMax);
-			tLen = tGetBreakingPoint(aszColTxt[iIndex],
-					tLen, tWidth, tColumnWidthMax);
-			tWidth = tCountColumns(aszColTxt[iIndex], tLen);
 			if (tLen == 0 && *aszColTxt[iIndex] == '\0') {
 				/* No text at all */
 				aszColTxt[iIndex] = NULL;
@@ -77,21 +77,24 @@ vEpilogue(diagram_type *pDiag)
 
 /*
  * vImagePrologue - perform image initialization
+ *
+ * ulFileOffset is the start of the image data, it identifies the image
  */
 void
-vImagePrologue(diagram_type *pDiag, const imagedata_type *pImg)
+vImagePrologue(diagram_type *pDiag, ULONG ulFileOffset,
+	const imagedata_type *pImg)
 {
 	switch (eConversionType) {
 	case conversion_text:
 	case conversion_fmt_text:
 		break;
 	case conversion_ps:
-		vImageProloguePS(pDiag, pImg);
+		vImageProloguePS(pDiag, ulFileOffset, pImg);
 		break;
 	case conversion_xml:
 		break;
 	case conversion_pdf:
-		vImageProloguePDF(pDiag, pImg);
+		vImageProloguePDF(pDiag, ulFileOffset, pImg);
 		break;
 	default:
 		DBG_DEC(eConversionType);
@@ -147,6 +150,33 @@ bAddDummyImage(diagram_type *pDiag, const imagedata_type *pImg)
 	}
 } /* end of bAddDummyImage */
 
+/*
+ * bAddRepeatedImage - add an image that has been translated before
+ *
+ * ulFileOffset is the start of the image data, it identifies the image
+ *
+ * return TRUE when successful, otherwise FALSE
+ */
+BOOL
+bAddRepeatedImage(diagram_type *pDiag, ULONG ulFileOffset,
+	const imagedata_type *pImg)
+{
+	switch (eConversionType) {
+	case conversion_text:
+	case conversion_fmt_text:
+		return FALSE;
+	case conversion_ps:
+		return bAddRepeatedImagePS(pDiag, ulFileOffset, pImg);
+	case conversion_xml:
+		return FALSE;
+	case conversion_pdf:
+		return bAddRepeatedImagePDF(pDiag, ulFileOffset, pImg);
+	default:
+		DBG_DEC(eConversionType);
+		return FALSE;
+	}
+} /* end of bAddRepeatedImage */
+
 /*
  * pCreateDiagram - create and initialize a diagram
  *
@@ -190,14 +220,14 @@ vDestroyDiagram(diagram_type *pDiag)
  * vPrologue2 - call a specific initialization
  */
 void
-vPrologue2(diagram_type *pDiag, int iWordVersion)
+vPrologue2(diagram_type *pDiag, FILE *pFile, int iWordVersion)
 {
 	switch (eConversionType) {
 	case conversion_text:
 	case conversion_fmt_text:
 		break;
 	case conversion_ps:
-		vAddFontsPS(pDiag);
+		vAddFontsPS(pDiag, pFile);
 		break;
 	case conversion_xml:
 		vCreateBookIntro(pDiag, iWordVersion);
@@ -9,13 +9,18 @@
 
 #include <stdarg.h>
 #include <string.h>
+#if defined(HAVE_ZLIB)
+#include <zlib.h>
+#endif /* HAVE_ZLIB */
 #include "version.h"
 #include "antiword.h"
 
 
 /* Constants for the file positions */
 #define INITIAL_LOCATION_SIZE	20
-#define INITIAL_PAGEOBJECT_SIZE	 5
+/* Constants for the page tree */
+#define PAGES_FANOUT		16
+#define MAX_PAGES_LEVELS	 8
 #if defined(DEBUG)
 #define EXTENSION_ARRAY_SIZE	10
 #else
@@ -47,18 +52,60 @@ static int		iSectionIndex = 0;
 static BOOL		bFirstInSection = TRUE;
 /* File positions */
 static long		lFilePosition = 0;
+/* Per object: the file position or the index in its object stream */
 static long		*alLocation = NULL;
+/* Per object: the object stream that contains it, 0 = none */
+static int		*aiObjectStream = NULL;
 static size_t		tLocations = 0;
 static int		iMaxLocationNumber = 0;
 /* File position at the start of a page */
 static long		lStreamStart = -1;
-/* Page objects */
-static int		*aiPageObject = NULL;
+/* Page counter */
 static int		iPageCount = 0;
-static size_t		tMaxPageObjects = 0;
+/* The unfinished Pages nodes of the page tree, one per level */
+static int		aiPagesNode[MAX_PAGES_LEVELS];
+static int		aaiPagesKid[MAX_PAGES_LEVELS][PAGES_FANOUT];
+static int		aiPagesKids[MAX_PAGES_LEVELS];
+static int		aiPagesCount[MAX_PAGES_LEVELS];
+static int		iPagesLevels = 0;
+/* Content stream objects of the current page */
+static int		*aiContentObject = NULL;
+static size_t		tContentObjects = 0;
+static size_t		tMaxContentObjects = 0;
+/* Image objects and the offsets of their data in the Word file */
+static int		*aiImageObject = NULL;
+static ULONG		*aulImageOffset = NULL;
+static size_t		tMaxImageObjects = 0;
+/* Inside the stream of an image object */
+static BOOL		bInImageStream = FALSE;
+/* Compression level of the content streams, 0 = no compression */
+static int		iCompressionLevel = 0;
+#if defined(HAVE_ZLIB)
+/* The maximum number of objects in one object stream */
+#define MAX_STREAM_OBJECTS	100
+/* The size after which no more objects go into an object stream */
+#define MAX_STREAM_BYTES	65536
+/* Use object streams and a cross-reference stream (PDF 1.5) */
+static BOOL		bUseObjectStreams = FALSE;
+/* The objects for the next object stream */
+static BOOL		bInObjectStream = FALSE;
+static UCHAR		*aucObjects = NULL;
+static size_t		tObjectsLength = 0;
+static size_t		tObjectsSize = 0;
+static int		aiStreamObject[MAX_STREAM_OBJECTS];
+static size_t		atStreamOffset[MAX_STREAM_OBJECTS];
+static int		iStreamObjects = 0;
+/* The content stream compressor and its buffers */
+static z_stream		tZStream;
+static BOOL		bCompressing = FALSE;
+static UCHAR		aucZIn[4096];
+static size_t		tZInLength = 0;
+static UCHAR		aucZOut[4096];
+#endif /* HAVE_ZLIB */
 /* Current object number */
 /* 1 = root; 2 = info; 3 = pages; 4 = encoding; 5-16 = fonts; 17 = resources */
-static int		iObjectNumberCurr = 17;
+/* 18 = image names */
+static int		iObjectNumberCurr = 18;
 
 static void		vMoveTo(diagram_type *, long);
 
@@ -158,20 +205,35 @@ tGetFontIndex(drawfile_fontref tFontRef)
 } /* end of tGetFontIndex */
 
 /*
- * vSetLocation - store the location of objects
+ * vStoreLocation - store the location of an object
+ *
+ * iObjectStream is the object stream that contains the object (0 = none),
+ * lLocation is its file position or its index in the object stream
  */
 static void
-vSetLocation(int iLocationNumber)
+vStoreLocation(int iLocationNumber, int iObjectStream, long lLocation)
 {
+	size_t	tOldSize;
+
 	fail(iLocationNumber <= 0);
+	fail(iObjectStream < 0);
 
 	if ((size_t)iLocationNumber >= tLocations) {
-		/* Extend and set to zero */
-		tLocations += EXTENSION_ARRAY_SIZE;
+		/* Double the size and set the extension to zero */
+		tOldSize = tLocations;
+		tLocations *= 2;
+		if ((size_t)iLocationNumber >= tLocations) {
+			tLocations = (size_t)iLocationNumber + 1;
+		}
 		alLocation = xrealloc(alLocation, tLocations * sizeof(long));
-		memset(alLocation + tLocations - EXTENSION_ARRAY_SIZE,
+		memset(alLocation + tOldSize,
+			0,
+			(tLocations - tOldSize) * sizeof(long));
+		aiObjectStream = xrealloc(aiObjectStream,
+					tLocations * sizeof(int));
+		memset(aiObjectStream + tOldSize,
 			0,
-			EXTENSION_ARRAY_SIZE * sizeof(long));
+			(tLocations - tOldSize) * sizeof(int));
 		DBG_DEC(tLocations);
 	}
 	if (iLocationNumber > iMaxLocationNumber) {
@@ -182,41 +244,549 @@ vSetLocation(int iLocationNumber)
 	DBG_DEC_C((size_t)iLocationNumber >= tLocations, tLocations);
 	fail((size_t)iLocationNumber >= tLocations);
 
-	alLocation[iLocationNumber] = lFilePosition;
+	alLocation[iLocationNumber] = lLocation;
+	aiObjectStream[iLocationNumber] = iObjectStream;
+} /* end of vStoreLocation */
+
+/*
+ * vSetLocation - store the location of objects
+ */
+static void
+vSetLocation(int iLocationNumber)
+{
+	vStoreLocation(iLocationNumber, 0, lFilePosition);
 } /* end of vSetLocation */
 
 /*
- * vFillNextPageObject - fil the next page object with the current object number
+ * iGetPagesNode - get the object number of the Pages node at this level
+ *
+ * A new number is reserved when there is no unfinished node yet
+ */
+static int
+iGetPagesNode(int iLevel)
+{
+	fail(iLevel < 0);
+
+	if (iLevel >= MAX_PAGES_LEVELS) {
+		werr(1, "The PDF page tree is too deep");
+	}
+	if (aiPagesNode[iLevel] <= 0) {
+		iObjectNumberCurr++;
+		aiPagesNode[iLevel] = iObjectNumberCurr;
+		aiPagesKids[iLevel] = 0;
+		aiPagesCount[iLevel] = 0;
+		if (iLevel >= iPagesLevels) {
+			iPagesLevels = iLevel + 1;
+		}
+	}
+	return aiPagesNode[iLevel];
+} /* end of iGetPagesNode */
+
+/*
+ * vAddContentObject - add the current object number to the content streams
+ * of the current page
  */
 static void
-vFillNextPageObject(void)
+vAddContentObject(void)
 {
-	iPageCount++;
-	if ((size_t)iPageCount >= tMaxPageObjects) {
+	if (tContentObjects >= tMaxContentObjects) {
 		/* Extend the array */
-		tMaxPageObjects += EXTENSION_ARRAY_SIZE;
-		aiPageObject = xrealloc(aiPageObject,
-					tMaxPageObjects * sizeof(int));
-		DBG_DEC(tMaxPageObjects);
+		tMaxContentObjects += EXTENSION_ARRAY_SIZE;
+		aiContentObject = xrealloc(aiContentObject,
+					tMaxContentObjects * sizeof(int));
+		DBG_DEC(tMaxContentObjects);
+	}
+	aiContentObject[tContentObjects] = iObjectNumberCurr;
+	tContentObjects++;
+} /* end of vAddContentObject */
+
+/*
+ * vFillNextImageObject - fill the current image object with the current
+ * object number
+ */
+static void
+vFillNextImageObject(ULONG ulFileOffset)
+{
+	size_t	tIndex;
+
+	if ((size_t)iImageCount >= tMaxImageObjects) {
+		/* Extend the array, dummy images have no image object */
+		tIndex = tMaxImageObjects;
+		tMaxImageObjects += EXTENSION_ARRAY_SIZE;
+		aiImageObject = xrealloc(aiImageObject,
+					tMaxImageObjects * sizeof(int));
+		aulImageOffset = xrealloc(aulImageOffset,
+					tMaxImageObjects * sizeof(ULONG));
+		DBG_DEC(tMaxImageObjects);
+		for (; tIndex < tMaxImageObjects; tIndex++) {
+			aiImageObject[tIndex] = 0;
+			aulImageOffset[tIndex] = FC_INVALID;
+		}
+	}
+	aiImageObject[iImageCount] = iObjectNumberCurr;
+	aulImageOffset[iImageCount] = ulFileOffset;
+} /* end of vFillNextImageObject */
+
+/*
+ * iFindImageObject - find the image with the given data offset
+ *
+ * returns the number of the image when found, otherwise 0
+ */
+static int
+iFindImageObject(ULONG ulFileOffset)
+{
+	size_t	tIndex;
+
+	for (tIndex = 1; tIndex < tMaxImageObjects; tIndex++) {
+		if (aiImageObject[tIndex] > 0 &&
+		    aulImageOffset[tIndex] == ulFileOffset) {
+			return (int)tIndex;
+		}
+	}
+	return 0;
+} /* end of iFindImageObject */
+
+#if defined(HAVE_ZLIB)
+/*
+ * vDeflate - compress the collected content stream bytes
+ *
+ * iFlush is Z_NO_FLUSH to make room for more, Z_FINISH at the end
+ */
+static void
+vDeflate(FILE *pOutFile, int iFlush)
+{
+	size_t	tLength;
+	int	iResult;
+
+	fail(!bCompressing);
+
+	tZStream.next_in = aucZIn;
+	tZStream.avail_in = (uInt)tZInLength;
+	do {
+		tZStream.next_out = aucZOut;
+		tZStream.avail_out = (uInt)sizeof(aucZOut);
+		iResult = deflate(&tZStream, iFlush);
+		if (iResult == Z_STREAM_ERROR) {
+			werr(1, "Unable to compress the page contents");
+		}
+		tLength = sizeof(aucZOut) - (size_t)tZStream.avail_out;
+		if (tLength != 0) {
+			lFilePosition += (long)fwrite(aucZOut,
+						1, tLength, pOutFile);
+		}
+	} while (tZStream.avail_out == 0);
+	fail(tZStream.avail_in != 0);
+	tZInLength = 0;
+} /* end of vDeflate */
+#endif /* HAVE_ZLIB */
+
+/*
+ * vFPwrite - write bytes and update the fileposition
+ *
+ * Inside a compressed content stream the bytes go to the compressor
+ */
+static void
+vFPwrite(FILE *pOutFile, const char *acBytes, size_t tLength)
+{
+#if defined(HAVE_ZLIB)
+	size_t	tChunk;
+
+	fail(bInObjectStream);
+
+	if (bCompressing) {
+		while (tLength != 0) {
+			if (tZInLength >= sizeof(aucZIn)) {
+				vDeflate(pOutFile, Z_NO_FLUSH);
+			}
+			tChunk = min(tLength, sizeof(aucZIn) - tZInLength);
+			memcpy(aucZIn + tZInLength, acBytes, tChunk);
+			tZInLength += tChunk;
+			acBytes += tChunk;
+			tLength -= tChunk;
+		}
+		return;
+	}
+#endif /* HAVE_ZLIB */
+
+	if (tLength != 0) {
+		lFilePosition += (long)fwrite(acBytes, 1, tLength, pOutFile);
 	}
-	aiPageObject[iPageCount] = iObjectNumberCurr;
-} /* end of vFillNextPageObject */
+} /* end of vFPwrite */
 
 /*
  * vFPprintf - printf and update the fileposition
  *
  * called with arguments like fprintf(3)
+ * Inside a compressed content stream the output goes to the compressor,
+ * the strings from the document can make the output of any length
  */
 static void
 vFPprintf(FILE *pOutFile, const char *szFormat, ...)
 {
 	va_list	tArg;
+#if defined(HAVE_ZLIB)
+	char	*szLine;
+	int	iLength;
+
+	if (bInObjectStream) {
+		if (aucObjects == NULL) {
+			tObjectsSize = 4096;
+			aucObjects = xmalloc(tObjectsSize);
+		}
+		va_start(tArg, szFormat);
+		iLength = vsnprintf((char *)aucObjects + tObjectsLength,
+				tObjectsSize - tObjectsLength, szFormat, tArg);
+		va_end(tArg);
+		if (iLength < 0) {
+			DBG_DEC(iLength);
+			return;
+		}
+		if ((size_t)iLength >= tObjectsSize - tObjectsLength) {
+			/* It did not fit, extend the buffer and try again */
+			tObjectsSize = tObjectsLength + (size_t)iLength + 1;
+			tObjectsSize = (tObjectsSize + 4095) & ~(size_t)4095;
+			aucObjects = xrealloc(aucObjects, tObjectsSize);
+			va_start(tArg, szFormat);
+			iLength = vsnprintf((char *)aucObjects + tObjectsLength,
+				tObjectsSize - tObjectsLength, szFormat, tArg);
+			va_end(tArg);
+			fail(iLength < 0);
+		}
+		tObjectsLength += (size_t)iLength;
+		return;
+	}
+	if (bCompressing) {
+		va_start(tArg, szFormat);
+		iLength = vsnprintf((char *)aucZIn + tZInLength,
+				sizeof(aucZIn) - tZInLength, szFormat, tArg);
+		va_end(tArg);
+		if (iLength < 0) {
+			DBG_DEC(iLength);
+			return;
+		}
+		if ((size_t)iLength < sizeof(aucZIn) - tZInLength) {
+			tZInLength += (size_t)iLength;
+			return;
+		}
+		/* It did not fit, make room and try again */
+		vDeflate(pOutFile, Z_NO_FLUSH);
+		fail(tZInLength != 0);
+		if ((size_t)iLength < sizeof(aucZIn)) {
+			va_start(tArg, szFormat);
+			iLength = vsnprintf((char *)aucZIn, sizeof(aucZIn),
+					szFormat, tArg);
+			va_end(tArg);
+			fail(iLength < 0 || (size_t)iLength >= sizeof(aucZIn));
+			tZInLength = (size_t)iLength;
+			return;
+		}
+		/* Longer than the buffer: use a buffer of its own */
+		szLine = xmalloc((size_t)iLength + 1);
+		va_start(tArg, szFormat);
+		iLength = vsnprintf(szLine, (size_t)iLength + 1, szFormat, tArg);
+		va_end(tArg);
+		vFPwrite(pOutFile, szLine, (size_t)iLength);
+		szLine = xfree(szLine);
+		return;
+	}
+#endif /* HAVE_ZLIB */
 
 	va_start(tArg, szFormat);
 	lFilePosition += vfprintf(pOutFile, szFormat, tArg);
 	va_end(tArg);
 } /* end of vFPprintf */
 
+/*
+ * bCompressContent - are the content streams compressed?
+ */
+static BOOL
+bCompressContent(void)
+{
+#if defined(HAVE_ZLIB)
+	return iCompressionLevel > 0;
+#else
+	return FALSE;
+#endif /* HAVE_ZLIB */
+} /* end of bCompressContent */
+
+/*
+ * vStartCompression - send the rest of the content stream to the compressor
+ */
+static void
+vStartCompression(void)
+{
+#if defined(HAVE_ZLIB)
+	if (iCompressionLevel <= 0) {
+		return;
+	}
+	(void)memset(&tZStream, 0, sizeof(tZStream));
+	tZStream.zalloc = Z_NULL;
+	tZStream.zfree = Z_NULL;
+	tZStream.opaque = Z_NULL;
+	if (deflateInit(&tZStream, iCompressionLevel) != Z_OK) {
+		werr(1, "Unable to initialize the compression");
+	}
+	tZInLength = 0;
+	bCompressing = TRUE;
+#endif /* HAVE_ZLIB */
+} /* end of vStartCompression */
+
+/*
+ * vStopCompression - flush the compressor and write to the file again
+ */
+static void
+vStopCompression(FILE *pOutFile)
+{
+#if defined(HAVE_ZLIB)
+	if (!bCompressing) {
+		return;
+	}
+	vDeflate(pOutFile, Z_FINISH);
+	(void)deflateEnd(&tZStream);
+	bCompressing = FALSE;
+#endif /* HAVE_ZLIB */
+} /* end of vStopCompression */
+
+#if defined(HAVE_ZLIB)
+/*
+ * vWriteDeflatedStream - write a stream object with deflated data
+ *
+ * szDictionary holds the extra entries of the stream dictionary
+ */
+static void
+vWriteDeflatedStream(FILE *pOutFile, int iObjectNumber,
+	const char *szDictionary, const UCHAR *aucData, size_t tLength)
+{
+	UCHAR	*aucDeflated;
+	uLongf	ulDeflated;
+
+	ulDeflated = compressBound((uLong)tLength);
+	aucDeflated = xmalloc((size_t)ulDeflated);
+	if (compress2(aucDeflated, &ulDeflated,
+			aucData, (uLong)tLength, iCompressionLevel) != Z_OK) {
+		werr(1, "Unable to compress a PDF stream");
+	}
+
+	vSetLocation(iObjectNumber);
+	vFPprintf(pOutFile, "%d 0 obj\n", iObjectNumber);
+	vFPprintf(pOutFile, "<<\n");
+	vFPprintf(pOutFile, "%s", szDictionary);
+	vFPprintf(pOutFile, "/Length %lu\n", (ULONG)ulDeflated);
+	vFPprintf(pOutFile, "/Filter /FlateDecode\n");
+	vFPprintf(pOutFile, ">>\n");
+	vFPprintf(pOutFile, "stream\n");
+	lFilePosition += (long)fwrite(aucDeflated,
+				1, (size_t)ulDeflated, pOutFile);
+	vFPprintf(pOutFile, "\nendstream\n");
+	vFPprintf(pOutFile, "endobj\n");
+
+	aucDeflated = xfree(aucDeflated);
+} /* end of vWriteDeflatedStream */
+
+/*
+ * vFlushObjectStream - write the collected objects as one object stream
+ */
+static void
+vFlushObjectStream(FILE *pOutFile)
+{
+	UCHAR	*aucData;
+	size_t	tFirst;
+	int	iIndex;
+	char	szDictionary[60];
+	char	szHeader[MAX_STREAM_OBJECTS * 24];
+
+	fail(bInObjectStream);
+
+	if (iStreamObjects <= 0) {
+		return;
+	}
+
+	/* The header: pairs of object numbers and offsets */
+	tFirst = 0;
+	for (iIndex = 0; iIndex < iStreamObjects; iIndex++) {
+		tFirst += (size_t)sprintf(szHeader + tFirst, "%d %lu ",
+				aiStreamObject[iIndex],
+				(ULONG)atStreamOffset[iIndex]);
+	}
+	fail(tFirst >= sizeof(szHeader));
+	aucData = xmalloc(tFirst + tObjectsLength);
+	(void)memcpy(aucData, szHeader, tFirst);
+	(void)memcpy(aucData + tFirst, aucObjects, tObjectsLength);
+
+	iObjectNumberCurr++;
+	(void)sprintf(szDictionary, "/Type /ObjStm\n/N %d\n/First %lu\n",
+			iStreamObjects, (ULONG)tFirst);
+	vWriteDeflatedStream(pOutFile, iObjectNumberCurr, szDictionary,
+			aucData, tFirst + tObjectsLength);
+	aucData = xfree(aucData);
+
+	for (iIndex = 0; iIndex < iStreamObjects; iIndex++) {
+		vStoreLocation(aiStreamObject[iIndex],
+				iObjectNumberCurr, (long)iIndex);
+	}
+	iStreamObjects = 0;
+	tObjectsLength = 0;
+} /* end of vFlushObjectStream */
+
+/*
+ * vAddXrefStream - add the cross-reference stream and the trailer
+ */
+static void
+vAddXrefStream(FILE *pOutFile)
+{
+	UCHAR	*aucData, *pucEntry;
+	long	lXref, lField2, lField3;
+	int	iIndex, iXref, iType;
+	char	szDictionary[120];
+
+	vFlushObjectStream(pOutFile);
+
+	iObjectNumberCurr++;
+	iXref = iObjectNumberCurr;
+	/* The xref stream describes itself too */
+	vSetLocation(iXref);
+	lXref = lFilePosition;
+
+	/* Entries of 7 bytes: type, offset or stream, generation or index */
+	aucData = xmalloc((size_t)(iMaxLocationNumber + 1) * 7);
+	for (iIndex = 0; iIndex <= iMaxLocationNumber; iIndex++) {
+		if (iIndex == 0) {
+			/* The head of the free list */
+			iType = 0;
+			lField2 = 0;
+			lField3 = 0xffff;
+		} else if (aiObjectStream[iIndex] == 0) {
+			iType = 1;
+			lField2 = alLocation[iIndex];
+			lField3 = 0;
+		} else {
+			iType = 2;
+			lField2 = (long)aiObjectStream[iIndex];
+			lField3 = alLocation[iIndex];
+		}
+		pucEntry = aucData + iIndex * 7;
+		pucEntry[0] = (UCHAR)iType;
+		pucEntry[1] = (UCHAR)((lField2 >> 24) & 0xff);
+		pucEntry[2] = (UCHAR)((lField2 >> 16) & 0xff);
+		pucEntry[3] = (UCHAR)((lField2 >> 8) & 0xff);
+		pucEntry[4] = (UCHAR)(lField2 & 0xff);
+		pucEntry[5] = (UCHAR)((lField3 >> 8) & 0xff);
+		pucEntry[6] = (UCHAR)(lField3 & 0xff);
+	}
+
+	(void)sprintf(szDictionary,
+		"/Type /XRef\n/Size %d\n/W [ 1 4 2 ]\n"
+		"/Root 1 0 R\n/Info 2 0 R\n",
+		iMaxLocationNumber + 1);
+	vWriteDeflatedStream(pOutFile, iXref, szDictionary,
+			aucData, (size_t)(iMaxLocationNumber + 1) * 7);
+	aucData = xfree(aucData);
+
+	vFPprintf(pOutFile, "startxref\n");
+	vFPprintf(pOutFile, "%ld\n", lXref);
+	vFPprintf(pOutFile, "%%%%EOF\n");
+} /* end of vAddXrefStream */
+#endif /* HAVE_ZLIB */
+
+/*
+ * vStartObject - start a new object that is not a stream
+ */
+static void
+vStartObject(FILE *pOutFile, int iObjectNumber)
+{
+#if defined(HAVE_ZLIB)
+	if (bUseObjectStreams) {
+		/* Collect the object for the next object stream */
+		fail(bCompressing || bInObjectStream);
+		if (iStreamObjects >= MAX_STREAM_OBJECTS ||
+		    tObjectsLength >= MAX_STREAM_BYTES) {
+			/* No room for this object, start a new stream */
+			vFlushObjectStream(pOutFile);
+		}
+		aiStreamObject[iStreamObjects] = iObjectNumber;
+		atStreamOffset[iStreamObjects] = tObjectsLength;
+		iStreamObjects++;
+		bInObjectStream = TRUE;
+		return;
+	}
+#endif /* HAVE_ZLIB */
+	vSetLocation(iObjectNumber);
+	vFPprintf(pOutFile, "%d 0 obj\n", iObjectNumber);
+} /* end of vStartObject */
+
+/*
+ * vEndObject - end the current object that is not a stream
+ */
+static void
+vEndObject(FILE *pOutFile)
+{
+#if defined(HAVE_ZLIB)
+	if (bInObjectStream) {
+		bInObjectStream = FALSE;
+		if (iStreamObjects >= MAX_STREAM_OBJECTS ||
+		    tObjectsLength >= MAX_STREAM_BYTES) {
+			vFlushObjectStream(pOutFile);
+		}
+		return;
+	}
+#endif /* HAVE_ZLIB */
+	vFPprintf(pOutFile, "endobj\n");
+} /* end of vEndObject */
+
+/*
+ * vWritePagesNode - write the unfinished Pages node at this level
+ */
+static void
+vWritePagesNode(FILE *pOutFile, int iLevel, int iParent)
+{
+	int	iIndex;
+
+	fail(iLevel < 0 || iLevel >= iPagesLevels);
+	fail(aiPagesNode[iLevel] <= 0);
+
+	vStartObject(pOutFile, aiPagesNode[iLevel]);
+	vFPprintf(pOutFile, "<<\n");
+	vFPprintf(pOutFile, "/Type /Pages\n");
+	vFPprintf(pOutFile, "/Parent %d 0 R\n", iParent);
+	vFPprintf(pOutFile, "/Count %d\n", aiPagesCount[iLevel]);
+	vFPprintf(pOutFile, "/Kids [");
+	for (iIndex = 0; iIndex < aiPagesKids[iLevel]; iIndex++) {
+		vFPprintf(pOutFile, " %d 0 R", aaiPagesKid[iLevel][iIndex]);
+	}
+	vFPprintf(pOutFile, " ]\n");
+	vFPprintf(pOutFile, ">>\n");
+	vEndObject(pOutFile);
+
+	aiPagesNode[iLevel] = 0;
+	aiPagesKids[iLevel] = 0;
+	aiPagesCount[iLevel] = 0;
+} /* end of vWritePagesNode */
+
+/*
+ * vAddPagesKid - add a kid to the Pages node at this level
+ *
+ * A full node is written at once and added to the level above
+ */
+static void
+vAddPagesKid(FILE *pOutFile, int iLevel, int iKid, int iPages)
+{
+	int	iNode, iParent, iCount;
+
+	iNode = iGetPagesNode(iLevel);
+	fail(aiPagesKids[iLevel] >= PAGES_FANOUT);
+	aaiPagesKid[iLevel][aiPagesKids[iLevel]] = iKid;
+	aiPagesKids[iLevel]++;
+	aiPagesCount[iLevel] += iPages;
+
+	if (aiPagesKids[iLevel] < PAGES_FANOUT) {
+		return;
+	}
+	iParent = iGetPagesNode(iLevel + 1);
+	iCount = aiPagesCount[iLevel];
+	vWritePagesNode(pOutFile, iLevel, iParent);
+	vAddPagesKid(pOutFile, iLevel + 1, iNode, iCount);
+} /* end of vAddPagesKid */
+
 /*
  * vCreateInfoDictionary - create the document information dictionary
  */
@@ -252,6 +822,7 @@ vCreateInfoDictionary(diagram_type *pDiag, int iWordVersion)
 
 	pOutFile = pDiag->pOutFile;
 
+	/* Not in an object stream, because the strings can be of any length */
 	vSetLocation(2);
 	vFPprintf(pOutFile, "2 0 obj\n");
 	vFPprintf(pOutFile, "<<\n");
@@ -435,13 +1006,64 @@ vAddFooter(diagram_type *pDiag)
 	bInFtrSpace = FALSE;
 } /* end of vAddFooter */
 
+/*
+ * vStartContentStream - start a new content stream of the current page
+ */
+static void
+vStartContentStream(FILE *pOutFile)
+{
+	iObjectNumberCurr++;
+	vSetLocation(iObjectNumberCurr);
+	vAddContentObject();
+	vFPprintf(pOutFile, "%d 0 obj\n", iObjectNumberCurr);
+	vFPprintf(pOutFile, "<<\n");
+	vFPprintf(pOutFile, "/Length %d 0 R\n", iObjectNumberCurr + 1);
+	if (bCompressContent()) {
+		vFPprintf(pOutFile, "/Filter /FlateDecode\n");
+	}
+	vFPprintf(pOutFile, ">>\n");
+	vFPprintf(pOutFile, "stream\n");
+	lStreamStart = lFilePosition;
+	vStartCompression();
+	vFPprintf(pOutFile, "BT\n");
+} /* end of vStartContentStream */
+
+/*
+ * vEndContentStream - end the current content stream
+ *
+ * The caller must have ended the text object
+ */
+static void
+vEndContentStream(FILE *pOutFile)
+{
+	long	lStreamEnd;
+
+	fail(lStreamStart < 0);
+
+	vStopCompression(pOutFile);
+	lStreamEnd = lFilePosition;
+	if (bCompressContent()) {
+		/* End of line between the compressed data and endstream */
+		vFPprintf(pOutFile, "\n");
+	}
+	vFPprintf(pOutFile, "endstream\n");
+	vFPprintf(pOutFile, "endobj\n");
+
+	iObjectNumberCurr++;
+	vStartObject(pOutFile, iObjectNumberCurr);
+	vFPprintf(pOutFile, "%lu\n", lStreamEnd - lStreamStart);
+	vEndObject(pOutFile);
+	lStreamStart = -1;
+} /* end of vEndContentStream */
+
 /*
  * vEndPageObject - end the current page object
  */
 static void
 vEndPageObject(FILE *pOutFile)
 {
-	long	lStreamEnd;
+	size_t	tIndex;
+	int	iParent, iPage;
 
 	if (lStreamStart < 0) {
 		/* There is no current page object */
@@ -449,15 +1071,32 @@ vEndPageObject(FILE *pOutFile)
 	}
 
 	vFPprintf(pOutFile, "ET\n");
-	lStreamEnd = lFilePosition;
-	vFPprintf(pOutFile, "endstream\n");
-	vFPprintf(pOutFile, "endobj\n");
+	vEndContentStream(pOutFile);
 
+	/* The page object refers to all its content streams */
+	iParent = iGetPagesNode(0);
 	iObjectNumberCurr++;
-	vSetLocation(iObjectNumberCurr);
-	vFPprintf(pOutFile, "%d 0 obj\n", iObjectNumberCurr);
-	vFPprintf(pOutFile, "%lu\n", lStreamEnd - lStreamStart);
-	vFPprintf(pOutFile, "endobj\n");
+	iPage = iObjectNumberCurr;
+	vStartObject(pOutFile, iPage);
+	vFPprintf(pOutFile, "<<\n");
+	vFPprintf(pOutFile, "/Type /Page\n");
+	vFPprintf(pOutFile, "/Parent %d 0 R\n", iParent);
+	vFPprintf(pOutFile, "/Resources 17 0 R\n");
+	fail(tContentObjects == 0);
+	if (tContentObjects == 1) {
+		vFPprintf(pOutFile, "/Contents %d 0 R\n", aiContentObject[0]);
+	} else {
+		vFPprintf(pOutFile, "/Contents [");
+		for (tIndex = 0; tIndex < tContentObjects; tIndex++) {
+			vFPprintf(pOutFile, " %d 0 R", aiContentObject[tIndex]);
+		}
+		vFPprintf(pOutFile, " ]\n");
+	}
+	vFPprintf(pOutFile, ">>\n");
+	vEndObject(pOutFile);
+	tContentObjects = 0;
+
+	vAddPagesKid(pOutFile, 0, iPage, 1);
 } /* end of vEndPageObject */
 
 /*
@@ -481,29 +1120,9 @@ vMove2NextPage(diagram_type *pDiag, BOOL bNewSection)
 		bFirstInSection = TRUE;
 	}
 
-	/* Start the new page object */
-	iObjectNumberCurr++;
-	vSetLocation(iObjectNumberCurr);
-	vFillNextPageObject();
-	vFPprintf(pOutFile, "%d 0 obj\n", iObjectNumberCurr);
-	vFPprintf(pOutFile, "<<\n");
-	vFPprintf(pOutFile, "/Type /Page\n");
-	vFPprintf(pOutFile, "/Parent 3 0 R\n");
-	vFPprintf(pOutFile, "/Resources 17 0 R\n");
-	vFPprintf(pOutFile, "/Contents %d 0 R\n", iObjectNumberCurr + 1);
-	vFPprintf(pOutFile, ">>\n");
-	vFPprintf(pOutFile, "endobj\n");
-
-	/* Start the new text object */
-	iObjectNumberCurr++;
-	vSetLocation(iObjectNumberCurr);
-	vFPprintf(pOutFile, "%d 0 obj\n", iObjectNumberCurr);
-	vFPprintf(pOutFile, "<<\n");
-	vFPprintf(pOutFile, "/Length %d 0 R\n", iObjectNumberCurr + 1);
-	vFPprintf(pOutFile, ">>\n");
-	vFPprintf(pOutFile, "stream\n");
-	lStreamStart = lFilePosition;
-	vFPprintf(pOutFile, "BT\n");
+	/* Start the new page, the page object follows at its end */
+	iPageCount++;
+	vStartContentStream(pOutFile);
 
 	/* Set variables to their start of page values */
 	pDiag->lYtop = lPageHeight - PS_TOP_MARGIN;
@@ -560,14 +1179,34 @@ vProloguePDF(diagram_type *pDiag,
 	pOutFile = pDiag->pOutFile;
 
 	eEncoding = pOptions->eEncoding;
+	iCompressionLevel = pOptions->iCompressionLevel;
+#if defined(HAVE_ZLIB)
+	/* Compressed output is PDF 1.5 with object streams */
+	bUseObjectStreams = iCompressionLevel > 0;
+	bInObjectStream = FALSE;
+	tObjectsLength = 0;
+	iStreamObjects = 0;
+#else
+	DBG_DEC_C(iCompressionLevel != 0, iCompressionLevel);
+	iCompressionLevel = 0;
+#endif /* HAVE_ZLIB */
 
 	/* Create an empty location array */
 	tLocations = INITIAL_LOCATION_SIZE;
 	alLocation = xcalloc(tLocations, sizeof(long));
+	aiObjectStream = xcalloc(tLocations, sizeof(int));
+
+	/* Start an empty page tree */
+	(void)memset(aiPagesNode, 0, sizeof(aiPagesNode));
+	(void)memset(aiPagesKids, 0, sizeof(aiPagesKids));
+	(void)memset(aiPagesCount, 0, sizeof(aiPagesCount));
+	iPagesLevels = 0;
 
-	/* Create an empty pageobject array */
-	tMaxPageObjects = INITIAL_PAGEOBJECT_SIZE;
-	aiPageObject = xcalloc(tMaxPageObjects, sizeof(int));
+	/* No content streams and no images yet */
+	tContentObjects = 0;
+	tMaxContentObjects = 0;
+	tMaxImageObjects = 0;
+	bInImageStream = FALSE;
 
 	if (pOptions->iPageHeight == INT_MAX) {
 		lPageHeight = LONG_MAX;
@@ -595,25 +1234,42 @@ vProloguePDF(diagram_type *pDiag,
 	lFilePosition = 0;
 	iMaxLocationNumber = 0;
 	lStreamStart = -1;
-	iObjectNumberCurr = 17;
+	iObjectNumberCurr = 18;
 	pDiag->lXleft = 0;
 	pDiag->lYtop = 0;
 
 	szProducer = szTask;
 
-	vFPprintf(pOutFile, "%%PDF-1.3\n");
+	vFPprintf(pOutFile, "%%PDF-1.%d\n", bCompressContent() ? 5 : 3);
 	vFPprintf(pOutFile, "%%%c%c%c%c\n", 0xe2, 0xe3, 0xcf, 0xd3);
 
 	/* Root catalog */
-	vSetLocation(1);
-	vFPprintf(pOutFile, "1 0 obj\n");
+	vStartObject(pOutFile, 1);
 	vFPprintf(pOutFile, "<<\n");
 	vFPprintf(pOutFile, "/Type /Catalog\n");
 	vFPprintf(pOutFile, "/Pages 3 0 R\n");
 	vFPprintf(pOutFile, ">>\n");
-	vFPprintf(pOutFile, "endobj\n");
+	vEndObject(pOutFile);
 } /* end of vProloguePDF */
 
+/*
+ * vFreePDF - free the memory of the PDF output
+ */
+static void
+vFreePDF(void)
+{
+	szProducer = NULL;
+	aiContentObject = xfree(aiContentObject);
+	aiImageObject = xfree(aiImageObject);
+	aulImageOffset = xfree(aulImageOffset);
+	alLocation = xfree(alLocation);
+	aiObjectStream = xfree(aiObjectStream);
+#if defined(HAVE_ZLIB)
+	aucObjects = xfree(aucObjects);
+	tObjectsSize = 0;
+#endif /* HAVE_ZLIB */
+} /* end of vFreePDF */
+
 /*
  * vEpiloguePDF - clean up after everything is done
  */
@@ -622,7 +1278,7 @@ vEpiloguePDF(diagram_type *pDiag)
 {
 	FILE	*pOutFile;
 	long	lXref;
-	int	iIndex;
+	int	iIndex, iLevel, iNode, iParent, iCount, iTop;
 
 	fail(pDiag == NULL);
 	fail(pDiag->pOutFile == NULL);
@@ -633,21 +1289,60 @@ vEpiloguePDF(diagram_type *pDiag)
 	/* End the old page object */
 	vEndPageObject(pOutFile);
 
-	vSetLocation(3);
-	vFPprintf(pOutFile, "3 0 obj\n");
+	/* The names of the images */
+	vStartObject(pOutFile, 18);
+	vFPprintf(pOutFile, "<<\n");
+	for (iIndex = 1; (size_t)iIndex < tMaxImageObjects; iIndex++) {
+		if (aiImageObject[iIndex] > 0) {
+			vFPprintf(pOutFile, "/Im%d %d 0 R\n",
+					iIndex, aiImageObject[iIndex]);
+		}
+	}
+	vFPprintf(pOutFile, ">>\n");
+	vEndObject(pOutFile);
+
+	/* Write the unfinished Pages nodes, from the leaves up */
+	iTop = 0;
+	for (iLevel = 0; iLevel < iPagesLevels; iLevel++) {
+		if (aiPagesKids[iLevel] <= 0) {
+			continue;
+		}
+		iNode = aiPagesNode[iLevel];
+		if (iLevel + 1 >= iPagesLevels) {
+			/* The top of the tree is the only kid of the root */
+			iTop = iNode;
+			vWritePagesNode(pOutFile, iLevel, 3);
+			break;
+		}
+		iCount = aiPagesCount[iLevel];
+		iParent = iGetPagesNode(iLevel + 1);
+		vWritePagesNode(pOutFile, iLevel, iParent);
+		vAddPagesKid(pOutFile, iLevel + 1, iNode, iCount);
+	}
+
+	/* The root of the page tree */
+	vStartObject(pOutFile, 3);
 	vFPprintf(pOutFile, "<<\n");
 	vFPprintf(pOutFile, "/Type /Pages\n");
 	vFPprintf(pOutFile, "/Count %d\n", iPageCount);
 	vFPprintf(pOutFile, "/MediaBox [ 0 0 %.0f %.0f ]\n",
 			dDrawUnits2Points(lPageWidth),
 			dDrawUnits2Points(lPageHeight));
-	vFPprintf(pOutFile, "/Kids [ ");
-	for (iIndex = 1; iIndex <= iPageCount; iIndex++) {
-		vFPprintf(pOutFile, "\t%d 0 R\n", aiPageObject[iIndex]);
+	if (iTop > 0) {
+		vFPprintf(pOutFile, "/Kids [ %d 0 R ]\n", iTop);
+	} else {
+		vFPprintf(pOutFile, "/Kids [ ]\n");
 	}
-	vFPprintf(pOutFile, "]\n");
 	vFPprintf(pOutFile, ">>\n");
-	vFPprintf(pOutFile, "endobj\n");
+	vEndObject(pOutFile);
+
+#if defined(HAVE_ZLIB)
+	if (bUseObjectStreams) {
+		vAddXrefStream(pOutFile);
+		vFreePDF();
+		return;
+	}
+#endif /* HAVE_ZLIB */
 
 	lXref = lFilePosition;
 
@@ -669,9 +1364,7 @@ vEpiloguePDF(diagram_type *pDiag)
 	vFPprintf(pOutFile, "%ld\n", lXref);
 	vFPprintf(pOutFile, "%%%%EOF\n");
 
-	szProducer = NULL;
-	aiPageObject = xfree(aiPageObject);
-	alLocation = xfree(alLocation);
+	vFreePDF();
 } /* end of vEpiloguePDF */
 
 /*
@@ -709,23 +1402,13 @@ vPrintPalette(FILE *pOutFile, const imagedata_type *pImg)
 } /* end of vPrintPalette */
 
 /*
- * vImageProloguePDF - perform the image initialization
+ * vPlaceImage - draw the given image object on the current page
  */
-void
-vImageProloguePDF(diagram_type *pDiag, const imagedata_type *pImg)
+static void
+vPlaceImage(diagram_type *pDiag, const imagedata_type *pImg, int iImage)
 {
 	FILE	*pOutFile;
 
-	fail(pDiag == NULL);
-	fail(pDiag->pOutFile == NULL);
-	fail(pImg == NULL);
-
-	if (pImg->iVerSizeScaled <= 0 || pImg->iHorSizeScaled <= 0) {
-		return;
-	}
-
-	iImageCount++;
-
 	DBG_DEC_C(pDiag->lXleft != 0, pDiag->lXleft);
 
 	pDiag->lYtop -= lPoints2DrawUnits(pImg->iVerSizeScaled);
@@ -748,7 +1431,45 @@ vImageProloguePDF(diagram_type *pDiag, const imagedata_type *pImg)
 			dDrawUnits2Points(pDiag->lXleft + PS_LEFT_MARGIN),
 			dDrawUnits2Points(pDiag->lYtop));
 	}
-	vFPprintf(pOutFile, "BI\n");
+	vFPprintf(pOutFile, "/Im%d Do\n", iImage);
+	vFPprintf(pOutFile, "Q\n");
+} /* end of vPlaceImage */
+
+/*
+ * vImageProloguePDF - perform the image initialization
+ *
+ * ulFileOffset is the start of the image data, it identifies the image
+ */
+void
+vImageProloguePDF(diagram_type *pDiag, ULONG ulFileOffset,
+	const imagedata_type *pImg)
+{
+	FILE	*pOutFile;
+
+	fail(pDiag == NULL);
+	fail(pDiag->pOutFile == NULL);
+	fail(pImg == NULL);
+
+	if (pImg->iVerSizeScaled <= 0 || pImg->iHorSizeScaled <= 0) {
+		return;
+	}
+
+	iImageCount++;
+
+	vPlaceImage(pDiag, pImg, iImageCount);
+
+	pOutFile = pDiag->pOutFile;
+
+	vEndContentStream(pOutFile);
+
+	/* The image itself is a separate object with binary data */
+	iObjectNumberCurr++;
+	vSetLocation(iObjectNumberCurr);
+	vFillNextImageObject(ulFileOffset);
+	vFPprintf(pOutFile, "%d 0 obj\n", iObjectNumberCurr);
+	vFPprintf(pOutFile, "<<\n");
+	vFPprintf(pOutFile, "\t/Type /XObject\n");
+	vFPprintf(pOutFile, "\t/Subtype /Image\n");
 	vFPprintf(pOutFile, "\t/Width %d\n", pImg->iWidth);
 	vFPprintf(pOutFile, "\t/Height %d\n", pImg->iHeight);
 	switch (pImg->eImageType) {
@@ -776,8 +1497,7 @@ vImageProloguePDF(diagram_type *pDiag, const imagedata_type *pImg)
 			break;
 		}
 		vFPprintf(pOutFile, "\t/BitsPerComponent 8\n");
-		vFPprintf(pOutFile,
-			"\t/Filter [ /ASCII85Decode /DCTDecode ]\n");
+		vFPprintf(pOutFile, "\t/Filter /DCTDecode\n");
 		break;
 	case imagetype_is_png:
 		if (pImg->iComponents == 3 || pImg->iComponents == 4) {
@@ -792,15 +1512,14 @@ vImageProloguePDF(diagram_type *pDiag, const imagedata_type *pImg)
 			vFPprintf(pOutFile, "\t/ColorSpace /DeviceGray\n");
 			vFPprintf(pOutFile, "\t/BitsPerComponent 8\n");
 		}
-		vFPprintf(pOutFile,
-			"\t/Filter [ /ASCII85Decode /FlateDecode ]\n");
-		vFPprintf(pOutFile, "\t/DecodeParms [ null <<\n");
+		vFPprintf(pOutFile, "\t/Filter /FlateDecode\n");
+		vFPprintf(pOutFile, "\t/DecodeParms <<\n");
 		vFPprintf(pOutFile, "\t\t/Predictor 10\n");
 		vFPprintf(pOutFile, "\t\t/Colors %d\n", pImg->iComponents);
 		vFPprintf(pOutFile, "\t\t/BitsPerComponent %u\n",
 						pImg->uiBitsPerComponent);
 		vFPprintf(pOutFile, "\t\t/Columns %d\n", pImg->iWidth);
-		vFPprintf(pOutFile, "\t\t>> ]\n");
+		vFPprintf(pOutFile, "\t\t>>\n");
 		break;
 	case imagetype_is_dib:
 		if (pImg->uiBitsPerComponent <= 8) {
@@ -809,16 +1528,20 @@ vImageProloguePDF(diagram_type *pDiag, const imagedata_type *pImg)
 			vFPprintf(pOutFile, "\t/ColorSpace /DeviceRGB\n");
 		}
 		vFPprintf(pOutFile, "\t/BitsPerComponent 8\n");
-		vFPprintf(pOutFile, "\t/Filter /ASCII85Decode\n");
 		break;
 	default:
 		vFPprintf(pOutFile, "\t/ColorSpace /Device%s\n",
 			pImg->bColorImage ? "RGB" : "Gray");
 		vFPprintf(pOutFile, "\t/BitsPerComponent 8\n");
-		vFPprintf(pOutFile, "\t/Filter /ASCIIHexDecode\n");
 		break;
 	}
-	vFPprintf(pOutFile, "ID\n");
+	vFPprintf(pOutFile, "\t/Length %d 0 R\n", iObjectNumberCurr + 1);
+	vFPprintf(pOutFile, ">>\n");
+	vFPprintf(pOutFile, "stream\n");
+
+	/* The image data will be written without any encoding */
+	vASCII85SetBinary(TRUE);
+	bInImageStream = TRUE;
 } /* end of vImageProloguePDF */
 
 /*
@@ -828,20 +1551,37 @@ void
 vImageEpiloguePDF(diagram_type *pDiag)
 {
 	FILE	*pOutFile;
+	long	lImageLength;
 
 	fail(pDiag == NULL);
 	fail(pDiag->pOutFile == NULL);
 
+	pDiag->lXleft = 0;
+
+	if (!bInImageStream) {
+		/* The image prologue has not started an image object */
+		return;
+	}
+
 	pOutFile = pDiag->pOutFile;
 
 	/* Correction for the image bytes */
-	lFilePosition = ftell(pOutFile);
+	lImageLength = (long)tGetASCII85Length();
+	lFilePosition += lImageLength;
 
-	vFPprintf(pOutFile, "EI\n");
-	vFPprintf(pOutFile, "Q\n");
-	vFPprintf(pOutFile, "BT\n");
+	vFPprintf(pOutFile, "\nendstream\n");
+	vFPprintf(pOutFile, "endobj\n");
 
-	pDiag->lXleft = 0;
+	iObjectNumberCurr++;
+	vStartObject(pOutFile, iObjectNumberCurr);
+	vFPprintf(pOutFile, "%ld\n", lImageLength);
+	vEndObject(pOutFile);
+
+	vASCII85SetBinary(FALSE);
+	bInImageStream = FALSE;
+
+	/* Continue the current page in a new content stream */
+	vStartContentStream(pOutFile);
 } /* end of vImageEpiloguePDF */
 
 /*
@@ -889,6 +1629,43 @@ bAddDummyImagePDF(diagram_type *pDiag, const imagedata_type *pImg)
 	return TRUE;
 } /* end of bAddDummyImagePDF */
 
+/*
+ * bAddRepeatedImagePDF - add an image that has been translated before
+ *
+ * The existing image object is used again
+ *
+ * return TRUE when successful, otherwise FALSE
+ */
+BOOL
+bAddRepeatedImagePDF(diagram_type *pDiag, ULONG ulFileOffset,
+	const imagedata_type *pImg)
+{
+	int	iImage;
+
+	fail(pDiag == NULL);
+	fail(pDiag->pOutFile == NULL);
+	fail(pImg == NULL);
+
+	if (pImg->iVerSizeScaled <= 0 || pImg->iHorSizeScaled <= 0) {
+		return FALSE;
+	}
+
+	iImage = iFindImageObject(ulFileOffset);
+	if (iImage <= 0) {
+		return FALSE;
+	}
+	DBG_DEC(iImage);
+
+	iImageCount++;
+
+	vPlaceImage(pDiag, pImg, iImage);
+	vFPprintf(pDiag->pOutFile, "BT\n");
+
+	pDiag->lXleft = 0;
+
+	return TRUE;
+} /* end of bAddRepeatedImagePDF */
+
 /*
  * vAddFontsPDF - add the font information
  */
@@ -904,8 +1681,7 @@ vAddFontsPDF(diagram_type *pDiag)
 	pOutFile = pDiag->pOutFile;
 
 	/* The font encoding */
-	vSetLocation(4);
-	vFPprintf(pOutFile, "4 0 obj\n");
+	vStartObject(pOutFile, 4);
 	vFPprintf(pOutFile, "<<\n");
 	vFPprintf(pOutFile, "/Type /Encoding\n");
 	vFPprintf(pOutFile, "/BaseEncoding /StandardEncoding\n");
@@ -939,12 +1715,11 @@ vAddFontsPDF(diagram_type *pDiag)
 	}
 	vFPprintf(pOutFile, "]\n");
 	vFPprintf(pOutFile, ">>\n");
-	vFPprintf(pOutFile, "endobj\n");
+	vEndObject(pOutFile);
 
 	/* Twelve of the standard type 1 fonts */
 	for (tIndex = 0; tIndex < 12; tIndex++) {
-		vSetLocation(5 + tIndex);
-		vFPprintf(pOutFile, "%u 0 obj\n", 5 + tIndex);
+		vStartObject(pOutFile, 5 + (int)tIndex);
 		vFPprintf(pOutFile, "<<\n");
 		vFPprintf(pOutFile, "/Type /Font\n");
 		vFPprintf(pOutFile, "/Subtype /Type1\n");
@@ -953,21 +1728,21 @@ vAddFontsPDF(diagram_type *pDiag)
 						atFontname[tIndex].szPDFname);
 		vFPprintf(pOutFile, "/Encoding 4 0 R\n");
 		vFPprintf(pOutFile, ">>\n");
-		vFPprintf(pOutFile, "endobj\n");
+		vEndObject(pOutFile);
 	}
 
 	/* The Resources */
-	vSetLocation(17);
-	vFPprintf(pOutFile, "17 0 obj\n");
+	vStartObject(pOutFile, 17);
 	vFPprintf(pOutFile, "<<\n");
-	vFPprintf(pOutFile, "/ProcSet [ /PDF /Text ]\n");
+	vFPprintf(pOutFile, "/ProcSet [ /PDF /Text /ImageB /ImageC /ImageI ]\n");
+	vFPprintf(pOutFile, "/XObject 18 0 R\n");
 	vFPprintf(pOutFile, "/Font <<\n");
 	for (tIndex = 0; tIndex < 12; tIndex++) {
 		vFPprintf(pOutFile, "\t/F%u %u 0 R\n", 1 + tIndex, 5 + tIndex);
 	}
 	vFPprintf(pOutFile, "\t>>\n");
 	vFPprintf(pOutFile, ">>\n");
-	vFPprintf(pOutFile, "endobj\n");
+	vEndObject(pOutFile);
 	vAddHeader(pDiag);
 } /* end of vAddFontsPDF */
 
@@ -980,7 +1755,9 @@ vPrintPDF(FILE *pFile, const char *szString, size_t tStringLength,
 {
 	const UCHAR	*aucBytes;
 	double	dMove;
-	size_t	tCount;
+	size_t	tCount, tLength;
+	UCHAR	ucChar;
+	char	acBuffer[512];
 
 	fail(szString == NULL);
 
@@ -1003,32 +1780,35 @@ vPrintPDF(FILE *pFile, const char *szString, size_t tStringLength,
 		vFPprintf(pFile, "%.2f Ts\n", -dMove);
 	}
 
-	/* Generate and print the PDF output */
-	aucBytes = (UCHAR *)szString;
-	vFPprintf(pFile, "(");
+	/* Escape the string into a buffer and print it in large chunks */
+	aucBytes = (const UCHAR *)szString;
+	acBuffer[0] = '(';
+	tLength = 1;
 	for (tCount = 0; tCount < tStringLength ; tCount++) {
-		switch (aucBytes[tCount]) {
-		case '(':
-		case ')':
-		case '\\':
-			vFPprintf(pFile, "\\%c", szString[tCount]);
-			break;
-		default:
-			if (aucBytes[tCount] < 0x20 ||
-			    aucBytes[tCount] == 0x7f ||
-			    (aucBytes[tCount] >= 0x81 &&
-			     aucBytes[tCount] < 0x8c)) {
-				DBG_HEX(aucBytes[tCount]);
-				vFPprintf(pFile, " ");
-			} else if (aucBytes[tCount] >= 0x80) {
-				vFPprintf(pFile, "\\%03o",
-						(UINT)aucBytes[tCount]);
-			} else {
-				vFPprintf(pFile, "%c", szString[tCount]);
+		if (tLength + 4 > sizeof(acBuffer)) {
+			vFPwrite(pFile, acBuffer, tLength);
+			tLength = 0;
+		}
+		ucChar = aucBytes[tCount];
+		if (ucChar >= 0x20 && ucChar < 0x7f) {
+			if (ucChar == '(' || ucChar == ')' || ucChar == '\\') {
+				acBuffer[tLength++] = '\\';
 			}
-			break;
+			acBuffer[tLength++] = (char)ucChar;
+		} else if (ucChar < 0x20 ||
+			   ucChar == 0x7f ||
+			   (ucChar >= 0x81 && ucChar < 0x8c)) {
+			DBG_HEX(ucChar);
+			acBuffer[tLength++] = ' ';
+		} else {
+			/* Octal escape */
+			acBuffer[tLength++] = '\\';
+			acBuffer[tLength++] = (char)('0' + (ucChar >> 6));
+			acBuffer[tLength++] = (char)('0' + ((ucChar >> 3) & 0x07));
+			acBuffer[tLength++] = (char)('0' + (ucChar & 0x07));
 		}
 	}
+	vFPwrite(pFile, acBuffer, tLength);
 	vFPprintf(pFile, ") Tj\n");
 
 	/* Undo the superscript/subscript move */
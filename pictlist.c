@@ -7,6 +7,7 @@
  */
 
 #include <stdlib.h>
+#include <stddef.h>
 #include "antiword.h"
 
 
@@ -78,6 +79,7 @@ vAdd2PictInfoList(const picture_block_type *pPictureBlock)
 	NO_DBG_HEX(pPictureBlock->ulPictureOffset);
 
 	/* Create list member */
+	vCountListItem(stats_list_pictures);
 	pListMember = xmalloc(sizeof(picture_mem_type));
 	/* Fill the list member */
 	pListMember->tInfo = *pPictureBlock;
@@ -107,3 +109,51 @@ ulGetPictInfoListItem(ULONG ulFileOffset)
 	}
 	return FC_INVALID;
 } /* end of ulGetPictInfoListItem */
+
+/*
+ * tCountPictInfoListItems - count the uses of the given picture
+ *
+ * Returns the number of items that show the picture with the given offset
+ */
+size_t
+tCountPictInfoListItems(ULONG ulFileOffsetPicture)
+{
+	const picture_mem_type	*pCurr;
+	size_t	tCount;
+
+	tCount = 0;
+	for (pCurr = pAnchor; pCurr != NULL; pCurr = pCurr->pNext) {
+		if (pCurr->tInfo.ulFileOffsetPicture == ulFileOffsetPicture) {
+			tCount++;
+		}
+	}
+	return tCount;
+} /* end of tCountPictInfoListItems */
+
+/*
+ * Get the next item in the Picture Information List
+ */
+const picture_block_type *
+pGetNextPictInfoListItem(const picture_block_type *pCurr)
+{
+	const picture_mem_type	*pRecord;
+	size_t	tOffset;
+
+	if (pCurr == NULL) {
+		if (pAnchor == NULL) {
+			/* There are no records */
+			return NULL;
+		}
+		/* The first record is the only one without a predecessor */
+		return &pAnchor->tInfo;
+	}
+	tOffset = offsetof(picture_mem_type, tInfo);
+	/* Many casts to prevent alignment warnings */
+	pRecord = (picture_mem_type *)(void *)((char *)pCurr - tOffset);
+	fail(pCurr != &pRecord->tInfo);
+	if (pRecord->pNext == NULL) {
+		/* The last record has no successor */
+		return NULL;
+	}
+	return &pRecord->pNext->tInfo;
+} /* end of pGetNextPictInfoListItem */
@@ -24,28 +24,33 @@ static int	iPicCounter = 0;
 static size_t
 tSkipToData(FILE *pFile, size_t tMaxBytes, size_t *ptSkipped)
 {
-	ULONG	ulName, ulTmp;
+	ULONG	ulName;
 	size_t	tDataLength, tToSkip;
 	int	iCounter;
+	UCHAR	aucHeader[8];
 
 	fail(pFile == NULL);
 	fail(ptSkipped == NULL);
 
 	/* Examine chunks */
 	while (*ptSkipped + 8 < tMaxBytes) {
-		tDataLength = (size_t)ulNextLongBE(pFile);
+		/* Read the chunk length and name in one go */
+		if (tNextBytes(pFile, aucHeader, sizeof(aucHeader)) !=
+		    sizeof(aucHeader)) {
+			return (size_t)-1;
+		}
+		tDataLength = (size_t)ulGetLongBE(0, aucHeader);
 		DBG_DEC(tDataLength);
 		*ptSkipped += 4;
 
 		ulName = 0x00;
-		for (iCounter = 0; iCounter < 4; iCounter++) {
-			ulTmp = (ULONG)iNextByte(pFile);
-			if (!isalpha((int)ulTmp)) {
-				DBG_HEX(ulTmp);
+		for (iCounter = 4; iCounter < 8; iCounter++) {
+			if (!isalpha((int)aucHeader[iCounter])) {
+				DBG_HEX(aucHeader[iCounter]);
 				return (size_t)-1;
 			}
 			ulName <<= 8;
-			ulName |= ulTmp;
+			ulName |= aucHeader[iCounter];
 		}
 		DBG_HEX(ulName);
 		*ptSkipped += 4;
@@ -177,7 +182,7 @@ bTranslatePNG(diagram_type *pDiag, FILE *pFile,
 		return FALSE;
 	}
 
-	vImagePrologue(pDiag, pImg);
+	vImagePrologue(pDiag, ulFileOffset, pImg);
 	do {
 		tMaxBytes -= tSkipped;
 		vASCII85EncodeArray(pFile, pDiag->pOutFile, tDataLength);
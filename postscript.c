@@ -20,10 +20,19 @@
 #include "version.h"
 #include "antiword.h"
 
+/* Constant for the image offsets */
+#if defined(DEBUG)
+#define EXTENSION_ARRAY_SIZE	10
+#else
+#define EXTENSION_ARRAY_SIZE	30
+#endif /* DEBUG */
+
 /* The character set */
 static encoding_type	eEncoding = encoding_neutral;
 /* The image level */
 static image_level_enum	eImageLevel = level_default;
+/* PNG image data may be written as binary data */
+static BOOL		bBinaryImages = FALSE;
 /* The output must use landscape orientation */
 static BOOL		bUseLandscape = FALSE;
 /* The height and width of a PostScript page (in DrawUnits) */
@@ -47,6 +56,14 @@ static long		lYtopCurr = -1;
 static int		iPageCount = 0;
 /* Image counter */
 static int		iImageCount = 0;
+/* The offsets of the image data in the Word file, per image definition */
+static ULONG		*aulImageOffset = NULL;
+static size_t		tMaxImageOffsets = 0;
+static int		iImageDefinitions = 0;
+/* Writing the definitions of the images that are shown more than once */
+static BOOL		bDefiningImages = FALSE;
+/* The number of bytes of binary image data, zero for ASCII 85 data */
+static size_t		tBinaryPending = 0;
 /* Section index */
 static int		iSectionIndex = 0;
 /* Are we on the first page of the section? */
@@ -476,6 +493,7 @@ vProloguePS(diagram_type *pDiag,
 	bUseLandscape = pOptions->bUseLandscape;
 	eEncoding = pOptions->eEncoding;
 	eImageLevel = pOptions->eImageLevel;
+	bBinaryImages = pOptions->bBinaryImages;
 
 	if (pOptions->iPageHeight == INT_MAX) {
 		lPageHeight = LONG_MAX;
@@ -498,6 +516,10 @@ vProloguePS(diagram_type *pDiag,
 	lYtopCurr = -1;
 	iPageCount = 0;
 	iImageCount = 0;
+	tMaxImageOffsets = 0;
+	iImageDefinitions = 0;
+	bDefiningImages = FALSE;
+	tBinaryPending = 0;
 	iSectionIndex = 0;
 	bFirstInSection = TRUE;
 	pDiag->lXleft = 0;
@@ -556,6 +578,7 @@ vEpiloguePS(diagram_type *pDiag)
 	fprintf(pDiag->pOutFile, "%%%%Trailer\n");
 	fprintf(pDiag->pOutFile, "%%%%Pages: %d\n", iPageCount);
 	fprintf(pDiag->pOutFile, "%%%%EOF\n");
+	aulImageOffset = xfree(aulImageOffset);
 	szCreationDate = NULL;
 	szCreator = NULL;
 } /* end of vEpiloguePS */
@@ -596,31 +619,98 @@ vPrintPalette(FILE *pOutFile, const imagedata_type *pImg)
 } /* end of vPrintPalette */
 
 /*
- * vImageProloguePS - perform the Encapsulated PostScript initialization
+ * vSetImageOffset - remember the data offset of an image definition
  */
-void
-vImageProloguePS(diagram_type *pDiag, const imagedata_type *pImg)
+static void
+vSetImageOffset(int iImageData, ULONG ulFileOffset)
 {
-	FILE	*pOutFile;
-
-	fail(pDiag == NULL);
-	fail(pDiag->pOutFile == NULL);
-	fail(pImg == NULL);
+	size_t	tIndex;
 
-	if (pImg->iVerSizeScaled <= 0 || pImg->iHorSizeScaled <= 0) {
-		return;
+	fail(iImageData <= 0);
+
+	if ((size_t)iImageData >= tMaxImageOffsets) {
+		/* Extend the array */
+		tIndex = tMaxImageOffsets;
+		tMaxImageOffsets += EXTENSION_ARRAY_SIZE;
+		aulImageOffset = xrealloc(aulImageOffset,
+					tMaxImageOffsets * sizeof(ULONG));
+		DBG_DEC(tMaxImageOffsets);
+		for (; tIndex < tMaxImageOffsets; tIndex++) {
+			aulImageOffset[tIndex] = FC_INVALID;
+		}
 	}
+	aulImageOffset[iImageData] = ulFileOffset;
+} /* end of vSetImageOffset */
 
-	fail(szCreationDate == NULL);
-	fail(szCreator == NULL);
-	fail(eImageLevel == level_no_images);
+/*
+ * iFindImageData - find the image definition with the given offset
+ *
+ * returns the number of the image definition when found, otherwise 0
+ */
+static int
+iFindImageData(ULONG ulFileOffset)
+{
+	int	iIndex;
 
-	iImageCount++;
+	for (iIndex = 1; iIndex <= iImageDefinitions; iIndex++) {
+		if (aulImageOffset[iIndex] == ulFileOffset) {
+			return iIndex;
+		}
+	}
+	return 0;
+} /* end of iFindImageData */
 
-	DBG_DEC_C(pDiag->lXleft != 0, pDiag->lXleft);
+/*
+ * bBinaryImageData - write the data of this image as binary data?
+ *
+ * Only the compressed data of PNG images is copied as it is (option -b)
+ */
+static BOOL
+bBinaryImageData(const imagedata_type *pImg)
+{
+	return bBinaryImages &&
+		(eImageLevel == level_ps_3 ||
+		 eImageLevel == level_gs_special) &&
+		pImg->eImageType == imagetype_is_png &&
+		pImg->tDataLength != 0;
+} /* end of bBinaryImageData */
 
-	pDiag->lYtop -= lPoints2DrawUnits(pImg->iVerSizeScaled);
-	vMoveTo(pDiag, lPoints2DrawUnits(pImg->iVerSizeScaled));
+/*
+ * vPrintImageSource - define the source of the image data
+ *
+ * iImageData is the number of the image with the kept data, 0 for
+ * data that follows in the PostScript file itself: tBinaryPending bytes
+ * of binary data or else ASCII 85 encoded data
+ */
+static void
+vPrintImageSource(FILE *pOutFile, const char *szName, int iImageData)
+{
+	if (iImageData <= 0) {
+		fprintf(pOutFile, "/%s currentfile ", szName);
+		if (tBinaryPending != 0) {
+			fprintf(pOutFile, "%lu () /SubFileDecode filter def\n",
+				(ULONG)tBinaryPending);
+		} else {
+			fprintf(pOutFile, "/ASCII85Decode filter def\n");
+		}
+		return;
+	}
+	/* Start reading at the beginning of the kept data */
+	fprintf(pOutFile, "Image%03d 0 setfileposition\n", iImageData);
+	fprintf(pOutFile, "/%s Image%03d def\n", szName, iImageData);
+} /* end of vPrintImageSource */
+
+/*
+ * vImageHeaderPS - write the Encapsulated PostScript that draws the image
+ *
+ * iImageData is the number of the image with the kept data, 0 when the
+ * data follows
+ */
+static void
+vImageHeaderPS(diagram_type *pDiag, const imagedata_type *pImg,
+	int iImageData)
+{
+	FILE	*pOutFile;
 
 	pOutFile = pDiag->pOutFile;
 
@@ -632,8 +722,9 @@ vImageProloguePS(diagram_type *pDiag, const imagedata_type *pImg)
 	fprintf(pOutFile, "%%%%CreationDate: %s", szCreationDate);
 	fprintf(pOutFile, "%%%%BoundingBox: 0 0 %d %d\n",
 				pImg->iHorSizeScaled, pImg->iVerSizeScaled);
-	fprintf(pOutFile, "%%%%DocumentData: Clean7Bit\n");
-	fprintf(pOutFile, "%%%%LanguageLevel: 2\n");
+	fprintf(pOutFile, "%%%%DocumentData: %s\n",
+		iImageData <= 0 && tBinaryPending != 0 ? "Binary" : "Clean7Bit");
+	fprintf(pOutFile, "%%%%LanguageLevel: %d\n", iImageData > 0 ? 3 : 2);
 	fprintf(pOutFile, "%%%%EndComments\n");
 	fprintf(pOutFile, "%%%%BeginProlog\n");
 	fprintf(pOutFile, "%%%%EndProlog\n");
@@ -643,8 +734,7 @@ vImageProloguePS(diagram_type *pDiag, const imagedata_type *pImg)
 
 	switch (pImg->eImageType) {
 	case imagetype_is_jpeg:
-		fprintf(pOutFile, "/Data1 currentfile ");
-		fprintf(pOutFile, "/ASCII85Decode filter def\n");
+		vPrintImageSource(pOutFile, "Data1", iImageData);
 		fprintf(pOutFile, "/Data Data1 << ");
 		fprintf(pOutFile, ">> /DCTDecode filter def\n");
 		switch (pImg->iComponents) {
@@ -664,8 +754,7 @@ vImageProloguePS(diagram_type *pDiag, const imagedata_type *pImg)
 		break;
 	case imagetype_is_png:
 		if (eImageLevel == level_gs_special) {
-			fprintf(pOutFile,
-			"/Data2 currentfile /ASCII85Decode filter def\n");
+			vPrintImageSource(pOutFile, "Data2", iImageData);
 			fprintf(pOutFile,
 			"/Data1 Data2 << >> /FlateDecode filter def\n");
 			fprintf(pOutFile, "/Data Data1 <<\n");
@@ -676,8 +765,7 @@ vImageProloguePS(diagram_type *pDiag, const imagedata_type *pImg)
 			fprintf(pOutFile,
 				">> /PNGPredictorDecode filter def\n");
 		} else {
-			fprintf(pOutFile,
-			"/Data1 currentfile /ASCII85Decode filter def\n");
+			vPrintImageSource(pOutFile, "Data1", iImageData);
 			fprintf(pOutFile,
 			"/Data Data1 << >> /FlateDecode filter def\n");
 		}
@@ -690,8 +778,7 @@ vImageProloguePS(diagram_type *pDiag, const imagedata_type *pImg)
 		}
 		break;
 	case imagetype_is_dib:
-		fprintf(pOutFile, "/Data currentfile ");
-		fprintf(pOutFile, "/ASCII85Decode filter def\n");
+		vPrintImageSource(pOutFile, "Data", iImageData);
 		if (pImg->uiBitsPerComponent <= 8) {
 			vPrintPalette(pOutFile, pImg);
 		} else {
@@ -791,10 +878,99 @@ vImageProloguePS(diagram_type *pDiag, const imagedata_type *pImg)
 	}
 
 	fprintf(pOutFile, "  >> image\n");
-	fprintf(pOutFile, "  Data closefile\n");
+	if (iImageData <= 0 || pImg->eImageType != imagetype_is_dib) {
+		/* Closing the kept data itself would destroy it */
+		fprintf(pOutFile, "  Data closefile\n");
+	}
+	if (iImageData <= 0 && tBinaryPending != 0) {
+		/* Skip the binary data that the image did not read */
+		fprintf(pOutFile, "  %s flushfile\n",
+			eImageLevel == level_gs_special ? "Data2" : "Data1");
+	}
 	fprintf(pOutFile, "  showpage\n");
 	fprintf(pOutFile, "  restore\n");
 	fprintf(pOutFile, "} exec\n");
+} /* end of vImageHeaderPS */
+
+/*
+ * vImageTrailerPS - end the Encapsulated PostScript of the image
+ */
+static void
+vImageTrailerPS(FILE *pOutFile)
+{
+	fprintf(pOutFile, "%%%%EOF\n");
+	fprintf(pOutFile, "%%%%EndDocument\n");
+	fprintf(pOutFile, "EndEPSF\n");
+} /* end of vImageTrailerPS */
+
+/*
+ * vImageProloguePS - perform the Encapsulated PostScript initialization
+ *
+ * ulFileOffset is the start of the image data, it identifies the image
+ */
+void
+vImageProloguePS(diagram_type *pDiag, ULONG ulFileOffset,
+	const imagedata_type *pImg)
+{
+	FILE	*pOutFile;
+
+	fail(pDiag == NULL);
+	fail(pDiag->pOutFile == NULL);
+	fail(pImg == NULL);
+
+	if (pImg->iVerSizeScaled <= 0 || pImg->iHorSizeScaled <= 0) {
+		return;
+	}
+
+	fail(szCreationDate == NULL);
+	fail(szCreator == NULL);
+	fail(eImageLevel == level_no_images);
+
+	pOutFile = pDiag->pOutFile;
+
+	/* The image data will be ASCII 85 encoded */
+	vASCII85SetBinary(FALSE);
+
+	if (bDefiningImages) {
+		/*
+		 * Define the data, the images are drawn later on.
+		 * The filter reads the data when it is made, so the data
+		 * follows right after the filter and the def after the data
+		 */
+		if (iImageDefinitions == 0) {
+			fprintf(pOutFile, "%%%%BeginSetup\n");
+		}
+		iImageDefinitions++;
+		vSetImageOffset(iImageDefinitions, ulFileOffset);
+		if (bBinaryImageData(pImg)) {
+			/* Copy the data without the ASCII 85 expansion */
+			vASCII85SetBinary(TRUE);
+			tBinaryPending = pImg->tDataLength;
+			fprintf(pOutFile,
+			"/Image%03d currentfile %lu () /SubFileDecode filter\n",
+				iImageDefinitions, (ULONG)tBinaryPending);
+		} else {
+			fprintf(pOutFile,
+				"/Image%03d currentfile /ASCII85Decode filter\n",
+				iImageDefinitions);
+		}
+		fprintf(pOutFile, "\t/ReusableStreamDecode filter\n");
+		return;
+	}
+
+	iImageCount++;
+
+	DBG_DEC_C(pDiag->lXleft != 0, pDiag->lXleft);
+
+	pDiag->lYtop -= lPoints2DrawUnits(pImg->iVerSizeScaled);
+	vMoveTo(pDiag, lPoints2DrawUnits(pImg->iVerSizeScaled));
+
+	if (bBinaryImageData(pImg)) {
+		/* Copy the data without the ASCII 85 expansion */
+		vASCII85SetBinary(TRUE);
+		tBinaryPending = pImg->tDataLength;
+	}
+	vImageHeaderPS(pDiag, pImg, 0);
 } /* end of vImageProloguePS */
 
 /*
@@ -810,9 +986,23 @@ vImageEpiloguePS(diagram_type *pDiag)
 
 	pOutFile = pDiag->pOutFile;
 
-	fprintf(pOutFile, "%%%%EOF\n");
-	fprintf(pOutFile, "%%%%EndDocument\n");
-	fprintf(pOutFile, "EndEPSF\n");
+	if (tBinaryPending != 0) {
+		/* The filter expects exactly this number of bytes */
+		DBG_DEC_C(tGetASCII85Length() != tBinaryPending,
+			tGetASCII85Length());
+		while (tGetASCII85Length() < tBinaryPending) {
+			vASCII85EncodeByte(pOutFile, 0);
+		}
+		vASCII85SetBinary(FALSE);
+		tBinaryPending = 0;
+		fprintf(pOutFile, "\n");
+	}
+	if (bDefiningImages) {
+		/* The definition is complete, there is nothing to draw */
+		fprintf(pOutFile, "def\n");
+		return;
+	}
+	vImageTrailerPS(pOutFile);
 
 	pDiag->lXleft = 0;
 } /* end of vImageEpiloguePS */
@@ -863,11 +1053,146 @@ bAddDummyImagePS(diagram_type *pDiag, const imagedata_type *pImg)
 	return TRUE;
 } /* end of bAddDummyImagePS */
 
+/*
+ * bAddRepeatedImagePS - add an image that has been defined before
+ *
+ * The image data from the document setup is used again
+ *
+ * return TRUE when successful, otherwise FALSE
+ */
+BOOL
+bAddRepeatedImagePS(diagram_type *pDiag, ULONG ulFileOffset,
+	const imagedata_type *pImg)
+{
+	int	iImageData;
+
+	fail(pDiag == NULL);
+	fail(pDiag->pOutFile == NULL);
+	fail(pImg == NULL);
+
+	if (pImg->iVerSizeScaled <= 0 || pImg->iHorSizeScaled <= 0) {
+		return FALSE;
+	}
+
+	iImageData = iFindImageData(ulFileOffset);
+	if (iImageData <= 0) {
+		return FALSE;
+	}
+	DBG_DEC(iImageData);
+
+	iImageCount++;
+
+	DBG_DEC_C(pDiag->lXleft != 0, pDiag->lXleft);
+
+	pDiag->lYtop -= lPoints2DrawUnits(pImg->iVerSizeScaled);
+	vMoveTo(pDiag, lPoints2DrawUnits(pImg->iVerSizeScaled));
+
+	vImageHeaderPS(pDiag, pImg, iImageData);
+	vImageTrailerPS(pDiag->pOutFile);
+
+	pDiag->lXleft = 0;
+
+	return TRUE;
+} /* end of bAddRepeatedImagePS */
+
+/*
+ * vDefineImagesPS - define the images that are shown more than once
+ *
+ * The Picture Information List is complete before the first page, so the
+ * data of every picture that the list shows more than once is written just
+ * once, in the document setup. Every page that shows such a picture uses
+ * the defined data. Keeping the data needs the ReusableStreamDecode filter
+ * (Level 3).
+ */
+static void
+vDefineImagesPS(diagram_type *pDiag, FILE *pFile)
+{
+	const picture_block_type	*pPicture;
+	ULONG	*aulDone;
+	imagedata_type	tImage;
+	ULONG	ulFileOffsetImage, ulFileOffset;
+	size_t	tDone, tMaxDone, tIndex;
+
+	fail(pDiag == NULL);
+	fail(pFile == NULL);
+
+	if (eImageLevel != level_ps_3 && eImageLevel != level_gs_special) {
+		return;
+	}
+
+	aulDone = NULL;
+	tDone = 0;
+	tMaxDone = 0;
+	bDefiningImages = TRUE;
+	for (pPicture = pGetNextPictInfoListItem(NULL);
+	     pPicture != NULL;
+	     pPicture = pGetNextPictInfoListItem(pPicture)) {
+		ulFileOffsetImage = pPicture->ulFileOffsetPicture;
+		if (ulFileOffsetImage == FC_INVALID) {
+			continue;
+		}
+		/* Every picture is defined only once */
+		for (tIndex = 0; tIndex < tDone; tIndex++) {
+			if (aulDone[tIndex] == ulFileOffsetImage) {
+				break;
+			}
+		}
+		if (tIndex < tDone) {
+			continue;
+		}
+		if (tDone >= tMaxDone) {
+			tMaxDone += EXTENSION_ARRAY_SIZE;
+			aulDone = xrealloc(aulDone, tMaxDone * sizeof(ULONG));
+		}
+		aulDone[tDone++] = ulFileOffsetImage;
+
+		if (tCountPictInfoListItems(ulFileOffsetImage) < 2) {
+			continue;
+		}
+		(void)memset(&tImage, 0, sizeof(tImage));
+		if (eExamineImage(pFile, ulFileOffsetImage, &tImage) !=
+		    image_full_information) {
+			continue;
+		}
+		if (tImage.iHorSizeScaled <= 0 || tImage.iVerSizeScaled <= 0) {
+			continue;
+		}
+		fail(tImage.tPosition > tImage.tLength);
+		ulFileOffset = ulFileOffsetImage + tImage.tPosition;
+		switch (tImage.eImageType) {
+		case imagetype_is_dib:
+			(void)bTranslateDIB(pDiag, pFile,
+					ulFileOffset, &tImage);
+			break;
+		case imagetype_is_jpeg:
+			(void)bTranslateJPEG(pDiag, pFile, ulFileOffset,
+					tImage.tLength - tImage.tPosition,
+					&tImage);
+			break;
+		case imagetype_is_png:
+			(void)bTranslatePNG(pDiag, pFile, ulFileOffset,
+					tImage.tLength - tImage.tPosition,
+					&tImage);
+			break;
+		default:
+			break;
+		}
+	}
+	bDefiningImages = FALSE;
+	aulDone = xfree(aulDone);
+
+	if (iImageDefinitions > 0) {
+		fprintf(pDiag->pOutFile, "%%%%EndSetup\n");
+	}
+} /* end of vDefineImagesPS */
+
 /*
  * vAddFontsPS - add the list of fonts and complete the prologue
+ *
+ * The document setup defines the images that are shown more than once
  */
 void
-vAddFontsPS(diagram_type *pDiag)
+vAddFontsPS(diagram_type *pDiag, FILE *pFile)
 {
 	FILE	*pOutFile;
 	const font_table_type *pTmp, *pTmp2;
@@ -968,6 +1293,7 @@ vAddFontsPS(diagram_type *pDiag)
 		fprintf(pOutFile, "%s\n", misc_func[tIndex]);
 	}
 	fprintf(pOutFile, "%%%%EndProlog\n");
+	vDefineImagesPS(pDiag, pFile);
 	iPageCount = 1;
 	fprintf(pDiag->pOutFile, "%%%%Page: %d %d\n", iPageCount, iPageCount);
 	vAddPageSetup(pDiag->pOutFile);
@@ -983,7 +1309,9 @@ vPrintPS(FILE *pFile, const char *szString, size_t tStringLength,
 {
 	double		dSuperscriptMove, dSubscriptMove;
 	const UCHAR	*ucBytes;
-	size_t		tCount;
+	size_t		tCount, tLength;
+	UCHAR		ucChar;
+	char		acBuffer[512];
 
 	fail(szString == NULL);
 
@@ -1007,31 +1335,33 @@ vPrintPS(FILE *pFile, const char *szString, size_t tStringLength,
 		fprintf(pFile, "0 %.2f rmoveto\n", -dSubscriptMove);
 	}
 
-	/* Generate and print the PostScript output */
-	ucBytes = (UCHAR *)szString;
-	(void)putc('(', pFile);
+	/* Escape the string into a buffer and print it in large chunks */
+	ucBytes = (const UCHAR *)szString;
+	acBuffer[0] = '(';
+	tLength = 1;
 	for (tCount = 0; tCount < tStringLength ; tCount++) {
-		switch (ucBytes[tCount]) {
-		case '(':
-		case ')':
-		case '\\':
-			(void)putc('\\', pFile);
-			(void)putc(szString[tCount], pFile);
-			break;
-		default:
-			if (ucBytes[tCount] < 0x20 ||
-			    (ucBytes[tCount] >= 0x7f &&
-			     ucBytes[tCount] < 0x8c)) {
-				DBG_HEX(ucBytes[tCount]);
-				(void)putc(' ', pFile);
-			} else if (ucBytes[tCount] >= 0x80) {
-				fprintf(pFile, "\\%03o", (UINT)ucBytes[tCount]);
-			} else {
-				(void)putc(szString[tCount], pFile);
+		if (tLength + 4 > sizeof(acBuffer)) {
+			(void)fwrite(acBuffer, 1, tLength, pFile);
+			tLength = 0;
+		}
+		ucChar = ucBytes[tCount];
+		if (ucChar >= 0x20 && ucChar < 0x7f) {
+			if (ucChar == '(' || ucChar == ')' || ucChar == '\\') {
+				acBuffer[tLength++] = '\\';
 			}
-			break;
+			acBuffer[tLength++] = (char)ucChar;
+		} else if (ucChar < 0x8c) {
+			DBG_HEX(ucChar);
+			acBuffer[tLength++] = ' ';
+		} else {
+			/* Octal escape */
+			acBuffer[tLength++] = '\\';
+			acBuffer[tLength++] = (char)('0' + (ucChar >> 6));
+			acBuffer[tLength++] = (char)('0' + ((ucChar >> 3) & 0x07));
+			acBuffer[tLength++] = (char)('0' + (ucChar & 0x07));
 		}
 	}
+	(void)fwrite(acBuffer, 1, tLength, pFile);
 	fprintf(pFile, ") ");
 	if ((bIsStrike(usFontstyle) || bIsMarkDel(usFontstyle)) &&
 			usFontSizeCurr != 0) {
@@ -12,48 +12,417 @@
 
 #define MAX_FILESIZE		0x2000000UL	/* 32 Mb */
 
+/* The length of every sprm (including the opcode) in WinWord 1/2 files */
+static const UCHAR	aucSprm2Length[256] = {
+	/*   0 */ 2, 2, 2, SPRM_VAR, 2, 2, 2, 2,
+	/*   8 */ 2, 2, 2, 2, 2, 2, 2, SPRM_VAR,
+	/*  16 */ 3, 3, 3, 3, 2, 3, 3, SPRM_TAB,
+	/*  24 */ 2, 2, 3, 3, 3, 2, 3, 3,
+	/*  32 */ 3, 3, 3, 3, 3, 2, 3, 3,
+	/*  40 */ 3, 3, 3, 3, 2, 3, 3, 3,
+	/*  48 */ 3, 3, 2, 2, 2, 2, 2, 2,
+	/*  56 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/*  64 */ 2, 2, 2, 2, 3, 2, 4, 3,
+	/*  72 */ 3, 2, 2, 2, 2, 2, SPRM_VAR, 2,
+	/*  80 */ 2, 2, 3, 3, 2, 2, 2, 2,
+	/*  88 */ 2, 2, 2, 2, 2, 2, 2, 14,
+	/*  96 */ 3, 3, 3, 3, 2, 2, 2, 2,
+	/* 104 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 112 */ 2, 2, 2, 3, 3, 2, 2, 3,
+	/* 120 */ 3, 2, 2, 3, 3, 2, 2, 2,
+	/* 128 */ 2, 3, 3, 3, 3, 2, 2, 3,
+	/* 136 */ 3, 2, 2, 3, 3, 3, 3, 3,
+	/* 144 */ 3, 3, 3, 3, 3, 2, 2, 2,
+	/* 152 */ SPRM_VAR, 3, SPRM_VAR, SPRM_VAR, 2, 6, 5, 3,
+	/* 160 */ 5, 3, 3, 6, 5, 2, 2, 2,
+	/* 168 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 176 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 184 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 192 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 200 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 208 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 216 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 224 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 232 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 240 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 248 */ 2, 2, 2, 2, 2, 2, 2, 2,
+};
+
 /*
  * iGet2InfoLength - the length of the information for WinWord 1/2 files
  */
 static int
 iGet2InfoLength(int iByteNbr, const UCHAR *aucGrpprl)
+{
+	return iGetSprmLength(aucSprm2Length, iByteNbr, aucGrpprl);
+} /* end of iGet2InfoLength */
+
+/*
+ * sprmSBkc - the section break code
+ */
+static int
+iSprm2Bkc(void *pvSection, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	section_block_type	*pSection;
+	UCHAR	ucTmp;
+
+	pSection = (section_block_type *)pvSection;
+	ucTmp = ucGetByte(1, aucSprm);
+	DBG_DEC(ucTmp);
+	pSection->bNewPage = ucTmp != 0 && ucTmp != 1;
+	return 0;
+} /* end of iSprm2Bkc */
+
+/*
+ * sprmSCcolumns - the number of columns minus one
+ */
+static int
+iSprm2CcolM1(void *pvSection, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	DBG_DEC(1 + usGetWord(1, aucSprm));
+	return 0;
+} /* end of iSprm2CcolM1 */
+
+/*
+ * sprmSGprfIhdt - the headers and footers of the section
+ */
+static int
+iSprm2GrpfIhdt(void *pvSection, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	section_block_type	*pSection;
+
+	pSection = (section_block_type *)pvSection;
+	pSection->ucHdrFtrSpecification = ucGetByte(1, aucSprm);
+	return 0;
+} /* end of iSprm2GrpfIhdt */
+
+/*
+ * sprmPFInTable - the paragraph is in a table cell
+ */
+static int
+iSprm2InTable(void *pvRow, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	row_sprm_type	*pState;
+
+	pState = (row_sprm_type *)pvRow;
+	if (odd(ucGetByte(1, aucSprm))) {
+		pState->bCell1 = TRUE;
+	} else {
+		pState->bCell0 = TRUE;
+	}
+	return 0;
+} /* end of iSprm2InTable */
+
+/*
+ * sprmPFTtp - the paragraph ends a table row
+ */
+static int
+iSprm2Ttp(void *pvRow, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	row_sprm_type	*pState;
+
+	pState = (row_sprm_type *)pvRow;
+	if (odd(ucGetByte(1, aucSprm))) {
+		pState->bRowEnd1 = TRUE;
+	} else {
+		pState->bRowEnd0 = TRUE;
+	}
+	return 0;
+} /* end of iSprm2Ttp */
+
+/*
+ * sprmPBrcTop10 and friends - one old style border, usParam is the border bit
+ */
+static int
+iSprm2Border10(void *pvRow, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	row_block_type	*pRow;
+	USHORT	usTmp;
+
+	pRow = ((row_sprm_type *)pvRow)->pRow;
+	usTmp = usGetWord(1, aucSprm);
+	usTmp &= 0x01ff;
+	NO_DBG_DEC(usTmp >> 6);
+	if (usTmp == 0) {
+		pRow->ucBorderInfo &= (UCHAR)~usParam;
+	} else {
+		pRow->ucBorderInfo |= (UCHAR)usParam;
+	}
+	return 0;
+} /* end of iSprm2Border10 */
+
+/*
+ * sprmPBrcTop and friends - one border, usParam is the border bit
+ */
+static int
+iSprm2Border(void *pvRow, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	row_block_type	*pRow;
+	USHORT	usTmp;
+
+	pRow = ((row_sprm_type *)pvRow)->pRow;
+	usTmp = usGetWord(1, aucSprm);
+	usTmp &= 0x0018;
+	NO_DBG_DEC(usTmp >> 3);
+	if (usTmp == 0) {
+		pRow->ucBorderInfo &= (UCHAR)~usParam;
+	} else {
+		pRow->ucBorderInfo |= (UCHAR)usParam;
+	}
+	return 0;
+} /* end of iSprm2Border */
+
+/*
+ * sprmTDefTable10 and sprmTDefTable - the cell definitions
+ */
+static int
+iSprm2DefTable(void *pvRow, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	row_sprm_type	*pState;
+	row_block_type	*pRow;
+	int	iIndex, iSize, iCol;
+	int	iPosCurr, iPosPrev;
+
+	pState = (row_sprm_type *)pvRow;
+	pRow = pState->pRow;
+	iSize = (int)usGetWord(1, aucSprm);
+	if (iSize < 6 || iBytes < 7) {
+		DBG_DEC(iSize);
+		DBG_DEC(iBytes);
+		return 1;
+	}
+	iCol = (int)ucGetByte(3, aucSprm);
+	if (iCol < 1 || iBytes < 3 + (iCol + 1) * 2) {
+		DBG_DEC(iCol);
+		DBG_DEC(iBytes);
+		DBG_DEC(ucGetByte(0, aucSprm));
+		return 1;
+	}
+	if (iCol >= (int)elementsof(pRow->asColumnWidth)) {
+		DBG_DEC(iCol);
+		werr(1, "The number of columns is corrupt");
+	}
+	pRow->ucNumberOfColumns = (UCHAR)iCol;
+	iPosPrev = (int)(short)usGetWord(4, aucSprm);
+	for (iIndex = 0; iIndex < iCol; iIndex++) {
+		iPosCurr = (int)(short)usGetWord(6 + iIndex * 2, aucSprm);
+		pRow->asColumnWidth[iIndex] = (short)(iPosCurr - iPosPrev);
+		iPosPrev = iPosCurr;
+	}
+	pState->bDefTable = TRUE;
+	return 0;
+} /* end of iSprm2DefTable */
+
+/*
+ * sprmPJc - the alignment of the paragraph
+ */
+static int
+iSprm2Jc(void *pvStyle, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->ucAlignment = ucGetByte(1, aucSprm);
+	return 0;
+} /* end of iSprm2Jc */
+
+/*
+ * sprmPNfcSeqNumb - the number format of the list
+ */
+static int
+iSprm2NfcSeqNumb(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->ucNFC = ucGetByte(1, aucSprm);
+	return 0;
+} /* end of iSprm2NfcSeqNumb */
+
+/*
+ * sprmPNLvlAnm - the list level of the paragraph
+ */
+static int
+iSprm2NLvlAnm(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+	UCHAR	ucTmp;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	ucTmp = ucGetByte(1, aucSprm);
+	pStyle->ucNumLevel = ucTmp;
+	pStyle->bNumPause = eGetNumType(ucTmp) == level_type_pause;
+	return 0;
+} /* end of iSprm2NLvlAnm */
+
+/*
+ * sprmPChgTabsPapx and sprmPChgTabs - the tab stops
+ *
+ * Returns 1 to skip only the opcode when the operand is corrupt
+ */
+static int
+iSprm2ChgTabs(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
 {
 	int	iTmp, iDel, iAdd;
 
-	switch (ucGetByte(iByteNbr, aucGrpprl)) {
-	case   3: case  15: case  78: case 152: case 154: case 155:
-		return 2 + (int)ucGetByte(iByteNbr + 1, aucGrpprl);
-	case  16: case  17: case  18: case  19: case  21: case  22: case  26:
-	case  27: case  28: case  30: case  31: case  32: case  33: case  34:
-	case  35: case  36: case  38: case  39: case  40: case  41: case  42:
-	case  43: case  45: case  46: case  47: case  48: case  49: case  68:
-	case  71: case  72: case  82: case  83: case  96: case  97: case  98:
-	case  99: case 115: case 116: case 119: case 120: case 123: case 124:
-	case 129: case 130: case 131: case 132: case 135: case 136: case 139:
-	case 140: case 141: case 142: case 143: case 144: case 145: case 146:
-	case 147: case 148: case 153: case 159: case 161: case 162:
-		return 1 + 2;
-	case  23:
-		iTmp = (int)ucGetByte(iByteNbr + 1, aucGrpprl);
-		if (iTmp == 255) {
-			iDel = (int)ucGetByte(iByteNbr + 2, aucGrpprl);
-			iAdd = (int)ucGetByte(
-					iByteNbr + 3 + iDel * 4, aucGrpprl);
-			iTmp = 2 + iDel * 4 + iAdd * 3;
-		}
-		return 2 + iTmp;
-	case  70:
-		return 1 + 3;
-	case  95:
-		return 1 + 13;
-	case 157: case 163:
-		return 1 + 5;
-	case 158: case 160: case 164:
-		return 1 + 4;
-	default:
-		return 1 + 1;
+	iTmp = (int)ucGetByte(1, aucSprm);
+	if (iTmp < 2) {
+		return 1;
 	}
-} /* end of iGet2InfoLength */
+	NO_DBG_DEC(iTmp);
+	iDel = (int)ucGetByte(2, aucSprm);
+	if (iTmp < 2 + 2 * iDel) {
+		return 1;
+	}
+	NO_DBG_DEC(iDel);
+	iAdd = (int)ucGetByte(3 + 2 * iDel, aucSprm);
+	if (iTmp < 2 + 2 * iDel + 2 * iAdd) {
+		return 1;
+	}
+	NO_DBG_DEC(iAdd);
+	return 0;
+} /* end of iSprm2ChgTabs */
+
+/*
+ * sprmPDxaRight - the right indentation
+ */
+static int
+iSprm2DxaRight(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->sRightIndent = (short)usGetWord(1, aucSprm);
+	NO_DBG_DEC(pStyle->sRightIndent);
+	return 0;
+} /* end of iSprm2DxaRight */
+
+/*
+ * sprmPDxaLeft - the left indentation
+ */
+static int
+iSprm2DxaLeft(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->sLeftIndent = (short)usGetWord(1, aucSprm);
+	NO_DBG_DEC(pStyle->sLeftIndent);
+	return 0;
+} /* end of iSprm2DxaLeft */
+
+/*
+ * sprmPNest - the nested left indentation
+ */
+static int
+iSprm2Nest(void *pvStyle, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	style_block_type	*pStyle;
+	short	sTmp;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	sTmp = (short)usGetWord(1, aucSprm);
+	pStyle->sLeftIndent += sTmp;
+	if (pStyle->sLeftIndent < 0) {
+		pStyle->sLeftIndent = 0;
+	}
+	NO_DBG_DEC(sTmp);
+	NO_DBG_DEC(pStyle->sLeftIndent);
+	return 0;
+} /* end of iSprm2Nest */
+
+/*
+ * sprmPDxaLeft1 - the first line indentation
+ */
+static int
+iSprm2DxaLeft1(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->sLeftIndent1 = (short)usGetWord(1, aucSprm);
+	NO_DBG_DEC(pStyle->sLeftIndent1);
+	return 0;
+} /* end of iSprm2DxaLeft1 */
+
+/*
+ * sprmPDyaBefore - the space before the paragraph
+ */
+static int
+iSprm2DyaBefore(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->usBeforeIndent = usGetWord(1, aucSprm);
+	NO_DBG_DEC(pStyle->usBeforeIndent);
+	return 0;
+} /* end of iSprm2DyaBefore */
+
+/*
+ * sprmPDyaAfter - the space after the paragraph
+ */
+static int
+iSprm2DyaAfter(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->usAfterIndent = usGetWord(1, aucSprm);
+	NO_DBG_DEC(pStyle->usAfterIndent);
+	return 0;
+} /* end of iSprm2DyaAfter */
+
+/*
+ * The WinWord 1/2 opcodes, sorted by opcode.
+ * The handlers are for the section, row and style information, the font and
+ * picture information of these files is not stored as a grpprl
+ */
+static const sprm_type	atSprm2[] = {
+	{   5, 0, { NULL, NULL, iSprm2Jc, NULL, NULL } },
+	{  12, 0, { NULL, NULL, iSprm2NfcSeqNumb, NULL, NULL } },
+	{  13, 0, { NULL, NULL, iSprm2NLvlAnm, NULL, NULL } },
+	{  15, 0, { NULL, NULL, iSprm2ChgTabs, NULL, NULL } },
+	{  16, 0, { NULL, NULL, iSprm2DxaRight, NULL, NULL } },
+	{  17, 0, { NULL, NULL, iSprm2DxaLeft, NULL, NULL } },
+	{  18, 0, { NULL, NULL, iSprm2Nest, NULL, NULL } },
+	{  19, 0, { NULL, NULL, iSprm2DxaLeft1, NULL, NULL } },
+	{  21, 0, { NULL, NULL, iSprm2DyaBefore, NULL, NULL } },
+	{  22, 0, { NULL, NULL, iSprm2DyaAfter, NULL, NULL } },
+	{  23, 0, { NULL, NULL, iSprm2ChgTabs, NULL, NULL } },
+	{  24, 0, { NULL, iSprm2InTable, NULL, NULL, NULL } },
+	{  25, 0, { NULL, iSprm2Ttp, NULL, NULL, NULL } },
+	{  30, TABLE_BORDER_TOP, { NULL, iSprm2Border10, NULL, NULL, NULL } },
+	{  31, TABLE_BORDER_LEFT, { NULL, iSprm2Border10, NULL, NULL, NULL } },
+	{  32, TABLE_BORDER_BOTTOM,
+			{ NULL, iSprm2Border10, NULL, NULL, NULL } },
+	{  33, TABLE_BORDER_RIGHT,
+			{ NULL, iSprm2Border10, NULL, NULL, NULL } },
+	{  38, TABLE_BORDER_TOP, { NULL, iSprm2Border, NULL, NULL, NULL } },
+	{  39, TABLE_BORDER_LEFT, { NULL, iSprm2Border, NULL, NULL, NULL } },
+	{  40, TABLE_BORDER_BOTTOM, { NULL, iSprm2Border, NULL, NULL, NULL } },
+	{  41, TABLE_BORDER_RIGHT, { NULL, iSprm2Border, NULL, NULL, NULL } },
+	{ 117, 0, { iSprm2Bkc, NULL, NULL, NULL, NULL } },
+	{ 119, 0, { iSprm2CcolM1, NULL, NULL, NULL, NULL } },
+	{ 128, 0, { iSprm2GrpfIhdt, NULL, NULL, NULL, NULL } },
+	{ 152, 0, { NULL, iSprm2DefTable, NULL, NULL, NULL } },
+	{ 154, 0, { NULL, iSprm2DefTable, NULL, NULL, NULL } },
+};
+
+static const sprm_table_type	tSprm2Table = {
+	atSprm2, elementsof(atSprm2), 1, iGet2InfoLength
+};
 
 /*
  * Build the lists with Document Property Information for WinWord 1/2 files
@@ -102,35 +471,10 @@ static void
 vGet2SectionInfo(const UCHAR *aucGrpprl, size_t tBytes,
 		section_block_type *pSection)
 {
-	int	iFodoOff, iInfoLen;
-	USHORT	usCcol;
-	UCHAR	ucTmp;
-
 	fail(aucGrpprl == NULL || pSection == NULL);
 
-	iFodoOff = 0;
-	while (tBytes >= (size_t)iFodoOff + 1) {
-		switch (ucGetByte(iFodoOff, aucGrpprl)) {
-		case 117:	/* bkc */
-			ucTmp = ucGetByte(iFodoOff + 1, aucGrpprl);
-			DBG_DEC(ucTmp);
-			pSection->bNewPage = ucTmp != 0 && ucTmp != 1;
-			break;
-		case 119:	/* ccolM1 */
-			usCcol = 1 + usGetWord(iFodoOff + 1, aucGrpprl);
-			DBG_DEC(usCcol);
-			break;
-		case 128:	/* grpfIhdt */
-			pSection->ucHdrFtrSpecification =
-					ucGetByte(iFodoOff + 1, aucGrpprl);
-			break;
-		default:
-			break;
-		}
-		iInfoLen = iGet2InfoLength(iFodoOff, aucGrpprl);
-		fail(iInfoLen <= 0);
-		iFodoOff += iInfoLen;
-	}
+	vDecodeGrpprl(&tSprm2Table, sprm_target_section,
+			aucGrpprl, (int)tBytes, pSection);
 } /* end of vGet2SectionInfo */
 
 /*
@@ -269,175 +613,25 @@ row_info_enum
 eGet2RowInfo(int iFodo,
 	const UCHAR *aucGrpprl, int iBytes, row_block_type *pRow)
 {
-	int	iFodoOff, iInfoLen;
-	int	iIndex, iSize, iCol;
-	int	iPosCurr, iPosPrev;
-	USHORT	usTmp;
-	BOOL	bFound24_0, bFound24_1, bFound25_0, bFound25_1, bFound154;
+	row_sprm_type	tState;
 
 	fail(iFodo < 0 || aucGrpprl == NULL || pRow == NULL);
 
-	iFodoOff = 0;
-	bFound24_0 = FALSE;
-	bFound24_1 = FALSE;
-	bFound25_0 = FALSE;
-	bFound25_1 = FALSE;
-	bFound154 = FALSE;
-	while (iBytes >= iFodoOff + 1) {
-		iInfoLen = 0;
-		switch (ucGetByte(iFodo + iFodoOff, aucGrpprl)) {
-		case  24:	/* fIntable */
-			if (odd(ucGetByte(iFodo + iFodoOff + 1, aucGrpprl))) {
-				bFound24_1 = TRUE;
-			} else {
-				bFound24_0 = TRUE;
-			}
-			break;
-		case  25:	/* fTtp */
-			if (odd(ucGetByte(iFodo + iFodoOff + 1, aucGrpprl))) {
-				bFound25_1 = TRUE;
-			} else {
-				bFound25_0 = TRUE;
-			}
-			break;
-		case 30:	/* brcTop10 */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			usTmp &= 0x01ff;
-			NO_DBG_DEC(usTmp >> 6);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_TOP;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_TOP;
-			}
-			break;
-		case 31:	/* brcLeft10 */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			usTmp &= 0x01ff;
-			NO_DBG_DEC(usTmp >> 6);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_LEFT;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_LEFT;
-			}
-			break;
-		case 32:	/* brcBottom10 */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			usTmp &= 0x01ff;
-			NO_DBG_DEC(usTmp >> 6);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_BOTTOM;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_BOTTOM;
-			}
-			break;
-		case 33:	/* brcRight10 */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			usTmp &= 0x01ff;
-			NO_DBG_DEC(usTmp >> 6);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_RIGHT;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_RIGHT;
-			}
-			break;
-		case 38:	/* brcTop */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			usTmp &= 0x0018;
-			NO_DBG_DEC(usTmp >> 3);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_TOP;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_TOP;
-			}
-			break;
-		case 39:	/* brcLeft */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			usTmp &= 0x0018;
-			NO_DBG_DEC(usTmp >> 3);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_LEFT;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_LEFT;
-			}
-			break;
-		case 40:	/* brcBottom */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			usTmp &= 0x0018;
-			NO_DBG_DEC(usTmp >> 3);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_BOTTOM;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_BOTTOM;
-			}
-			break;
-		case 41:	/* brcRight */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			usTmp &= 0x0018;
-			NO_DBG_DEC(usTmp >> 3);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_RIGHT;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_RIGHT;
-			}
-			break;
-		case 152:	/* cDefTable10 */
-		case 154:	/* cDefTable */
-			iSize = (int)usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			if (iSize < 6 || iBytes < iFodoOff + 7) {
-				DBG_DEC(iSize);
-				DBG_DEC(iBytes);
-				DBG_DEC(iFodoOff);
-				iInfoLen = 1;
-				break;
-			}
-			iCol = (int)ucGetByte(iFodo + iFodoOff + 3, aucGrpprl);
-			if (iCol < 1 ||
-			    iBytes < iFodoOff + 3 + (iCol + 1) * 2) {
-				DBG_DEC(iCol);
-				DBG_DEC(iBytes);
-				DBG_DEC(iFodoOff);
-				DBG_DEC(ucGetByte(iFodo + iFodoOff, aucGrpprl));
-				iInfoLen = 1;
-				break;
-			}
-			if (iCol >= (int)elementsof(pRow->asColumnWidth)) {
-				DBG_DEC(iCol);
-				werr(1, "The number of columns is corrupt");
-			}
-			pRow->ucNumberOfColumns = (UCHAR)iCol;
-			iPosPrev = (int)(short)usGetWord(
-					iFodo + iFodoOff + 4,
-					aucGrpprl);
-			for (iIndex = 0; iIndex < iCol; iIndex++) {
-				iPosCurr = (int)(short)usGetWord(
-					iFodo + iFodoOff + 6 + iIndex * 2,
-					aucGrpprl);
-				pRow->asColumnWidth[iIndex] =
-						(short)(iPosCurr - iPosPrev);
-				iPosPrev = iPosCurr;
-			}
-			bFound154 = TRUE;
-			break;
-		default:
-			break;
-		}
-		if (iInfoLen <= 0) {
-			iInfoLen =
-				iGet2InfoLength(iFodo + iFodoOff, aucGrpprl);
-			fail(iInfoLen <= 0);
-		}
-		iFodoOff += iInfoLen;
-	}
-	if (bFound24_1 && bFound25_1 && bFound154) {
+	(void)memset(&tState, 0, sizeof(tState));
+	tState.pRow = pRow;
+	vDecodeGrpprl(&tSprm2Table, sprm_target_row,
+			aucGrpprl + iFodo, iBytes, &tState);
+
+	if (tState.bCell1 && tState.bRowEnd1 && tState.bDefTable) {
 		return found_end_of_row;
 	}
-	if (bFound24_0 && bFound25_0 && !bFound154) {
+	if (tState.bCell0 && tState.bRowEnd0 && !tState.bDefTable) {
 		return found_not_end_of_row;
 	}
-	if (bFound24_1) {
+	if (tState.bCell1) {
 		return found_a_cell;
 	}
-	if (bFound24_0) {
+	if (tState.bCell0) {
 		return found_not_a_cell;
 	}
 	return found_nothing;
@@ -451,105 +645,16 @@ void
 vGet2StyleInfo(int iFodo,
 	const UCHAR *aucGrpprl, int iBytes, style_block_type *pStyle)
 {
-	int	iFodoOff, iInfoLen;
-	int	iTmp, iDel, iAdd;
-	short	sTmp;
-	UCHAR	ucTmp;
+	style_sprm_type	tState;
 
 	fail(iFodo < 0 || aucGrpprl == NULL || pStyle == NULL);
 
 	NO_DBG_DEC(pStyle->usIstd);
 
-	iFodoOff = 0;
-	while (iBytes >= iFodoOff + 1) {
-		iInfoLen = 0;
-		switch (ucGetByte(iFodo + iFodoOff, aucGrpprl)) {
-		case   2:	/* istd */
-			sTmp = (short)ucGetByte(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(sTmp);
-			break;
-		case   5:	/* jc */
-			pStyle->ucAlignment = ucGetByte(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			break;
-		case  12:	/* nfcSeqNumb */
-			pStyle->ucNFC = ucGetByte(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			break;
-		case  13:	/* nLvlAnm */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			pStyle->ucNumLevel = ucTmp;
-			pStyle->bNumPause =
-				eGetNumType(ucTmp) == level_type_pause;
-			break;
-		case  15:	/* ChgTabsPapx */
-		case  23:	/* ChgTabs */
-			iTmp = (int)ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			if (iTmp < 2) {
-				iInfoLen = 1;
-				break;
-			}
-			NO_DBG_DEC(iTmp);
-			iDel = (int)ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			if (iTmp < 2 + 2 * iDel) {
-				iInfoLen = 1;
-				break;
-			}
-			NO_DBG_DEC(iDel);
-			iAdd = (int)ucGetByte(
-				iFodo + iFodoOff + 3 + 2 * iDel, aucGrpprl);
-			if (iTmp < 2 + 2 * iDel + 2 * iAdd) {
-				iInfoLen = 1;
-				break;
-			}
-			NO_DBG_DEC(iAdd);
-			break;
-		case  16:	/* dxaRight */
-			pStyle->sRightIndent = (short)usGetWord(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(pStyle->sRightIndent);
-			break;
-		case  17:	/* dxaLeft */
-			pStyle->sLeftIndent = (short)usGetWord(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(pStyle->sLeftIndent);
-			break;
-		case  18:	/* Nest dxaLeft */
-			sTmp = (short)usGetWord(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			pStyle->sLeftIndent += sTmp;
-			if (pStyle->sLeftIndent < 0) {
-				pStyle->sLeftIndent = 0;
-			}
-			NO_DBG_DEC(sTmp);
-			NO_DBG_DEC(pStyle->sLeftIndent);
-			break;
-		case  19:	/* dxaLeft1 */
-			pStyle->sLeftIndent1 = (short)usGetWord(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(pStyle->sLeftIndent1);
-			break;
-		case  21:	/* dyaBefore */
-			pStyle->usBeforeIndent = usGetWord(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(pStyle->usBeforeIndent);
-			break;
-		case  22:	/* dyaAfter */
-			pStyle->usAfterIndent = usGetWord(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(pStyle->usAfterIndent);
-			break;
-		default:
-			break;
-		}
-		if (iInfoLen <= 0) {
-			iInfoLen =
-				iGet2InfoLength(iFodo + iFodoOff, aucGrpprl);
-			fail(iInfoLen <= 0);
-		}
-		iFodoOff += iInfoLen;
-	}
+	(void)memset(&tState, 0, sizeof(tState));
+	tState.pStyle = pStyle;
+	vDecodeGrpprl(&tSprm2Table, sprm_target_style,
+			aucGrpprl + iFodo, iBytes, &tState);
 } /* end of vGet2StyleInfo */
 
 /*
@@ -645,8 +750,14 @@ vGet2PapInfo(FILE *pFile, const UCHAR *aucHeader)
 			ucStc = ucGetByte(iFodo + 1, aucFpage);
 			usIstd = usStc2istd(ucStc);
 
-			vFillStyleFromStylesheet(usIstd, &tStyle);
-			vGet2StyleInfo(iFodo, aucFpage + 8, iLen - 8, &tStyle);
+			if (!bGetCachedStyleInfo(usIstd,
+					aucFpage + 8 + iFodo, iLen - 7, &tStyle)) {
+				vFillStyleFromStylesheet(usIstd, &tStyle);
+				vGet2StyleInfo(iFodo,
+					aucFpage + 8, iLen - 8, &tStyle);
+				vAdd2StyleInfoCache(usIstd,
+					aucFpage + 8 + iFodo, iLen - 7, &tStyle);
+			}
 			ulCharPos = ulGetLong(iIndex2 * 4, aucFpage);
 			NO_DBG_HEX(ulCharPos);
 			tStyle.ulFileOffset = ulCharPos;
@@ -1031,8 +1142,12 @@ vGet2ChrInfo(FILE *pFile, int iWordVersion, const UCHAR *aucHeader)
 			tChrLen = (size_t)ucGetByte(iFodo, aucFpage);
 
 			usIstd = usGetIstd(ulFileOffset);
-			vFillFontFromStylesheet(usIstd, &tFont);
-			if (iFodo != 0) {
+			if (iFodo == 0) {
+				vFillFontFromStylesheet(usIstd, &tFont);
+			} else if (!bGetCachedFontInfo(usIstd,
+					aucFpage + 1 + iFodo, (int)tChrLen,
+					&tFont)) {
+				vFillFontFromStylesheet(usIstd, &tFont);
 				if (iWordVersion == 1) {
 					vGet1FontInfo(iFodo,
 						aucFpage + 1, tChrLen, &tFont);
@@ -1040,6 +1155,9 @@ vGet2ChrInfo(FILE *pFile, int iWordVersion, const UCHAR *aucHeader)
 					vGet2FontInfo(iFodo,
 						aucFpage + 1, tChrLen, &tFont);
 				}
+				vAdd2FontInfoCache(usIstd,
+					aucFpage + 1 + iFodo, (int)tChrLen,
+					&tFont);
 			}
 			tFont.ulFileOffset = ulFileOffset;
 			vAdd2FontInfoList(&tFont);
@@ -11,51 +11,728 @@
 #include "antiword.h"
 
 
+/* The length of every sprm (including the opcode) in Word 6/7 files */
+static const UCHAR	aucSprm6Length[256] = {
+	/*   0 */ 2, 2, 3, SPRM_VAR, 2, 2, 2, 2,
+	/*   8 */ 2, 2, 2, 2, SPRM_VAR, 2, 2, SPRM_VAR,
+	/*  16 */ 3, 3, 3, 3, 5, 3, 3, SPRM_TAB,
+	/*  24 */ 2, 2, 3, 3, 3, 2, 3, 3,
+	/*  32 */ 3, 3, 3, 3, 3, 2, 3, 3,
+	/*  40 */ 3, 3, 3, 3, 2, 3, 3, 3,
+	/*  48 */ 3, 3, 2, 2, 2, 2, 2, 2,
+	/*  56 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/*  64 */ 2, 2, 2, 2, 6, 3, 5, 2,
+	/*  72 */ 3, 4, 5, 2, 2, 2, 2, 2,
+	/*  80 */ 3, SPRM_VAR, 2, 2, 2, 2, 2, 2,
+	/*  88 */ 2, 2, 2, 2, 2, 3, 2, 4,
+	/*  96 */ 3, 3, 2, 3, 2, 3, 2, SPRM_VAR,
+	/* 104 */ 2, 3, 3, 3, SPRM_VAR, 3, 3, 2,
+	/* 112 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 120 */ 13, 3, 3, 3, 3, 2, 2, 2,
+	/* 128 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 136 */ 4, 4, 2, 2, 3, 3, 2, 2,
+	/* 144 */ 3, 3, 2, 2, 3, 3, 2, 2,
+	/* 152 */ 2, 2, 3, 3, 3, 3, 2, 2,
+	/* 160 */ 3, 3, 2, 2, 3, 3, 3, 3,
+	/* 168 */ 3, 3, 3, 3, 2, 2, 2, 2,
+	/* 176 */ 2, 2, 2, 2, 2, 2, 3, 3,
+	/* 184 */ 3, 2, 2, 13, SPRM_VAR, 3, SPRM_VAR, SPRM_VAR,
+	/* 192 */ 5, 6, 5, 3, 5, 3, 3, 6,
+	/* 200 */ 5, 2, 2, 2, 2, 2, 2, 2,
+	/* 208 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 216 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 224 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 232 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 240 */ 2, 2, 2, 2, 2, 2, 2, 2,
+	/* 248 */ 2, 2, 2, 2, 2, 2, 2, 2,
+};
+
 /*
  * iGet6InfoLength - the length of the information for Word 6/7 files
  */
 static int
 iGet6InfoLength(int iByteNbr, const UCHAR *aucGrpprl)
+{
+	return iGetSprmLength(aucSprm6Length, iByteNbr, aucGrpprl);
+} /* end of iGet6InfoLength */
+
+/*
+ * sprmSOlstAnm - the outline list of the section
+ */
+static int
+iSprm6OlstAnm(void *pvSection, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	section_block_type	*pSection;
+	UINT	uiIndex;
+	int	iSize, iTmp;
+	UCHAR	ucTmp;
+
+	pSection = (section_block_type *)pvSection;
+	iSize = (int)ucGetByte(1, aucSprm);
+	DBG_DEC_C(iSize != 212, iSize);
+	for (uiIndex = 0, iTmp = 2;
+	     uiIndex < 9 && iTmp < 2 + iSize - 15;
+	     uiIndex++, iTmp += 16) {
+		pSection->aucNFC[uiIndex] = ucGetByte(iTmp, aucSprm);
+		NO_DBG_DEC(pSection->aucNFC[uiIndex]);
+		ucTmp = ucGetByte(iTmp + 3, aucSprm);
+		NO_DBG_HEX(ucTmp);
+		if ((ucTmp & BIT(2)) != 0) {
+			pSection->usNeedPrevLvl |= (USHORT)BIT(uiIndex);
+		}
+		if ((ucTmp & BIT(3)) != 0) {
+			pSection->usHangingIndent |= (USHORT)BIT(uiIndex);
+		}
+	}
+	DBG_HEX(pSection->usNeedPrevLvl);
+	DBG_HEX(pSection->usHangingIndent);
+	return 0;
+} /* end of iSprm6OlstAnm */
+
+/*
+ * sprmSBkc - the section break code
+ */
+static int
+iSprm6Bkc(void *pvSection, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	section_block_type	*pSection;
+	UCHAR	ucTmp;
+
+	pSection = (section_block_type *)pvSection;
+	ucTmp = ucGetByte(1, aucSprm);
+	DBG_DEC(ucTmp);
+	pSection->bNewPage = ucTmp != 0 && ucTmp != 1;
+	return 0;
+} /* end of iSprm6Bkc */
+
+/*
+ * sprmSCcolumns - the number of columns minus one
+ */
+static int
+iSprm6CcolM1(void *pvSection, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	DBG_DEC(1 + usGetWord(1, aucSprm));
+	return 0;
+} /* end of iSprm6CcolM1 */
+
+/*
+ * sprmSGprfIhdt - the headers and footers of the section
+ */
+static int
+iSprm6GrpfIhdt(void *pvSection, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	section_block_type	*pSection;
+
+	pSection = (section_block_type *)pvSection;
+	pSection->ucHdrFtrSpecification = ucGetByte(1, aucSprm);
+	return 0;
+} /* end of iSprm6GrpfIhdt */
+
+/*
+ * sprmPFInTable - the paragraph is in a table cell
+ */
+static int
+iSprm6InTable(void *pvRow, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	row_sprm_type	*pState;
+
+	pState = (row_sprm_type *)pvRow;
+	if (odd(ucGetByte(1, aucSprm))) {
+		pState->bCell1 = TRUE;
+	} else {
+		pState->bCell0 = TRUE;
+	}
+	return 0;
+} /* end of iSprm6InTable */
+
+/*
+ * sprmPFTtp - the paragraph ends a table row
+ */
+static int
+iSprm6Ttp(void *pvRow, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	row_sprm_type	*pState;
+
+	pState = (row_sprm_type *)pvRow;
+	if (odd(ucGetByte(1, aucSprm))) {
+		pState->bRowEnd1 = TRUE;
+	} else {
+		pState->bRowEnd0 = TRUE;
+	}
+	return 0;
+} /* end of iSprm6Ttp */
+
+/*
+ * sprmPBrcTop and friends - one border, usParam is the border bit
+ */
+static int
+iSprm6Border(void *pvRow, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	row_block_type	*pRow;
+	USHORT	usTmp;
+
+	pRow = ((row_sprm_type *)pvRow)->pRow;
+	usTmp = usGetWord(1, aucSprm);
+	usTmp &= 0x0018;
+	NO_DBG_DEC(usTmp >> 3);
+	if (usTmp == 0) {
+		pRow->ucBorderInfo &= (UCHAR)~usParam;
+	} else {
+		pRow->ucBorderInfo |= (UCHAR)usParam;
+	}
+	return 0;
+} /* end of iSprm6Border */
+
+/*
+ * sprmTDefTable10 - the old style cell definitions
+ */
+static int
+iSprm6DefTable10(void *pvRow, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	DBG_MSG("188: sprmTDefTable10");
+	DBG_DEC(usGetWord(1, aucSprm));
+	return 0;
+} /* end of iSprm6DefTable10 */
+
+/*
+ * sprmTDefTable - the cell definitions
+ */
+static int
+iSprm6DefTable(void *pvRow, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	row_sprm_type	*pState;
+	row_block_type	*pRow;
+	int	iIndex, iSize, iCol;
+	int	iPosCurr, iPosPrev;
+
+	pState = (row_sprm_type *)pvRow;
+	pRow = pState->pRow;
+	iSize = (int)usGetWord(1, aucSprm);
+	if (iSize < 6 || iBytes < 7) {
+		DBG_DEC(iSize);
+		DBG_DEC(iBytes);
+		return 1;
+	}
+	iCol = (int)ucGetByte(3, aucSprm);
+	if (iCol < 1 || iBytes < 3 + (iCol + 1) * 2) {
+		DBG_DEC(iCol);
+		DBG_DEC(iBytes);
+		return 1;
+	}
+	if (iCol >= (int)elementsof(pRow->asColumnWidth)) {
+		DBG_DEC(iCol);
+		werr(1, "The number of columns is corrupt");
+	}
+	pRow->ucNumberOfColumns = (UCHAR)iCol;
+	iPosPrev = (int)(short)usGetWord(4, aucSprm);
+	for (iIndex = 0; iIndex < iCol; iIndex++) {
+		iPosCurr = (int)(short)usGetWord(6 + iIndex * 2, aucSprm);
+		pRow->asColumnWidth[iIndex] = (short)(iPosCurr - iPosPrev);
+		iPosPrev = iPosCurr;
+	}
+	pState->bDefTable = TRUE;
+	return 0;
+} /* end of iSprm6DefTable */
+
+/*
+ * sprmPJc - the alignment of the paragraph
+ */
+static int
+iSprm6Jc(void *pvStyle, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->ucAlignment = ucGetByte(1, aucSprm);
+	return 0;
+} /* end of iSprm6Jc */
+
+/*
+ * sprmPAnld - the list information
+ */
+static int
+iSprm6Anld(void *pvStyle, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	style_block_type	*pStyle;
+	int	iTmp, iBefore;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	iTmp = (int)ucGetByte(1, aucSprm);
+	DBG_DEC_C(iTmp < 52, iTmp);
+	if (iTmp >= 1) {
+		pStyle->ucNFC = ucGetByte(2, aucSprm);
+	}
+	if (pStyle->ucNFC != LIST_BULLETS && iTmp >= 2) {
+		iBefore = (int)ucGetByte(3, aucSprm);
+	} else {
+		iBefore = 0;
+	}
+	if (iTmp >= 12) {
+		pStyle->usStartAt = usGetWord(12, aucSprm);
+	}
+	if (iTmp >= iBefore + 21) {
+		pStyle->usListChar = (USHORT)ucGetByte(iBefore + 22, aucSprm);
+		NO_DBG_HEX(pStyle->usListChar);
+	}
+	return 0;
+} /* end of iSprm6Anld */
+
+/*
+ * sprmPNLvlAnm - the list level of the paragraph
+ */
+static int
+iSprm6NLvlAnm(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+	UCHAR	ucTmp;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	ucTmp = ucGetByte(1, aucSprm);
+	pStyle->ucNumLevel = ucTmp;
+	pStyle->bNumPause = eGetNumType(ucTmp) == level_type_pause;
+	return 0;
+} /* end of iSprm6NLvlAnm */
+
+/*
+ * sprmPChgTabsPapx and sprmPChgTabs - the tab stops
+ *
+ * Returns 1 to skip only the opcode when the operand is corrupt
+ */
+static int
+iSprm6ChgTabs(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
 {
 	int	iTmp, iDel, iAdd;
 
-	switch (ucGetByte(iByteNbr, aucGrpprl)) {
-	case   2: case  16: case  17: case  18: case  19: case  21: case  22:
-	case  26: case  27: case  28: case  30: case  31: case  32: case  33:
-	case  34: case  35: case  36: case  38: case  39: case  40: case  41:
-	case  42: case  43: case  45: case  46: case  47: case  48: case  49:
-	case  69: case  72: case  80: case  93: case  96: case  97: case  99:
-	case 101: case 105: case 106: case 107: case 109: case 110: case 121:
-	case 122: case 123: case 124: case 140: case 141: case 144: case 145:
-	case 148: case 149: case 154: case 155: case 156: case 157: case 160:
-	case 161: case 164: case 165: case 166: case 167: case 168: case 169:
-	case 170: case 171: case 182: case 183: case 184: case 189: case 195:
-	case 197: case 198:
-		return 1 + 2;
-	case   3: case  12: case  15: case  81: case 103: case 108: case 188:
-	case 190: case 191:
-		return 2 + (int)ucGetByte(iByteNbr + 1, aucGrpprl);
-	case  20: case  70: case  74: case 192: case 194: case 196: case 200:
-		return 1 + 4;
-	case  23:
-		iTmp = (int)ucGetByte(iByteNbr + 1, aucGrpprl);
-		if (iTmp == 255) {
-			iDel = (int)ucGetByte(iByteNbr + 2, aucGrpprl);
-			iAdd = (int)ucGetByte(
-					iByteNbr + 3 + iDel * 4, aucGrpprl);
-			iTmp = 2 + iDel * 4 + iAdd * 3;
+	iTmp = (int)ucGetByte(1, aucSprm);
+	if (iTmp < 2) {
+		return 1;
+	}
+	NO_DBG_DEC(iTmp);
+	iDel = (int)ucGetByte(2, aucSprm);
+	if (iTmp < 2 + 2 * iDel) {
+		return 1;
+	}
+	NO_DBG_DEC(iDel);
+	iAdd = (int)ucGetByte(3 + 2 * iDel, aucSprm);
+	if (iTmp < 2 + 2 * iDel + 2 * iAdd) {
+		return 1;
+	}
+	NO_DBG_DEC(iAdd);
+	return 0;
+} /* end of iSprm6ChgTabs */
+
+/*
+ * sprmPDxaRight - the right indentation
+ */
+static int
+iSprm6DxaRight(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->sRightIndent = (short)usGetWord(1, aucSprm);
+	NO_DBG_DEC(pStyle->sRightIndent);
+	return 0;
+} /* end of iSprm6DxaRight */
+
+/*
+ * sprmPDxaLeft - the left indentation
+ */
+static int
+iSprm6DxaLeft(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->sLeftIndent = (short)usGetWord(1, aucSprm);
+	NO_DBG_DEC(pStyle->sLeftIndent);
+	return 0;
+} /* end of iSprm6DxaLeft */
+
+/*
+ * sprmPNest - the nested left indentation
+ */
+static int
+iSprm6Nest(void *pvStyle, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	style_block_type	*pStyle;
+	short	sTmp;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	sTmp = (short)usGetWord(1, aucSprm);
+	pStyle->sLeftIndent += sTmp;
+	if (pStyle->sLeftIndent < 0) {
+		pStyle->sLeftIndent = 0;
+	}
+	NO_DBG_DEC(sTmp);
+	NO_DBG_DEC(pStyle->sLeftIndent);
+	return 0;
+} /* end of iSprm6Nest */
+
+/*
+ * sprmPDxaLeft1 - the first line indentation
+ */
+static int
+iSprm6DxaLeft1(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->sLeftIndent1 = (short)usGetWord(1, aucSprm);
+	NO_DBG_DEC(pStyle->sLeftIndent1);
+	return 0;
+} /* end of iSprm6DxaLeft1 */
+
+/*
+ * sprmPDyaBefore - the space before the paragraph
+ */
+static int
+iSprm6DyaBefore(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->usBeforeIndent = usGetWord(1, aucSprm);
+	NO_DBG_DEC(pStyle->usBeforeIndent);
+	return 0;
+} /* end of iSprm6DyaBefore */
+
+/*
+ * sprmPDyaAfter - the space after the paragraph
+ */
+static int
+iSprm6DyaAfter(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->usAfterIndent = usGetWord(1, aucSprm);
+	NO_DBG_DEC(pStyle->usAfterIndent);
+	return 0;
+} /* end of iSprm6DyaAfter */
+
+/*
+ * sprmCFRMarkDel - the text is marked as deleted
+ */
+static int
+iSprm6MarkDel(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	if (ucGetByte(1, aucSprm) == 0) {
+		pFont->usFontStyle &= ~FONT_MARKDEL;
+	} else {
+		pFont->usFontStyle |= FONT_MARKDEL;
+	}
+	return 0;
+} /* end of iSprm6MarkDel */
+
+/*
+ * sprmCDefault - back to the default character properties
+ */
+static int
+iSprm6Default(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	pFont->usFontStyle &= FONT_HIDDEN;
+	pFont->ucFontColor = FONT_COLOR_DEFAULT;
+	return 0;
+} /* end of iSprm6Default */
+
+/*
+ * sprmCPlain - back to the character properties of the style
+ */
+static int
+iSprm6Plain(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_sprm_type	*pState;
+
+	pState = (font_sprm_type *)pvFont;
+	DBG_MSG("83: cPlain");
+	vFillFontFromStylesheet(pState->usIstd, pState->pFont);
+	return 0;
+} /* end of iSprm6Plain */
+
+/*
+ * sprmCFBold and friends - a toggling property, usParam is the font style
+ */
+static int
+iSprm6Toggle(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	vSetFontToggle(((font_sprm_type *)pvFont)->pFont,
+			usParam, ucGetByte(1, aucSprm));
+	return 0;
+} /* end of iSprm6Toggle */
+
+/*
+ * sprmCFtc - the font number
+ */
+static int
+iSprm6Ftc(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+	USHORT	usTmp;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	usTmp = usGetWord(1, aucSprm);
+	if (usTmp <= (USHORT)UCHAR_MAX) {
+		pFont->ucFontNumber = (UCHAR)usTmp;
+	} else {
+		DBG_DEC(usTmp);
+		DBG_FIXME();
+		pFont->ucFontNumber = 0;
+	}
+	return 0;
+} /* end of iSprm6Ftc */
+
+/*
+ * sprmCKul - the underline code
+ */
+static int
+iSprm6Kul(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+	UCHAR	ucTmp;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	ucTmp = ucGetByte(1, aucSprm);
+	if (ucTmp == 0 || ucTmp == 5) {
+		pFont->usFontStyle &= ~FONT_UNDERLINE;
+	} else {
+		NO_DBG_MSG("Underline text");
+		pFont->usFontStyle |= FONT_UNDERLINE;
+		if (ucTmp == 6) {
+			DBG_MSG("Bold text");
+			pFont->usFontStyle |= FONT_BOLD;
 		}
-		return 2 + iTmp;
-	case  68: case 193: case 199:
-		return 1 + 5;
-	case  73: case  95: case 136: case 137:
-		return 1 + 3;
-	case 120: case 187:
-		return 1 + 12;
-	default:
-		return 1 + 1;
 	}
-} /* end of iGet6InfoLength */
+	return 0;
+} /* end of iSprm6Kul */
+
+/*
+ * sprmCSizePos - the font size and the position
+ */
+static int
+iSprm6HpsPos(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+	UCHAR	ucTmp;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	ucTmp = ucGetByte(1, aucSprm);
+	DBG_DEC(ucTmp);
+	if (ucTmp != 0) {
+		pFont->usFontSize = (USHORT)ucTmp;
+	}
+	DBG_DEC(ucGetByte(2, aucSprm));
+	return 0;
+} /* end of iSprm6HpsPos */
+
+/*
+ * sprmCIco - the colour of the text
+ */
+static int
+iSprm6Ico(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	pFont->ucFontColor = ucGetByte(1, aucSprm);
+	return 0;
+} /* end of iSprm6Ico */
+
+/*
+ * sprmCHps - the font size
+ */
+static int
+iSprm6Hps(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	pFont->usFontSize = usGetWord(1, aucSprm);
+	return 0;
+} /* end of iSprm6Hps */
+
+/*
+ * sprmCHpsInc - increment the font size
+ */
+static int
+iSprm6HpsInc(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	DBG_MSG("100: sprmCHpsInc");
+	DBG_DEC(ucGetByte(1, aucSprm));
+	return 0;
+} /* end of iSprm6HpsInc */
+
+/*
+ * sprmCMajority and sprmCMajority50 - compare with the style
+ */
+static int
+iSprm6Majority(void *pvFont, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	DBG_DEC(ucGetByte(0, aucSprm));
+	DBG_MSG("sprmCMajority");
+	return 0;
+} /* end of iSprm6Majority */
+
+/*
+ * sprmCIss - superscript or subscript
+ */
+static int
+iSprm6Iss(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+	UCHAR	ucTmp;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	ucTmp = ucGetByte(1, aucSprm);
+	ucTmp &= 0x07;
+	if (ucTmp == 1) {
+		pFont->usFontStyle |= FONT_SUPERSCRIPT;
+		NO_DBG_MSG("Superscript");
+	} else if (ucTmp == 2) {
+		pFont->usFontStyle |= FONT_SUBSCRIPT;
+		NO_DBG_MSG("Subscript");
+	}
+	return 0;
+} /* end of iSprm6Iss */
+
+/*
+ * sprmCHpsInc1 - increment the font size
+ */
+static int
+iSprm6HpsInc1(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+	long	lTmp;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	lTmp = (long)pFont->usFontSize + (long)usGetWord(1, aucSprm);
+	if (lTmp < 8) {
+		pFont->usFontSize = 8;
+	} else if (lTmp > 32766) {
+		pFont->usFontSize = 32766;
+	} else {
+		pFont->usFontSize = (USHORT)lTmp;
+	}
+	return 0;
+} /* end of iSprm6HpsInc1 */
+
+/*
+ * sprmCHpsMul - multiply the font size
+ */
+static int
+iSprm6HpsMul(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	DBG_MSG("109: sprmCHpsMul");
+	DBG_DEC(usGetWord(1, aucSprm));
+	return 0;
+} /* end of iSprm6HpsMul */
+
+/*
+ * sprmCPicLocation - the location of the picture
+ */
+static int
+iSprm6FcPic(void *pvPicture, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	picture_sprm_type	*pState;
+
+	pState = (picture_sprm_type *)pvPicture;
+	pState->pPicture->ulPictureOffset = ulGetLong(2, aucSprm);
+	pState->bFound = TRUE;
+	return 0;
+} /* end of iSprm6FcPic */
+
+/*
+ * sprmCFOle2 - the picture is an OLE object
+ */
+static int
+iSprm6Ole2(void *pvPicture, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	UCHAR	ucTmp;
+
+	ucTmp = ucGetByte(1, aucSprm);
+	if (ucTmp == 0x01) {
+		/* Not a picture, but an OLE object */
+		((picture_sprm_type *)pvPicture)->bOle = TRUE;
+	}
+	DBG_DEC_C(ucTmp != 0 && ucTmp != 0x01, ucTmp);
+	return 0;
+} /* end of iSprm6Ole2 */
+
+/*
+ * The Word 6/7 opcodes, sorted by opcode.
+ * The handlers are for the section, row, style, font and picture information
+ */
+static const sprm_type	atSprm6[] = {
+	{   5, 0, { NULL, NULL, iSprm6Jc, NULL, NULL } },
+	{  12, 0, { NULL, NULL, iSprm6Anld, NULL, NULL } },
+	{  13, 0, { NULL, NULL, iSprm6NLvlAnm, NULL, NULL } },
+	{  15, 0, { NULL, NULL, iSprm6ChgTabs, NULL, NULL } },
+	{  16, 0, { NULL, NULL, iSprm6DxaRight, NULL, NULL } },
+	{  17, 0, { NULL, NULL, iSprm6DxaLeft, NULL, NULL } },
+	{  18, 0, { NULL, NULL, iSprm6Nest, NULL, NULL } },
+	{  19, 0, { NULL, NULL, iSprm6DxaLeft1, NULL, NULL } },
+	{  21, 0, { NULL, NULL, iSprm6DyaBefore, NULL, NULL } },
+	{  22, 0, { NULL, NULL, iSprm6DyaAfter, NULL, NULL } },
+	{  23, 0, { NULL, NULL, iSprm6ChgTabs, NULL, NULL } },
+	{  24, 0, { NULL, iSprm6InTable, NULL, NULL, NULL } },
+	{  25, 0, { NULL, iSprm6Ttp, NULL, NULL, NULL } },
+	{  38, TABLE_BORDER_TOP, { NULL, iSprm6Border, NULL, NULL, NULL } },
+	{  39, TABLE_BORDER_LEFT, { NULL, iSprm6Border, NULL, NULL, NULL } },
+	{  40, TABLE_BORDER_BOTTOM, { NULL, iSprm6Border, NULL, NULL, NULL } },
+	{  41, TABLE_BORDER_RIGHT, { NULL, iSprm6Border, NULL, NULL, NULL } },
+	{  65, 0, { NULL, NULL, NULL, iSprm6MarkDel, NULL } },
+	{  68, 0, { NULL, NULL, NULL, NULL, iSprm6FcPic } },
+	{  75, 0, { NULL, NULL, NULL, NULL, iSprm6Ole2 } },
+	{  82, 0, { NULL, NULL, NULL, iSprm6Default, NULL } },
+	{  83, 0, { NULL, NULL, NULL, iSprm6Plain, NULL } },
+	{  85, FONT_BOLD, { NULL, NULL, NULL, iSprm6Toggle, NULL } },
+	{  86, FONT_ITALIC, { NULL, NULL, NULL, iSprm6Toggle, NULL } },
+	{  87, FONT_STRIKE, { NULL, NULL, NULL, iSprm6Toggle, NULL } },
+	{  90, FONT_SMALL_CAPITALS, { NULL, NULL, NULL, iSprm6Toggle, NULL } },
+	{  91, FONT_CAPITALS, { NULL, NULL, NULL, iSprm6Toggle, NULL } },
+	{  92, FONT_HIDDEN, { NULL, NULL, NULL, iSprm6Toggle, NULL } },
+	{  93, 0, { NULL, NULL, NULL, iSprm6Ftc, NULL } },
+	{  94, 0, { NULL, NULL, NULL, iSprm6Kul, NULL } },
+	{  95, 0, { NULL, NULL, NULL, iSprm6HpsPos, NULL } },
+	{  98, 0, { NULL, NULL, NULL, iSprm6Ico, NULL } },
+	{  99, 0, { NULL, NULL, NULL, iSprm6Hps, NULL } },
+	{ 100, 0, { NULL, NULL, NULL, iSprm6HpsInc, NULL } },
+	{ 103, 0, { NULL, NULL, NULL, iSprm6Majority, NULL } },
+	{ 104, 0, { NULL, NULL, NULL, iSprm6Iss, NULL } },
+	{ 106, 0, { NULL, NULL, NULL, iSprm6HpsInc1, NULL } },
+	{ 108, 0, { NULL, NULL, NULL, iSprm6Majority, NULL } },
+	{ 109, 0, { NULL, NULL, NULL, iSprm6HpsMul, NULL } },
+	{ 133, 0, { iSprm6OlstAnm, NULL, NULL, NULL, NULL } },
+	{ 142, 0, { iSprm6Bkc, NULL, NULL, NULL, NULL } },
+	{ 144, 0, { iSprm6CcolM1, NULL, NULL, NULL, NULL } },
+	{ 153, 0, { iSprm6GrpfIhdt, NULL, NULL, NULL, NULL } },
+	{ 188, 0, { NULL, iSprm6DefTable10, NULL, NULL, NULL } },
+	{ 190, 0, { NULL, iSprm6DefTable, NULL, NULL, NULL } },
+};
+
+static const sprm_table_type	tSprm6Table = {
+	atSprm6, elementsof(atSprm6), 1, iGet6InfoLength
+};
 
 /*
  * Build the lists with Document Property Information for Word 6/7 files
@@ -108,62 +785,10 @@ static void
 vGet6SectionInfo(const UCHAR *aucGrpprl, size_t tBytes,
 		section_block_type *pSection)
 {
-	UINT	uiIndex;
-	int	iFodoOff, iInfoLen, iSize, iTmp;
-	USHORT	usCcol;
-	UCHAR	ucTmp;
-
 	fail(aucGrpprl == NULL || pSection == NULL);
 
-	iFodoOff = 0;
-	while (tBytes >= (size_t)iFodoOff + 1) {
-		iInfoLen = 0;
-		switch (ucGetByte(iFodoOff, aucGrpprl)) {
-		case 133:	/* olstAnm */
-			iSize = (int)ucGetByte(iFodoOff + 1, aucGrpprl);
-			DBG_DEC_C(iSize != 212, iSize);
-			for (uiIndex = 0, iTmp = iFodoOff + 2;
-			     uiIndex < 9 && iTmp < iFodoOff + 2 + iSize - 15;
-			     uiIndex++, iTmp += 16) {
-				pSection->aucNFC[uiIndex] =
-						ucGetByte(iTmp, aucGrpprl);
-				NO_DBG_DEC(pSection->aucNFC[uiIndex]);
-				ucTmp = ucGetByte(iTmp + 3, aucGrpprl);
-				NO_DBG_HEX(ucTmp);
-				if ((ucTmp & BIT(2)) != 0) {
-					pSection->usNeedPrevLvl |=
-							(USHORT)BIT(uiIndex);
-				}
-				if ((ucTmp & BIT(3)) != 0) {
-					pSection->usHangingIndent |=
-							(USHORT)BIT(uiIndex);
-				}
-			}
-			DBG_HEX(pSection->usNeedPrevLvl);
-			DBG_HEX(pSection->usHangingIndent);
-			break;
-		case 142:	/* bkc */
-			ucTmp = ucGetByte(iFodoOff + 1, aucGrpprl);
-			DBG_DEC(ucTmp);
-			pSection->bNewPage = ucTmp != 0 && ucTmp != 1;
-			break;
-		case 144:	/* ccolM1 */
-			usCcol = 1 + usGetWord(iFodoOff + 1, aucGrpprl);
-			DBG_DEC(usCcol);
-			break;
-		case 153:	/* grpfIhdt */
-			pSection->ucHdrFtrSpecification =
-					ucGetByte(iFodoOff + 1, aucGrpprl);
-			break;
-		default:
-			break;
-		}
-		if (iInfoLen <= 0) {
-			iInfoLen = iGet6InfoLength(iFodoOff, aucGrpprl);
-			fail(iInfoLen <= 0);
-		}
-		iFodoOff += iInfoLen;
-	}
+	vDecodeGrpprl(&tSprm6Table, sprm_target_section,
+			aucGrpprl, (int)tBytes, pSection);
 } /* end of vGet6SectionInfo */
 
 /*
@@ -316,137 +941,25 @@ row_info_enum
 eGet6RowInfo(int iFodo,
 	const UCHAR *aucGrpprl, int iBytes, row_block_type *pRow)
 {
-	int	iFodoOff, iInfoLen;
-	int	iIndex, iSize, iCol;
-	int	iPosCurr, iPosPrev;
-	USHORT	usTmp;
-	BOOL	bFound24_0, bFound24_1, bFound25_0, bFound25_1, bFound190;
+	row_sprm_type	tState;
 
 	fail(iFodo < 0 || aucGrpprl == NULL || pRow == NULL);
 
-	iFodoOff = 0;
-	bFound24_0 = FALSE;
-	bFound24_1 = FALSE;
-	bFound25_0 = FALSE;
-	bFound25_1 = FALSE;
-	bFound190 = FALSE;
-	while (iBytes >= iFodoOff + 1) {
-		iInfoLen = 0;
-		switch (ucGetByte(iFodo + iFodoOff, aucGrpprl)) {
-		case  24:	/* fInTable */
-			if (odd(ucGetByte(iFodo + iFodoOff + 1, aucGrpprl))) {
-				bFound24_1 = TRUE;
-			} else {
-				bFound24_0 = TRUE;
-			}
-			break;
-		case  25:	/* fTtp */
-			if (odd(ucGetByte(iFodo + iFodoOff + 1, aucGrpprl))) {
-				bFound25_1 = TRUE;
-			} else {
-				bFound25_0 = TRUE;
-			}
-			break;
-		case 38:	/* brcTop */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			usTmp &= 0x0018;
-			NO_DBG_DEC(usTmp >> 3);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_TOP;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_TOP;
-			}
-			break;
-		case 39:	/* brcLeft */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			usTmp &= 0x0018;
-			NO_DBG_DEC(usTmp >> 3);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_LEFT;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_LEFT;
-			}
-			break;
-		case 40:	/* brcBottom */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			usTmp &= 0x0018;
-			NO_DBG_DEC(usTmp >> 3);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_BOTTOM;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_BOTTOM;
-			}
-			break;
-		case 41:	/* brcRight */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			usTmp &= 0x0018;
-			NO_DBG_DEC(usTmp >> 3);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_RIGHT;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_RIGHT;
-			}
-			break;
-		case 188:	/* cDefTable10 */
-			DBG_MSG("188: sprmTDefTable10");
-			iSize = (int)usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			DBG_DEC(iSize);
-			break;
-		case 190:	/* cDefTable */
-			iSize = (int)usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			if (iSize < 6 || iBytes < iFodoOff + 7) {
-				DBG_DEC(iSize);
-				DBG_DEC(iFodoOff);
-				iInfoLen = 1;
-				break;
-			}
-			iCol = (int)ucGetByte(iFodo + iFodoOff + 3, aucGrpprl);
-			if (iCol < 1 ||
-			    iBytes < iFodoOff + 3 + (iCol + 1) * 2) {
-				DBG_DEC(iCol);
-				DBG_DEC(iFodoOff);
-				iInfoLen = 1;
-				break;
-			}
-			if (iCol >= (int)elementsof(pRow->asColumnWidth)) {
-				DBG_DEC(iCol);
-				werr(1, "The number of columns is corrupt");
-			}
-			pRow->ucNumberOfColumns = (UCHAR)iCol;
-			iPosPrev = (int)(short)usGetWord(
-					iFodo + iFodoOff + 4,
-					aucGrpprl);
-			for (iIndex = 0; iIndex < iCol; iIndex++) {
-				iPosCurr = (int)(short)usGetWord(
-					iFodo + iFodoOff + 6 + iIndex * 2,
-					aucGrpprl);
-				pRow->asColumnWidth[iIndex] =
-						(short)(iPosCurr - iPosPrev);
-				iPosPrev = iPosCurr;
-			}
-			bFound190 = TRUE;
-			break;
-		default:
-			break;
-		}
-		if (iInfoLen <= 0) {
-			iInfoLen =
-				iGet6InfoLength(iFodo + iFodoOff, aucGrpprl);
-			fail(iInfoLen <= 0);
-		}
-		iFodoOff += iInfoLen;
-	}
+	(void)memset(&tState, 0, sizeof(tState));
+	tState.pRow = pRow;
+	vDecodeGrpprl(&tSprm6Table, sprm_target_row,
+			aucGrpprl + iFodo, iBytes, &tState);
 
-	if (bFound25_1 && bFound190) {
+	if (tState.bRowEnd1 && tState.bDefTable) {
 		return found_end_of_row;
 	}
-	if (bFound25_0 && !bFound190) {
+	if (tState.bRowEnd0 && !tState.bDefTable) {
 		return found_not_end_of_row;
 	}
-	if (bFound24_1) {
+	if (tState.bCell1) {
 		return found_a_cell;
 	}
-	if (bFound24_0) {
+	if (tState.bCell0) {
 		return found_not_a_cell;
 	}
 	return found_nothing;
@@ -460,126 +973,16 @@ void
 vGet6StyleInfo(int iFodo,
 	const UCHAR *aucGrpprl, int iBytes, style_block_type *pStyle)
 {
-	int	iFodoOff, iInfoLen;
-	int	iTmp, iDel, iAdd, iBefore;
-	short	sTmp;
-	UCHAR	ucTmp;
+	style_sprm_type	tState;
 
 	fail(iFodo < 0 || aucGrpprl == NULL || pStyle == NULL);
 
 	NO_DBG_DEC(pStyle->usIstd);
 
-	iFodoOff = 0;
-	while (iBytes >= iFodoOff + 1) {
-		iInfoLen = 0;
-		switch (ucGetByte(iFodo + iFodoOff, aucGrpprl)) {
-		case   2:	/* istd */
-			sTmp = (short)ucGetByte(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(sTmp);
-			break;
-		case   5:	/* jc */
-			pStyle->ucAlignment = ucGetByte(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			break;
-		case  12:	/* anld */
-			iTmp = (int)ucGetByte(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			DBG_DEC_C(iTmp < 52, iTmp);
-			if (iTmp >= 1) {
-				pStyle->ucNFC = ucGetByte(
-					iFodo + iFodoOff + 2, aucGrpprl);
-			}
-			if (pStyle->ucNFC != LIST_BULLETS && iTmp >= 2) {
-				iBefore = (int)ucGetByte(
-					iFodo + iFodoOff + 3, aucGrpprl);
-			} else {
-				iBefore = 0;
-			}
-			if (iTmp >= 12) {
-				pStyle->usStartAt = usGetWord(
-					iFodo + iFodoOff + 12, aucGrpprl);
-			}
-			if (iTmp >= iBefore + 21) {
-				pStyle->usListChar = (USHORT)ucGetByte(
-					iFodo + iFodoOff + iBefore + 22,
-					aucGrpprl);
-				NO_DBG_HEX(pStyle->usListChar);
-			}
-			break;
-		case  13:	/* nLvlAnm */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			pStyle->ucNumLevel = ucTmp;
-			pStyle->bNumPause =
-				eGetNumType(ucTmp) == level_type_pause;
-			break;
-		case  15:	/* ChgTabsPapx */
-		case  23:	/* ChgTabs */
-			iTmp = (int)ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			if (iTmp < 2) {
-				iInfoLen = 1;
-				break;
-			}
-			NO_DBG_DEC(iTmp);
-			iDel = (int)ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			if (iTmp < 2 + 2 * iDel) {
-				iInfoLen = 1;
-				break;
-			}
-			NO_DBG_DEC(iDel);
-			iAdd = (int)ucGetByte(
-				iFodo + iFodoOff + 3 + 2 * iDel, aucGrpprl);
-			if (iTmp < 2 + 2 * iDel + 2 * iAdd) {
-				iInfoLen = 1;
-				break;
-			}
-			NO_DBG_DEC(iAdd);
-			break;
-		case  16:	/* dxaRight */
-			pStyle->sRightIndent = (short)usGetWord(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(pStyle->sRightIndent);
-			break;
-		case  17:	/* dxaLeft */
-			pStyle->sLeftIndent = (short)usGetWord(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(pStyle->sLeftIndent);
-			break;
-		case  18:	/* Nest dxaLeft */
-			sTmp = (short)usGetWord(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			pStyle->sLeftIndent += sTmp;
-			if (pStyle->sLeftIndent < 0) {
-				pStyle->sLeftIndent = 0;
-			}
-			NO_DBG_DEC(sTmp);
-			NO_DBG_DEC(pStyle->sLeftIndent);
-			break;
-		case  19:	/* dxaLeft1 */
-			pStyle->sLeftIndent1 = (short)usGetWord(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(pStyle->sLeftIndent1);
-			break;
-		case  21:	/* dyaBefore */
-			pStyle->usBeforeIndent = usGetWord(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(pStyle->usBeforeIndent);
-			break;
-		case  22:	/* dyaAfter */
-			pStyle->usAfterIndent = usGetWord(
-					iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(pStyle->usAfterIndent);
-			break;
-		default:
-			break;
-		}
-		if (iInfoLen <= 0) {
-			iInfoLen =
-				iGet6InfoLength(iFodo + iFodoOff, aucGrpprl);
-			fail(iInfoLen <= 0);
-		}
-		iFodoOff += iInfoLen;
-	}
+	(void)memset(&tState, 0, sizeof(tState));
+	tState.pStyle = pStyle;
+	vDecodeGrpprl(&tSprm6Table, sprm_target_style,
+			aucGrpprl + iFodo, iBytes, &tState);
 } /* end of vGet6StyleInfo */
 
 /*
@@ -592,6 +995,7 @@ vGet6PapInfo(FILE *pFile, ULONG ulStartBlock,
 {
 	row_block_type		tRow;
 	style_block_type	tStyle;
+	fkp_run_type		atRun[FKP_RUNS_MAX];
 	USHORT	*ausParfPage;
 	UCHAR	*aucBuffer;
 	ULONG	ulCharPos, ulCharPosFirst, ulCharPosLast;
@@ -664,12 +1068,11 @@ vGet6PapInfo(FILE *pFile, ULONG ulStartBlock,
 				BIG_BLOCK_SIZE)) {
 			break;
 		}
-		tRun = (size_t)ucGetByte(0x1ff, aucFpage);
+		tRun = tGetFkpRuns(aucFpage, 7, atRun);
 		NO_DBG_DEC(tRun);
 		for (tIndex2 = 0; tIndex2 < tRun; tIndex2++) {
-			NO_DBG_HEX(ulGetLong(tIndex2 * 4, aucFpage));
-			iFodo = 2 * (int)ucGetByte(
-				(tRun + 1) * 4 + tIndex2 * 7, aucFpage);
+			NO_DBG_HEX(atRun[tIndex2].ulCharPosStart);
+			iFodo = atRun[tIndex2].iFodo;
 			if (iFodo <= 0) {
 				continue;
 			}
@@ -677,9 +1080,15 @@ vGet6PapInfo(FILE *pFile, ULONG ulStartBlock,
 			iLen = 2 * (int)ucGetByte(iFodo, aucFpage);
 
 			usIstd = (USHORT)ucGetByte(iFodo + 1, aucFpage);
-			vFillStyleFromStylesheet(usIstd, &tStyle);
-			vGet6StyleInfo(iFodo, aucFpage + 3, iLen - 3, &tStyle);
-			ulCharPos = ulGetLong(tIndex2 * 4, aucFpage);
+			if (!bGetCachedStyleInfo(usIstd,
+					aucFpage + 3 + iFodo, iLen - 2, &tStyle)) {
+				vFillStyleFromStylesheet(usIstd, &tStyle);
+				vGet6StyleInfo(iFodo,
+					aucFpage + 3, iLen - 3, &tStyle);
+				vAdd2StyleInfoCache(usIstd,
+					aucFpage + 3 + iFodo, iLen - 2, &tStyle);
+			}
+			ulCharPos = atRun[tIndex2].ulCharPosStart;
 			NO_DBG_HEX(ulCharPos);
 			tStyle.ulFileOffset = ulCharPos2FileOffsetX(
 				ulCharPos, &tStyle.eListID);
@@ -692,8 +1101,7 @@ vGet6PapInfo(FILE *pFile, ULONG ulStartBlock,
 				if (ulCharPosFirst != CP_INVALID) {
 					break;
 				}
-				ulCharPosFirst = ulGetLong(
-						tIndex2 * 4, aucFpage);
+				ulCharPosFirst = atRun[tIndex2].ulCharPosStart;
 				NO_DBG_HEX(ulCharPosFirst);
 				tRow.ulCharPosStart = ulCharPosFirst;
 				tRow.ulFileOffsetStart =
@@ -702,8 +1110,7 @@ vGet6PapInfo(FILE *pFile, ULONG ulStartBlock,
 							ulCharPosFirst);
 				break;
 			case found_end_of_row:
-				ulCharPosLast = ulGetLong(
-						tIndex2 * 4, aucFpage);
+				ulCharPosLast = atRun[tIndex2].ulCharPosStart;
 				NO_DBG_HEX(ulCharPosLast);
 				tRow.ulCharPosEnd = ulCharPosLast;
 				tRow.ulFileOffsetEnd =
@@ -734,243 +1141,17 @@ void
 vGet6FontInfo(int iFodo, USHORT usIstd,
 	const UCHAR *aucGrpprl, int iBytes, font_block_type *pFont)
 {
-	long	lTmp;
-	int	iFodoOff, iInfoLen;
-	USHORT	usTmp;
-	UCHAR	ucTmp;
+	font_sprm_type	tState;
 
 	TRACE_MSG("vGet6FontInfo");
 
 	fail(iFodo < 0 || aucGrpprl == NULL || pFont == NULL);
 
-	iFodoOff = 0;
-	while (iBytes >= iFodoOff + 1) {
-		switch (ucGetByte(iFodo + iFodoOff, aucGrpprl)) {
-		case  65:	/* fRMarkDel */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			if (ucTmp == 0) {
-				pFont->usFontStyle &= ~FONT_MARKDEL;
-			} else {
-				pFont->usFontStyle |= FONT_MARKDEL;
-			}
-			break;
-		case  80:	/* cIstd */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			NO_DBG_DEC(usTmp);
-			break;
-		case  82:	/* cDefault */
-			pFont->usFontStyle &= FONT_HIDDEN;
-			pFont->ucFontColor = FONT_COLOR_DEFAULT;
-			break;
-		case  83:	/* cPlain */
-			DBG_MSG("83: cPlain");
-			vFillFontFromStylesheet(usIstd, pFont);
-			break;
-		case  85:	/* fBold */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			switch (ucTmp) {
-			case   0:	/* Unset */
-				pFont->usFontStyle &= ~FONT_BOLD;
-				break;
-			case   1:	/* Set */
-				pFont->usFontStyle |= FONT_BOLD;
-				break;
-			case 128:	/* Unchanged */
-				break;
-			case 129:	/* Negation */
-				pFont->usFontStyle ^= FONT_BOLD;
-				break;
-			default:
-				DBG_DEC(ucTmp);
-				DBG_FIXME();
-				break;
-			}
-			break;
-		case  86:	/* fItalic */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			switch (ucTmp) {
-			case   0:	/* Unset */
-				pFont->usFontStyle &= ~FONT_ITALIC;
-				break;
-			case   1:	/* Set */
-				pFont->usFontStyle |= FONT_ITALIC;
-				break;
-			case 128:	/* Unchanged */
-				break;
-			case 129:	/* Negation */
-				pFont->usFontStyle ^= FONT_ITALIC;
-				break;
-			default:
-				DBG_DEC(ucTmp);
-				DBG_FIXME();
-				break;
-			}
-			break;
-		case  87:	/* fStrike */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			switch (ucTmp) {
-			case   0:	/* Unset */
-				pFont->usFontStyle &= ~FONT_STRIKE;
-				break;
-			case   1:	/* Set */
-				pFont->usFontStyle |= FONT_STRIKE;
-				break;
-			case 128:	/* Unchanged */
-				break;
-			case 129:	/* Negation */
-				pFont->usFontStyle ^= FONT_STRIKE;
-				break;
-			default:
-				DBG_DEC(ucTmp);
-				DBG_FIXME();
-				break;
-			}
-			break;
-		case  90:	/* fSmallCaps */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			switch (ucTmp) {
-			case   0:	/* Unset */
-				pFont->usFontStyle &= ~FONT_SMALL_CAPITALS;
-				break;
-			case   1:	/* Set */
-				pFont->usFontStyle |= FONT_SMALL_CAPITALS;
-				break;
-			case 128:	/* Unchanged */
-				break;
-			case 129:	/* Negation */
-				pFont->usFontStyle ^= FONT_SMALL_CAPITALS;
-				break;
-			default:
-				DBG_DEC(ucTmp);
-				DBG_FIXME();
-				break;
-			}
-			break;
-		case  91:	/* fCaps */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			switch (ucTmp) {
-			case   0:	/* Unset */
-				pFont->usFontStyle &= ~FONT_CAPITALS;
-				break;
-			case   1:	/* Set */
-				pFont->usFontStyle |= FONT_CAPITALS;
-				break;
-			case 128:	/* Unchanged */
-				break;
-			case 129:	/* Negation */
-				pFont->usFontStyle ^= FONT_CAPITALS;
-				break;
-			default:
-				DBG_DEC(ucTmp);
-				DBG_FIXME();
-				break;
-			}
-			break;
-		case  92:	/* fVanish */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			switch (ucTmp) {
-			case   0:	/* Unset */
-				pFont->usFontStyle &= ~FONT_HIDDEN;
-				break;
-			case   1:	/* Set */
-				pFont->usFontStyle |= FONT_HIDDEN;
-				break;
-			case 128:	/* Unchanged */
-				break;
-			case 129:	/* Negation */
-				pFont->usFontStyle ^= FONT_HIDDEN;
-				break;
-			default:
-				DBG_DEC(ucTmp);
-				DBG_FIXME();
-				break;
-			}
-			break;
-		case  93:	/* cFtc */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			if (usTmp <= (USHORT)UCHAR_MAX) {
-				pFont->ucFontNumber = (UCHAR)usTmp;
-			} else {
-				DBG_DEC(usTmp);
-				DBG_FIXME();
-				pFont->ucFontNumber = 0;
-			}
-			break;
-		case  94:	/* cKul */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			if (ucTmp == 0 || ucTmp == 5) {
-				pFont->usFontStyle &= ~FONT_UNDERLINE;
-			} else {
-				NO_DBG_MSG("Underline text");
-				pFont->usFontStyle |= FONT_UNDERLINE;
-				if (ucTmp == 6) {
-					DBG_MSG("Bold text");
-					pFont->usFontStyle |= FONT_BOLD;
-				}
-			}
-			break;
-		case  95:	/* cHps, cHpsPos */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			DBG_DEC(ucTmp);
-			if (ucTmp != 0) {
-				pFont->usFontSize = (USHORT)ucTmp;
-			}
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			DBG_DEC(ucTmp);
-			break;
-		case  98:	/* cIco */
-			pFont->ucFontColor =
-				ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			break;
-		case  99:	/* cHps */
-			pFont->usFontSize =
-				usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			break;
-		case 100:	/* cHpsInc */
-			DBG_MSG("100: sprmCHpsInc");
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			DBG_DEC(ucTmp);
-			break;
-		case 103:	/* cMajority */
-			DBG_MSG("103: sprmCMajority");
-			break;
-		case 104:	/* cIss */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			ucTmp &= 0x07;
-			if (ucTmp == 1) {
-				pFont->usFontStyle |= FONT_SUPERSCRIPT;
-				NO_DBG_MSG("Superscript");
-			} else if (ucTmp == 2) {
-				pFont->usFontStyle |= FONT_SUBSCRIPT;
-				NO_DBG_MSG("Subscript");
-			}
-			break;
-		case 106:	/* cHpsInc1 */
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			lTmp = (long)pFont->usFontSize + (long)usTmp;
-			if (lTmp < 8) {
-				pFont->usFontSize = 8;
-			} else if (lTmp > 32766) {
-				pFont->usFontSize = 32766;
-			} else {
-				pFont->usFontSize = (USHORT)lTmp;
-			}
-			break;
-		case 108:	/* cMajority50 */
-			DBG_MSG("108: sprmCMajority50");
-			break;
-		case 109:	/* cHpsMul */
-			DBG_MSG("109: sprmCHpsMul");
-			usTmp = usGetWord(iFodo + iFodoOff + 1, aucGrpprl);
-			DBG_DEC(usTmp);
-			break;
-		default:
-			break;
-		}
-		iInfoLen = iGet6InfoLength(iFodo + iFodoOff, aucGrpprl);
-		fail(iInfoLen <= 0);
-		iFodoOff += iInfoLen;
-	}
+	(void)memset(&tState, 0, sizeof(tState));
+	tState.pFont = pFont;
+	tState.usIstd = usIstd;
+	vDecodeGrpprl(&tSprm6Table, sprm_target_font,
+			aucGrpprl + iFodo, iBytes, &tState);
 } /* end of vGet6FontInfo */
 
 /*
@@ -982,49 +1163,18 @@ static BOOL
 bGet6PicInfo(int iFodo,
 	const UCHAR *aucGrpprl, int iBytes, picture_block_type *pPicture)
 {
-	int	iFodoOff, iInfoLen;
-	BOOL	bFound;
-	UCHAR	ucTmp;
+	picture_sprm_type	tState;
 
 	TRACE_MSG("vGet6PicInfo");
 
 	fail(iFodo < 0 || aucGrpprl == NULL || pPicture == NULL);
 
-	iFodoOff = 0;
-	bFound = FALSE;
-	while (iBytes >= iFodoOff + 1) {
-		switch (ucGetByte(iFodo + iFodoOff, aucGrpprl)) {
-		case  68:	/* fcPic */
-			pPicture->ulPictureOffset = ulGetLong(
-					iFodo + iFodoOff + 2, aucGrpprl);
-			bFound = TRUE;
-			break;
-#if 0
-		case  71:	/* fData */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			if (ucTmp == 0x01) {
-				/* Not a picture, but a form field */
-				return FALSE;
-			}
-			DBG_DEC_C(ucTmp != 0, ucTmp);
-			break;
-#endif
-		case  75:	/* fOle2 */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 1, aucGrpprl);
-			if (ucTmp == 0x01) {
-				/* Not a picture, but an OLE object */
-				return FALSE;
-			}
-			DBG_DEC_C(ucTmp != 0, ucTmp);
-			break;
-		default:
-			break;
-		}
-		iInfoLen = iGet6InfoLength(iFodo + iFodoOff, aucGrpprl);
-		fail(iInfoLen <= 0);
-		iFodoOff += iInfoLen;
-	}
-	return bFound;
+	tState.pPicture = pPicture;
+	tState.bFound = FALSE;
+	tState.bOle = FALSE;
+	vDecodeGrpprl(&tSprm6Table, sprm_target_picture,
+			aucGrpprl + iFodo, iBytes, &tState);
+	return tState.bFound && !tState.bOle;
 } /* end of bGet6PicInfo */
 
 /*
@@ -1036,6 +1186,7 @@ vGet6ChrInfo(FILE *pFile, ULONG ulStartBlock,
 {
 	font_block_type		tFont;
 	picture_block_type	tPicture;
+	fkp_run_type		atRun[FKP_RUNS_MAX];
 	USHORT	*ausCharPage;
 	UCHAR	*aucBuffer;
 	ULONG	ulFileOffset, ulCharPos, ulBeginCharInfo;
@@ -1103,21 +1254,25 @@ vGet6ChrInfo(FILE *pFile, ULONG ulStartBlock,
 				BIG_BLOCK_SIZE)) {
 			break;
 		}
-		tRun = (size_t)ucGetByte(0x1ff, aucFpage);
+		tRun = tGetFkpRuns(aucFpage, 1, atRun);
 		NO_DBG_DEC(tRun);
 		for (tIndex2 = 0; tIndex2 < tRun; tIndex2++) {
-		  	ulCharPos = ulGetLong(tIndex2 * 4, aucFpage);
+		  	ulCharPos = atRun[tIndex2].ulCharPosStart;
 			ulFileOffset = ulCharPos2FileOffset(ulCharPos);
-			iFodo = 2 * (int)ucGetByte(
-				(tRun + 1) * 4 + tIndex2, aucFpage);
+			iFodo = atRun[tIndex2].iFodo;
 
 			iLen = (int)ucGetByte(iFodo, aucFpage);
 
 			usIstd = usGetIstd(ulFileOffset);
-			vFillFontFromStylesheet(usIstd, &tFont);
-			if (iFodo != 0) {
+			if (iFodo == 0) {
+				vFillFontFromStylesheet(usIstd, &tFont);
+			} else if (!bGetCachedFontInfo(usIstd,
+					aucFpage + 1 + iFodo, iLen, &tFont)) {
+				vFillFontFromStylesheet(usIstd, &tFont);
 				vGet6FontInfo(iFodo, usIstd,
 					aucFpage + 1, iLen - 1, &tFont);
+				vAdd2FontInfoCache(usIstd,
+					aucFpage + 1 + iFodo, iLen, &tFont);
 			}
 			tFont.ulFileOffset = ulFileOffset;
 			vAdd2FontInfoList(&tFont);
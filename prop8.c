@@ -16,8 +16,28 @@
 #include "antiword.h"
 
 #define DEFAULT_LISTCHAR	0x002e	/* A full stop */
+/* The maximum number of FKP pages to keep in memory at a time */
+#define FKP_PAGES_MAX		32
+
+/* One FKP page read: from where in the file, to which page buffer slot */
+typedef struct fkp_read_tag {
+	ULONG	ulFileOffset;
+	size_t	tSlot;
+} fkp_read_type;
+
+/* Variables needed to read the Character Information on demand */
+static FILE	*pChrStreamFile = NULL;
+static ULONG	*aulChrStreamOffset = NULL;
+static size_t	tChrStreamPages = 0;
+static size_t	tChrStreamNext = 0;
 
 
+/*
+ * The length of a sprm in Word 8/9/10/11 files, indexed by its spra
+ * (the upper three bits of the opcode), 0 means a variable length
+ */
+static const int	aiSpraLength[8] = { 3, 3, 4, 6, 4, 4, 0, 5 };
+
 /*
  * iGet8InfoLength - the length of the information for Word 8/9/10/11 files
  */
@@ -29,30 +49,721 @@ iGet8InfoLength(int iByteNbr, const UCHAR *aucGrpprl)
 
 	usOpCode = usGetWord(iByteNbr, aucGrpprl);
 
-	switch (usOpCode & 0xe000) {
-	case 0x0000: case 0x2000:
-		return 3;
-	case 0x4000: case 0x8000: case 0xa000:
-		return 4;
-	case 0xe000:
-		return 5;
-	case 0x6000:
-		return 6;
-	case 0xc000:
-		iTmp = (int)ucGetByte(iByteNbr + 2, aucGrpprl);
-		if (usOpCode == 0xc615 && iTmp == 255) {
-			iDel = (int)ucGetByte(iByteNbr + 3, aucGrpprl);
-			iAdd = (int)ucGetByte(
-					iByteNbr + 4 + iDel * 4, aucGrpprl);
-			iTmp = 2 + iDel * 4 + iAdd * 3;
+	if (aiSpraLength[usOpCode >> 13] != 0) {
+		return aiSpraLength[usOpCode >> 13];
+	}
+	iTmp = (int)ucGetByte(iByteNbr + 2, aucGrpprl);
+	if (usOpCode == 0xc615 && iTmp == 255) {
+		iDel = (int)ucGetByte(iByteNbr + 3, aucGrpprl);
+		iAdd = (int)ucGetByte(iByteNbr + 4 + iDel * 4, aucGrpprl);
+		iTmp = 2 + iDel * 4 + iAdd * 3;
+	}
+	return 3 + iTmp;
+} /* end of iGet8InfoLength */
+
+/*
+ * sprmSBkc - the section break code
+ */
+static int
+iSprm8Bkc(void *pvSection, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	section_block_type	*pSection;
+	UCHAR	ucTmp;
+
+	pSection = (section_block_type *)pvSection;
+	ucTmp = ucGetByte(2, aucSprm);
+	DBG_DEC(ucTmp);
+	pSection->bNewPage = ucTmp != 0 && ucTmp != 1;
+	return 0;
+} /* end of iSprm8Bkc */
+
+/*
+ * sprmSGprfIhdt - the headers and footers of the section
+ */
+static int
+iSprm8GrpfIhdt(void *pvSection, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	section_block_type	*pSection;
+
+	pSection = (section_block_type *)pvSection;
+	pSection->ucHdrFtrSpecification = ucGetByte(2, aucSprm);
+	return 0;
+} /* end of iSprm8GrpfIhdt */
+
+/*
+ * sprmSCcolumns - the number of columns minus one
+ */
+static int
+iSprm8CcolM1(void *pvSection, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	DBG_DEC(1 + usGetWord(2, aucSprm));
+	return 0;
+} /* end of iSprm8CcolM1 */
+
+/*
+ * sprmSOlstAnm - the outline list of the section
+ */
+static int
+iSprm8OlstAnm(void *pvSection, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	section_block_type	*pSection;
+	UINT	uiIndex;
+	int	iSize, iTmp;
+	UCHAR	ucTmp;
+
+	pSection = (section_block_type *)pvSection;
+	iSize = (int)ucGetByte(2, aucSprm);
+	DBG_DEC_C(iSize != 212, iSize);
+	for (uiIndex = 0, iTmp = 3;
+	     uiIndex < 9 && iTmp < 3 + iSize - 15;
+	     uiIndex++, iTmp += 16) {
+		pSection->aucNFC[uiIndex] = ucGetByte(iTmp, aucSprm);
+		DBG_DEC(pSection->aucNFC[uiIndex]);
+		ucTmp = ucGetByte(iTmp + 3, aucSprm);
+		DBG_HEX(ucTmp);
+		if ((ucTmp & BIT(2)) != 0) {
+			pSection->usNeedPrevLvl |= (USHORT)BIT(uiIndex);
 		}
-		return 3 + iTmp;
-	default:
-		DBG_HEX(usOpCode);
-		DBG_FIXME();
+		if ((ucTmp & BIT(3)) != 0) {
+			pSection->usHangingIndent |= (USHORT)BIT(uiIndex);
+		}
+	}
+	DBG_HEX(pSection->usNeedPrevLvl);
+	DBG_HEX(pSection->usHangingIndent);
+	return 0;
+} /* end of iSprm8OlstAnm */
+
+/*
+ * sprmPFInTable and sprmPFInnerTableCell - the paragraph is in a table cell
+ */
+static int
+iSprm8InTable(void *pvRow, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	row_sprm_type	*pState;
+
+	pState = (row_sprm_type *)pvRow;
+	if (odd(ucGetByte(2, aucSprm))) {
+		pState->bCell1 = TRUE;
+	} else {
+		pState->bCell0 = TRUE;
+	}
+	return 0;
+} /* end of iSprm8InTable */
+
+/*
+ * sprmPFTtp - the paragraph ends a table row
+ */
+static int
+iSprm8Ttp(void *pvRow, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	row_sprm_type	*pState;
+
+	pState = (row_sprm_type *)pvRow;
+	if (odd(ucGetByte(2, aucSprm))) {
+		pState->bRowEnd1 = TRUE;
+	} else {
+		pState->bRowEnd0 = TRUE;
+	}
+	return 0;
+} /* end of iSprm8Ttp */
+
+/*
+ * sprmTTableBorders - one table border, usParam is the border bit
+ */
+static int
+iSprm8Border(void *pvRow, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	row_block_type	*pRow;
+	USHORT	usTmp;
+
+	pRow = ((row_sprm_type *)pvRow)->pRow;
+	usTmp = usGetWord(2, aucSprm);
+	usTmp &= 0xff00;
+	NO_DBG_DEC(usTmp >> 8);
+	if (usTmp == 0) {
+		pRow->ucBorderInfo &= (UCHAR)~usParam;
+	} else {
+		pRow->ucBorderInfo |= (UCHAR)usParam;
+	}
+	return 0;
+} /* end of iSprm8Border */
+
+/*
+ * sprmTDefTable10 - the old style cell definitions
+ */
+static int
+iSprm8DefTable10(void *pvRow, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	DBG_MSG("0xd606: sprmTDefTable10");
+	DBG_DEC(usGetWord(2, aucSprm));
+	return 0;
+} /* end of iSprm8DefTable10 */
+
+/*
+ * sprmTDefTable - the cell definitions
+ */
+static int
+iSprm8DefTable(void *pvRow, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	row_sprm_type	*pState;
+	row_block_type	*pRow;
+	int	iIndex, iSize, iCol;
+	int	iPosCurr, iPosPrev;
+
+	pState = (row_sprm_type *)pvRow;
+	pRow = pState->pRow;
+	iSize = (int)usGetWord(2, aucSprm);
+	if (iSize < 6 || iBytes < 8) {
+		DBG_DEC(iSize);
+		DBG_DEC(iBytes);
+		return 2;
+	}
+	iCol = (int)ucGetByte(4, aucSprm);
+	if (iCol < 1 || iBytes < 4 + (iCol + 1) * 2) {
+		DBG_DEC(iCol);
+		DBG_DEC(iBytes);
+		return 2;
+	}
+	if (iCol >= (int)elementsof(pRow->asColumnWidth)) {
+		DBG_DEC(iCol);
+		werr(1, "The number of columns is corrupt");
+	}
+	pRow->ucNumberOfColumns = (UCHAR)iCol;
+	iPosPrev = (int)(short)usGetWord(5, aucSprm);
+	for (iIndex = 0; iIndex < iCol; iIndex++) {
+		iPosCurr = (int)(short)usGetWord(7 + iIndex * 2, aucSprm);
+		pRow->asColumnWidth[iIndex] = (short)(iPosCurr - iPosPrev);
+		iPosPrev = iPosCurr;
+	}
+	pState->bDefTable = TRUE;
+	return 0;
+} /* end of iSprm8DefTable */
+
+/*
+ * sprmPJc - the alignment of the paragraph
+ */
+static int
+iSprm8Jc(void *pvStyle, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->ucAlignment = ucGetByte(2, aucSprm);
+	return 0;
+} /* end of iSprm8Jc */
+
+/*
+ * sprmPIlvl - the list level of the paragraph
+ */
+static int
+iSprm8Ilvl(void *pvStyle, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->ucListLevel = ucGetByte(2, aucSprm);
+	NO_DBG_DEC(pStyle->ucListLevel);
+	pStyle->ucNumLevel = pStyle->ucListLevel;
+	return 0;
+} /* end of iSprm8Ilvl */
+
+/*
+ * sprmPIlfo - the list of the paragraph
+ */
+static int
+iSprm8Ilfo(void *pvStyle, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->usListIndex = usGetWord(2, aucSprm);
+	NO_DBG_DEC(pStyle->usListIndex);
+	return 0;
+} /* end of iSprm8Ilfo */
+
+/*
+ * sprmPNest - the nested left indentation
+ */
+static int
+iSprm8Nest(void *pvStyle, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	style_block_type	*pStyle;
+	short	sTmp;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	sTmp = (short)usGetWord(2, aucSprm);
+	pStyle->sLeftIndent += sTmp;
+	if (pStyle->sLeftIndent < 0) {
+		pStyle->sLeftIndent = 0;
+	}
+	DBG_DEC(sTmp);
+	DBG_DEC(pStyle->sLeftIndent);
+	return 0;
+} /* end of iSprm8Nest */
+
+/*
+ * sprmPChgTabsPapx and sprmPChgTabs - the tab stops
+ *
+ * Returns 1 to skip only the opcode when the operand is corrupt
+ */
+static int
+iSprm8ChgTabs(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	int	iTmp, iDel, iAdd;
+
+	iTmp = (int)ucGetByte(2, aucSprm);
+	if (iTmp < 2) {
 		return 1;
 	}
-} /* end of iGet8InfoLength */
+	NO_DBG_DEC(iTmp);
+	iDel = (int)ucGetByte(3, aucSprm);
+	if (iTmp < 2 + 2 * iDel) {
+		return 1;
+	}
+	NO_DBG_DEC(iDel);
+	iAdd = (int)ucGetByte(4 + 2 * iDel, aucSprm);
+	if (iTmp < 2 + 2 * iDel + 2 * iAdd) {
+		return 1;
+	}
+	NO_DBG_DEC(iAdd);
+	return 0;
+} /* end of iSprm8ChgTabs */
+
+/*
+ * sprmPDxaRight - the right indentation
+ */
+static int
+iSprm8DxaRight(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->sRightIndent = (short)usGetWord(2, aucSprm);
+	NO_DBG_DEC(pStyle->sRightIndent);
+	return 0;
+} /* end of iSprm8DxaRight */
+
+/*
+ * sprmPDxaLeft - the left indentation
+ */
+static int
+iSprm8DxaLeft(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->sLeftIndent = (short)usGetWord(2, aucSprm);
+	NO_DBG_DEC(pStyle->sLeftIndent);
+	return 0;
+} /* end of iSprm8DxaLeft */
+
+/*
+ * sprmPDxaLeft1 - the first line indentation
+ */
+static int
+iSprm8DxaLeft1(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->sLeftIndent1 = (short)usGetWord(2, aucSprm);
+	NO_DBG_DEC(pStyle->sLeftIndent1);
+	return 0;
+} /* end of iSprm8DxaLeft1 */
+
+/*
+ * sprmPDyaBefore - the space before the paragraph
+ */
+static int
+iSprm8DyaBefore(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->usBeforeIndent = usGetWord(2, aucSprm);
+	NO_DBG_DEC(pStyle->usBeforeIndent);
+	return 0;
+} /* end of iSprm8DyaBefore */
+
+/*
+ * sprmPDyaAfter - the space after the paragraph
+ */
+static int
+iSprm8DyaAfter(void *pvStyle, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	style_block_type	*pStyle;
+
+	pStyle = ((style_sprm_type *)pvStyle)->pStyle;
+	pStyle->usAfterIndent = usGetWord(2, aucSprm);
+	NO_DBG_DEC(pStyle->usAfterIndent);
+	return 0;
+} /* end of iSprm8DyaAfter */
+
+/*
+ * sprmPAnld - the Word 6 style list information
+ */
+static int
+iSprm8Anld(void *pvStyle, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	list_block_type	*pList6;
+	int	iTmp, iBefore;
+
+	pList6 = &((style_sprm_type *)pvStyle)->tList6;
+	iTmp = (int)ucGetByte(2, aucSprm);
+	DBG_DEC_C(iTmp < 84, iTmp);
+	if (iTmp >= 1) {
+		pList6->ucNFC = ucGetByte(3, aucSprm);
+	}
+	if (pList6->ucNFC != LIST_BULLETS && iTmp >= 2) {
+		iBefore = (int)ucGetByte(4, aucSprm);
+	} else {
+		iBefore = 0;
+	}
+	if (iTmp >= 12) {
+		pList6->ulStartAt = (ULONG)usGetWord(13, aucSprm);
+	}
+	if (iTmp >= iBefore + 22) {
+		pList6->usListChar = usGetWord(iBefore + 23, aucSprm);
+		DBG_HEX(pList6->usListChar);
+	}
+	return 0;
+} /* end of iSprm8Anld */
+
+/*
+ * sprmCFRMarkDel - the text is marked as deleted
+ */
+static int
+iSprm8MarkDel(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	if (ucGetByte(2, aucSprm) == 0) {
+		pFont->usFontStyle &= ~FONT_MARKDEL;
+	} else {
+		pFont->usFontStyle |= FONT_MARKDEL;
+	}
+	return 0;
+} /* end of iSprm8MarkDel */
+
+/*
+ * sprmCFBold and friends - a toggling property, usParam is the font style
+ */
+static int
+iSprm8Toggle(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	vSetFontToggle(((font_sprm_type *)pvFont)->pFont,
+			usParam, ucGetByte(2, aucSprm));
+	return 0;
+} /* end of iSprm8Toggle */
+
+/*
+ * sprmCDefault - back to the default character properties
+ */
+static int
+iSprm8Default(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	pFont->usFontStyle &= FONT_HIDDEN;
+	pFont->ucFontColor = FONT_COLOR_DEFAULT;
+	return 0;
+} /* end of iSprm8Default */
+
+/*
+ * sprmCPlain - back to the character properties of the style
+ */
+static int
+iSprm8Plain(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_sprm_type	*pState;
+
+	pState = (font_sprm_type *)pvFont;
+	DBG_MSG("2a33: cPlain");
+	vFillFontFromStylesheet(pState->usIstd, pState->pFont);
+	return 0;
+} /* end of iSprm8Plain */
+
+/*
+ * sprmCKul - the underline code
+ */
+static int
+iSprm8Kul(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+	UCHAR	ucTmp;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	ucTmp = ucGetByte(2, aucSprm);
+	if (ucTmp == 0 || ucTmp == 5) {
+		pFont->usFontStyle &= ~FONT_UNDERLINE;
+	} else {
+		NO_DBG_MSG("Underline text");
+		pFont->usFontStyle |= FONT_UNDERLINE;
+		if (ucTmp == 6) {
+			DBG_MSG("Bold text");
+			pFont->usFontStyle |= FONT_BOLD;
+		}
+	}
+	return 0;
+} /* end of iSprm8Kul */
+
+/*
+ * sprmCIco - the colour of the text
+ */
+static int
+iSprm8Ico(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	pFont->ucFontColor = ucGetByte(2, aucSprm);
+	NO_DBG_DEC(pFont->ucFontColor);
+	return 0;
+} /* end of iSprm8Ico */
+
+/*
+ * sprmCHpsInc - increment the font size
+ */
+static int
+iSprm8HpsInc(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	DBG_MSG("0x2a44: sprmCHpsInc");
+	DBG_DEC(ucGetByte(2, aucSprm));
+	return 0;
+} /* end of iSprm8HpsInc */
+
+/*
+ * sprmCIss - superscript or subscript
+ */
+static int
+iSprm8Iss(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+	UCHAR	ucTmp;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	ucTmp = ucGetByte(2, aucSprm);
+	ucTmp &= 0x07;
+	if (ucTmp == 1) {
+		pFont->usFontStyle |= FONT_SUPERSCRIPT;
+		NO_DBG_MSG("Superscript");
+	} else if (ucTmp == 2) {
+		pFont->usFontStyle |= FONT_SUBSCRIPT;
+		NO_DBG_MSG("Subscript");
+	}
+	return 0;
+} /* end of iSprm8Iss */
+
+/*
+ * sprmCHps - the font size
+ */
+static int
+iSprm8Hps(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	pFont->usFontSize = usGetWord(2, aucSprm);
+	NO_DBG_DEC(pFont->usFontSize);
+	return 0;
+} /* end of iSprm8Hps */
+
+/*
+ * sprmCHpsMul - multiply the font size
+ */
+static int
+iSprm8HpsMul(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	DBG_MSG("0x4a4d: sprmCHpsMul");
+	DBG_DEC(usGetWord(2, aucSprm));
+	return 0;
+} /* end of iSprm8HpsMul */
+
+/*
+ * sprmCRgFtc0, 1 and 2 - a font number, usParam tells which one
+ */
+static int
+iSprm8Ftc(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_sprm_type	*pState;
+
+	pState = (font_sprm_type *)pvFont;
+	fail(usParam >= elementsof(pState->ausFtc));
+	pState->ausFtc[usParam] = usGetWord(2, aucSprm);
+	return 0;
+} /* end of iSprm8Ftc */
+
+/*
+ * sprmCMajority and sprmCMajority50 - compare with the style
+ */
+static int
+iSprm8Majority(void *pvFont, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	DBG_HEX(usGetWord(0, aucSprm));
+	DBG_MSG("sprmCMajority");
+	return 0;
+} /* end of iSprm8Majority */
+
+/*
+ * sprmCHpsInc1 - increment the font size
+ */
+static int
+iSprm8HpsInc1(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+	long	lTmp;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	lTmp = (long)pFont->usFontSize + (long)usGetWord(2, aucSprm);
+	if (lTmp < 8) {
+		pFont->usFontSize = 8;
+	} else if (lTmp > 32766) {
+		pFont->usFontSize = 32766;
+	} else {
+		pFont->usFontSize = (USHORT)lTmp;
+	}
+	return 0;
+} /* end of iSprm8HpsInc1 */
+
+/*
+ * sprmCHpsPosAdj - the font size and the position
+ */
+static int
+iSprm8HpsPos(void *pvFont, const UCHAR *aucSprm, int iBytes, USHORT usParam)
+{
+	font_block_type	*pFont;
+	UCHAR	ucTmp;
+
+	pFont = ((font_sprm_type *)pvFont)->pFont;
+	ucTmp = ucGetByte(2, aucSprm);
+	DBG_DEC(ucTmp);
+	if (ucTmp != 0) {
+		pFont->usFontSize = (USHORT)ucTmp;
+	}
+	DBG_DEC(ucGetByte(3, aucSprm));
+	return 0;
+} /* end of iSprm8HpsPos */
+
+/*
+ * sprmCFOle2 - the picture is an OLE object
+ */
+static int
+iSprm8Ole2(void *pvPicture, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	UCHAR	ucTmp;
+
+	ucTmp = ucGetByte(2, aucSprm);
+	if (ucTmp == 0x01) {
+		/* Not a picture, but an OLE object */
+		((picture_sprm_type *)pvPicture)->bOle = TRUE;
+	}
+	DBG_DEC_C(ucTmp != 0 && ucTmp != 0x01, ucTmp);
+	return 0;
+} /* end of iSprm8Ole2 */
+
+/*
+ * sprmCObjLocation - the location of the object
+ */
+static int
+iSprm8FcObj(void *pvPicture, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	DBG_HEX(ulGetLong(2, aucSprm));
+	return 0;
+} /* end of iSprm8FcObj */
+
+/*
+ * sprmCPicLocation - the location of the picture
+ */
+static int
+iSprm8FcPic(void *pvPicture, const UCHAR *aucSprm, int iBytes,
+	USHORT usParam)
+{
+	picture_sprm_type	*pState;
+
+	pState = (picture_sprm_type *)pvPicture;
+	pState->pPicture->ulPictureOffset = ulGetLong(2, aucSprm);
+	pState->bFound = TRUE;
+	return 0;
+} /* end of iSprm8FcPic */
+
+/*
+ * The Word 8/9/10/11 opcodes, sorted by opcode.
+ * The handlers are for the section, row, style, font and picture information
+ */
+static const sprm_type	atSprm8[] = {
+	{ 0x0800, 0, { NULL, NULL, NULL, iSprm8MarkDel, NULL } },
+	{ 0x080a, 0, { NULL, NULL, NULL, NULL, iSprm8Ole2 } },
+	{ 0x0835, FONT_BOLD, { NULL, NULL, NULL, iSprm8Toggle, NULL } },
+	{ 0x0836, FONT_ITALIC, { NULL, NULL, NULL, iSprm8Toggle, NULL } },
+	{ 0x0837, FONT_STRIKE, { NULL, NULL, NULL, iSprm8Toggle, NULL } },
+	{ 0x083a, FONT_SMALL_CAPITALS,
+			{ NULL, NULL, NULL, iSprm8Toggle, NULL } },
+	{ 0x083b, FONT_CAPITALS, { NULL, NULL, NULL, iSprm8Toggle, NULL } },
+	{ 0x083c, FONT_HIDDEN, { NULL, NULL, NULL, iSprm8Toggle, NULL } },
+	{ 0x2403, 0, { NULL, NULL, iSprm8Jc, NULL, NULL } },
+	{ 0x2416, 0, { NULL, iSprm8InTable, NULL, NULL, NULL } },
+	{ 0x2417, 0, { NULL, iSprm8Ttp, NULL, NULL, NULL } },
+	{ 0x244b, 0, { NULL, iSprm8InTable, NULL, NULL, NULL } },
+	{ 0x260a, 0, { NULL, NULL, iSprm8Ilvl, NULL, NULL } },
+	{ 0x2a32, 0, { NULL, NULL, NULL, iSprm8Default, NULL } },
+	{ 0x2a33, 0, { NULL, NULL, NULL, iSprm8Plain, NULL } },
+	{ 0x2a3e, 0, { NULL, NULL, NULL, iSprm8Kul, NULL } },
+	{ 0x2a42, 0, { NULL, NULL, NULL, iSprm8Ico, NULL } },
+	{ 0x2a44, 0, { NULL, NULL, NULL, iSprm8HpsInc, NULL } },
+	{ 0x2a48, 0, { NULL, NULL, NULL, iSprm8Iss, NULL } },
+	{ 0x3009, 0, { iSprm8Bkc, NULL, NULL, NULL, NULL } },
+	{ 0x3014, 0, { iSprm8GrpfIhdt, NULL, NULL, NULL, NULL } },
+	{ 0x460b, 0, { NULL, NULL, iSprm8Ilfo, NULL, NULL } },
+	{ 0x4610, 0, { NULL, NULL, iSprm8Nest, NULL, NULL } },
+	{ 0x4a43, 0, { NULL, NULL, NULL, iSprm8Hps, NULL } },
+	{ 0x4a4d, 0, { NULL, NULL, NULL, iSprm8HpsMul, NULL } },
+	{ 0x4a4f, 0, { NULL, NULL, NULL, iSprm8Ftc, NULL } },
+	{ 0x4a50, 1, { NULL, NULL, NULL, iSprm8Ftc, NULL } },
+	{ 0x4a51, 2, { NULL, NULL, NULL, iSprm8Ftc, NULL } },
+	{ 0x500b, 0, { iSprm8CcolM1, NULL, NULL, NULL, NULL } },
+	{ 0x6424, TABLE_BORDER_TOP, { NULL, iSprm8Border, NULL, NULL, NULL } },
+	{ 0x6425, TABLE_BORDER_LEFT, { NULL, iSprm8Border, NULL, NULL, NULL } },
+	{ 0x6426, TABLE_BORDER_BOTTOM,
+			{ NULL, iSprm8Border, NULL, NULL, NULL } },
+	{ 0x6427, TABLE_BORDER_RIGHT,
+			{ NULL, iSprm8Border, NULL, NULL, NULL } },
+	{ 0x680e, 0, { NULL, NULL, NULL, NULL, iSprm8FcObj } },
+	{ 0x6a03, 0, { NULL, NULL, NULL, NULL, iSprm8FcPic } },
+	{ 0x840e, 0, { NULL, NULL, iSprm8DxaRight, NULL, NULL } },
+	{ 0x840f, 0, { NULL, NULL, iSprm8DxaLeft, NULL, NULL } },
+	{ 0x8411, 0, { NULL, NULL, iSprm8DxaLeft1, NULL, NULL } },
+	{ 0xa413, 0, { NULL, NULL, iSprm8DyaBefore, NULL, NULL } },
+	{ 0xa414, 0, { NULL, NULL, iSprm8DyaAfter, NULL, NULL } },
+	{ 0xc60d, 0, { NULL, NULL, iSprm8ChgTabs, NULL, NULL } },
+	{ 0xc615, 0, { NULL, NULL, iSprm8ChgTabs, NULL, NULL } },
+	{ 0xc63e, 0, { NULL, NULL, iSprm8Anld, NULL, NULL } },
+	{ 0xca47, 0, { NULL, NULL, NULL, iSprm8Majority, NULL } },
+	{ 0xca4a, 0, { NULL, NULL, NULL, iSprm8HpsInc1, NULL } },
+	{ 0xca4c, 0, { NULL, NULL, NULL, iSprm8Majority, NULL } },
+	{ 0xd202, 0, { iSprm8OlstAnm, NULL, NULL, NULL, NULL } },
+	{ 0xd606, 0, { NULL, iSprm8DefTable10, NULL, NULL, NULL } },
+	{ 0xd608, 0, { NULL, iSprm8DefTable, NULL, NULL, NULL } },
+	{ 0xea3f, 0, { NULL, NULL, NULL, iSprm8HpsPos, NULL } },
+};
+
+static const sprm_table_type	tSprm8Table = {
+	atSprm8, elementsof(atSprm8), 2, iGet8InfoLength
+};
 
 /*
  * aucFillInfoBuffer - fill the information buffer
@@ -155,62 +866,10 @@ static void
 vGet8SectionInfo(const UCHAR *aucGrpprl, size_t tBytes,
 		section_block_type *pSection)
 {
-	UINT	uiIndex;
-	int	iFodoOff, iInfoLen, iSize, iTmp;
-	USHORT	usCcol;
-	UCHAR	ucTmp;
-
 	fail(aucGrpprl == NULL || pSection == NULL);
 
-	iFodoOff = 0;
-	while (tBytes >= (size_t)iFodoOff + 2) {
-		iInfoLen = 0;
-		switch (usGetWord(iFodoOff, aucGrpprl)) {
-		case 0x3009:	/* bkc */
-			ucTmp = ucGetByte(iFodoOff + 2, aucGrpprl);
-			DBG_DEC(ucTmp);
-			pSection->bNewPage = ucTmp != 0 && ucTmp != 1;
-			break;
-		case 0x3014:	/* grpfIhdt */
-			pSection->ucHdrFtrSpecification =
-					ucGetByte(iFodoOff + 2, aucGrpprl);
-			break;
-		case 0x500b:	/* ccolM1 */
-			usCcol = 1 + usGetWord(iFodoOff + 2, aucGrpprl);
-			DBG_DEC(usCcol);
-			break;
-		case 0xd202:	/* olstAnm */
-			iSize = (int)ucGetByte(iFodoOff + 2, aucGrpprl);
-			DBG_DEC_C(iSize != 212, iSize);
-			for (uiIndex = 0, iTmp = iFodoOff + 3;
-			     uiIndex < 9 && iTmp < iFodoOff + 3 + iSize - 15;
-			     uiIndex++, iTmp += 16) {
-				pSection->aucNFC[uiIndex] =
-						ucGetByte(iTmp, aucGrpprl);
-				DBG_DEC(pSection->aucNFC[uiIndex]);
-				ucTmp = ucGetByte(iTmp + 3, aucGrpprl);
-				DBG_HEX(ucTmp);
-				if ((ucTmp & BIT(2)) != 0) {
-					pSection->usNeedPrevLvl |=
-							(USHORT)BIT(uiIndex);
-				}
-				if ((ucTmp & BIT(3)) != 0) {
-					pSection->usHangingIndent |=
-							(USHORT)BIT(uiIndex);
-				}
-			}
-			DBG_HEX(pSection->usNeedPrevLvl);
-			DBG_HEX(pSection->usHangingIndent);
-			break;
-		default:
-			break;
-		}
-		if (iInfoLen <= 0) {
-			iInfoLen = iGet8InfoLength(iFodoOff, aucGrpprl);
-			fail(iInfoLen <= 0);
-		}
-		iFodoOff += iInfoLen;
-	}
+	vDecodeGrpprl(&tSprm8Table, sprm_target_section,
+			aucGrpprl, (int)tBytes, pSection);
 } /* end of vGet8SectionInfo */
 
 /*
@@ -365,157 +1024,25 @@ row_info_enum
 eGet8RowInfo(int iFodo,
 	const UCHAR *aucGrpprl, int iBytes, row_block_type *pRow)
 {
-	int	iFodoOff, iInfoLen;
-	int	iIndex, iSize, iCol;
-	int	iPosCurr, iPosPrev;
-	USHORT	usTmp;
-	BOOL	bFound2416_0, bFound2416_1, bFound2417_0, bFound2417_1;
-	BOOL	bFound244b_0, bFound244b_1, bFound244c_0, bFound244c_1;
-	BOOL	bFoundd608;
+	row_sprm_type	tState;
 
 	fail(iFodo < 0 || aucGrpprl == NULL || pRow == NULL);
 
-	iFodoOff = 0;
-	bFound2416_0 = FALSE;
-	bFound2416_1 = FALSE;
-	bFound2417_0 = FALSE;
-	bFound2417_1 = FALSE;
-	bFound244b_0 = FALSE;
-	bFound244b_1 = FALSE;
-	bFound244c_0 = FALSE;
-	bFound244c_1 = FALSE;
-	bFoundd608 = FALSE;
-	while (iBytes >= iFodoOff + 2) {
-		iInfoLen = 0;
-		switch (usGetWord(iFodo + iFodoOff, aucGrpprl)) {
-		case 0x2416:	/* fInTable */
-			if (odd(ucGetByte(iFodo + iFodoOff + 2, aucGrpprl))) {
-				bFound2416_1 = TRUE;
-			} else {
-				bFound2416_0 = TRUE;
-			}
-			break;
-		case 0x2417:	/* fTtp */
-			if (odd(ucGetByte(iFodo + iFodoOff + 2, aucGrpprl))) {
-				bFound2417_1 = TRUE;
-			} else {
-				bFound2417_0 = TRUE;
-			}
-			break;
-		case 0x244b:	/* sub-table fInTable */
-			if (odd(ucGetByte(iFodo + iFodoOff + 2, aucGrpprl))) {
-				bFound244b_1 = TRUE;
-			} else {
-				bFound244b_0 = TRUE;
-			}
-			break;
-		case 0x244c:	/* sub-table fTtp */
-			if (odd(ucGetByte(iFodo + iFodoOff + 2, aucGrpprl))) {
-				bFound244c_1 = TRUE;
-			} else {
-				bFound244c_0 = TRUE;
-			}
-			break;
-		case 0x6424:	/* brcTop */
-			usTmp = usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			usTmp &= 0xff00;
-			NO_DBG_DEC(usTmp >> 8);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_TOP;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_TOP;
-			}
-			break;
-		case 0x6425:	/* brcLeft */
-			usTmp = usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			usTmp &= 0xff00;
-			NO_DBG_DEC(usTmp >> 8);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_LEFT;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_LEFT;
-			}
-			break;
-		case 0x6426:	/* brcBottom */
-			usTmp = usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			usTmp &= 0xff00;
-			NO_DBG_DEC(usTmp >> 8);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_BOTTOM;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_BOTTOM;
-			}
-			break;
-		case 0x6427:	/* brcRight */
-			usTmp = usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			usTmp &= 0xff00;
-			NO_DBG_DEC(usTmp >> 8);
-			if (usTmp == 0) {
-				pRow->ucBorderInfo &= ~TABLE_BORDER_RIGHT;
-			} else {
-				pRow->ucBorderInfo |= TABLE_BORDER_RIGHT;
-			}
-			break;
-		case 0xd606:	/* cDefTable10 */
-			DBG_MSG("0xd606: sprmTDefTable10");
-			iSize = (int)usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			DBG_DEC(iSize);
-			break;
-		case 0xd608:	/* cDefTable */
-			iSize = (int)usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			if (iSize < 6 || iBytes < iFodoOff + 8) {
-				DBG_DEC(iSize);
-				DBG_DEC(iFodoOff);
-				iInfoLen = 2;
-				break;
-			}
-			iCol = (int)ucGetByte(iFodo + iFodoOff + 4, aucGrpprl);
-			if (iCol < 1 ||
-			    iBytes < iFodoOff + 4 + (iCol + 1) * 2) {
-				DBG_DEC(iCol);
-				DBG_DEC(iFodoOff);
-				iInfoLen = 2;
-				break;
-			}
-			if (iCol >= (int)elementsof(pRow->asColumnWidth)) {
-				DBG_DEC(iCol);
-				werr(1, "The number of columns is corrupt");
-			}
-			pRow->ucNumberOfColumns = (UCHAR)iCol;
-			iPosPrev = (int)(short)usGetWord(
-					iFodo + iFodoOff + 5,
-					aucGrpprl);
-			for (iIndex = 0; iIndex < iCol; iIndex++) {
-				iPosCurr = (int)(short)usGetWord(
-					iFodo + iFodoOff + 7 + iIndex * 2,
-					aucGrpprl);
-				pRow->asColumnWidth[iIndex] =
-						(short)(iPosCurr - iPosPrev);
-				iPosPrev = iPosCurr;
-			}
-			bFoundd608 = TRUE;
-			break;
-		default:
-			break;
-		}
-		if (iInfoLen <= 0) {
-			iInfoLen =
-				iGet8InfoLength(iFodo + iFodoOff, aucGrpprl);
-			fail(iInfoLen <= 0);
-		}
-		iFodoOff += iInfoLen;
-	}
+	(void)memset(&tState, 0, sizeof(tState));
+	tState.pRow = pRow;
+	vDecodeGrpprl(&tSprm8Table, sprm_target_row,
+			aucGrpprl + iFodo, iBytes, &tState);
 
-	if (bFound2417_1 && bFoundd608) {
+	if (tState.bRowEnd1 && tState.bDefTable) {
 		return found_end_of_row;
 	}
-	if (bFound2417_0 && !bFoundd608) {
+	if (tState.bRowEnd0 && !tState.bDefTable) {
 		return found_not_end_of_row;
 	}
-	if (bFound2416_1 || bFound244b_1) {
+	if (tState.bCell1) {
 		return found_a_cell;
 	}
-	if (bFound2416_0 || bFound244b_0) {
+	if (tState.bCell0) {
 		return found_not_a_cell;
 	}
 	return found_nothing;
@@ -529,143 +1056,24 @@ void
 vGet8StyleInfo(int iFodo,
 	const UCHAR *aucGrpprl, int iBytes, style_block_type *pStyle)
 {
-	list_block_type	tList6;
+	style_sprm_type	tState;
 	const list_block_type	*pList;
-	int	iFodoOff, iInfoLen;
-	int	iTmp, iDel, iAdd, iBefore;
-	USHORT	usOpCode, usTmp;
-	short	sTmp;
 
 	fail(iFodo < 0 || aucGrpprl == NULL || pStyle == NULL);
 
 	NO_DBG_DEC_C(pStyle->usListIndex != 0, pStyle->usIstd);
 	NO_DBG_DEC_C(pStyle->usListIndex != 0, pStyle->usListIndex);
 
-	(void)memset(&tList6, 0, sizeof(tList6));
-
-	iFodoOff = 0;
-	while (iBytes >= iFodoOff + 2) {
-		iInfoLen = 0;
-		usOpCode = usGetWord(iFodo + iFodoOff, aucGrpprl);
-		switch (usOpCode) {
-		case 0x2403:	/* jc */
-			pStyle->ucAlignment = ucGetByte(
-					iFodo + iFodoOff + 2, aucGrpprl);
-			break;
-		case 0x260a:	/* ilvl */
-			pStyle->ucListLevel =
-				ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			NO_DBG_DEC(pStyle->ucListLevel);
-			pStyle->ucNumLevel = pStyle->ucListLevel;
-			break;
-		case 0x4600:	/* istd */
-			usTmp = usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			NO_DBG_DEC(usTmp);
-			break;
-		case 0x460b:	/* ilfo */
-			pStyle->usListIndex =
-				usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			NO_DBG_DEC(pStyle->usListIndex);
-			break;
-		case 0x4610: /* Nest dxaLeft */
-			sTmp = (short)usGetWord(
-					iFodo + iFodoOff + 2, aucGrpprl);
-			pStyle->sLeftIndent += sTmp;
-			if (pStyle->sLeftIndent < 0) {
-				pStyle->sLeftIndent = 0;
-			}
-			DBG_DEC(sTmp);
-			DBG_DEC(pStyle->sLeftIndent);
-			break;
-		case 0xc60d:	/* ChgTabsPapx */
-		case 0xc615:	/* ChgTabs */
-			iTmp = (int)ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			if (iTmp < 2) {
-				iInfoLen = 1;
-				break;
-			}
-			NO_DBG_DEC(iTmp);
-			iDel = (int)ucGetByte(iFodo + iFodoOff + 3, aucGrpprl);
-			if (iTmp < 2 + 2 * iDel) {
-				iInfoLen = 1;
-				break;
-			}
-			NO_DBG_DEC(iDel);
-			iAdd = (int)ucGetByte(
-				iFodo + iFodoOff + 4 + 2 * iDel, aucGrpprl);
-			if (iTmp < 2 + 2 * iDel + 2 * iAdd) {
-				iInfoLen = 1;
-				break;
-			}
-			NO_DBG_DEC(iAdd);
-			break;
-		case 0x840e:	/* dxaRight */
-			pStyle->sRightIndent = (short)usGetWord(
-					iFodo + iFodoOff + 2, aucGrpprl);
-			NO_DBG_DEC(pStyle->sRightIndent);
-			break;
-		case 0x840f:	/* dxaLeft */
-			pStyle->sLeftIndent = (short)usGetWord(
-					iFodo + iFodoOff + 2, aucGrpprl);
-			NO_DBG_DEC(pStyle->sLeftIndent);
-			break;
-		case 0x8411:	/* dxaLeft1 */
-			pStyle->sLeftIndent1 = (short)usGetWord(
-					iFodo + iFodoOff + 2, aucGrpprl);
-			NO_DBG_DEC(pStyle->sLeftIndent1);
-			break;
-		case 0xa413:	/* dyaBefore */
-			pStyle->usBeforeIndent = usGetWord(
-					iFodo + iFodoOff + 2, aucGrpprl);
-			NO_DBG_DEC(pStyle->usBeforeIndent);
-			break;
-		case 0xa414:	/* dyaAfter */
-			pStyle->usAfterIndent = usGetWord(
-					iFodo + iFodoOff + 2, aucGrpprl);
-			NO_DBG_DEC(pStyle->usAfterIndent);
-			break;
-		case 0xc63e:	/* anld */
-			iTmp = (int)ucGetByte(
-					iFodo + iFodoOff + 2, aucGrpprl);
-			DBG_DEC_C(iTmp < 84, iTmp);
-			if (iTmp >= 1) {
-				tList6.ucNFC = ucGetByte(
-					iFodo + iFodoOff + 3, aucGrpprl);
-			}
-			if (tList6.ucNFC != LIST_BULLETS && iTmp >= 2) {
-				iBefore = (int)ucGetByte(
-					iFodo + iFodoOff + 4, aucGrpprl);
-			} else {
-				iBefore = 0;
-			}
-			if (iTmp >= 12) {
-				tList6.ulStartAt = (ULONG)usGetWord(
-					iFodo + iFodoOff + 13, aucGrpprl);
-			}
-			if (iTmp >= iBefore + 22) {
-				tList6.usListChar = usGetWord(
-					iFodo + iFodoOff + iBefore + 23,
-					aucGrpprl);
-				DBG_HEX(tList6.usListChar);
-			}
-			break;
-		default:
-			NO_DBG_HEX(usOpCode);
-			break;
-		}
-		if (iInfoLen <= 0) {
-			iInfoLen =
-				iGet8InfoLength(iFodo + iFodoOff, aucGrpprl);
-			fail(iInfoLen <= 0);
-		}
-		iFodoOff += iInfoLen;
-	}
+	(void)memset(&tState, 0, sizeof(tState));
+	tState.pStyle = pStyle;
+	vDecodeGrpprl(&tSprm8Table, sprm_target_style,
+			aucGrpprl + iFodo, iBytes, &tState);
 
 	if (pStyle->usListIndex == 2047) {
 		/* Old style list */
-		pStyle->usStartAt = (USHORT)tList6.ulStartAt;
-		pStyle->usListChar = tList6.usListChar;
-		pStyle->ucNFC = tList6.ucNFC;
+		pStyle->usStartAt = (USHORT)tState.tList6.ulStartAt;
+		pStyle->usListChar = tState.tList6.usListChar;
+		pStyle->ucNFC = tState.tList6.ucNFC;
 	} else {
 		/* New style list */
 		pList = pGetListInfo(pStyle->usListIndex, pStyle->ucListLevel);
@@ -927,138 +1335,94 @@ vGet8LstInfo(FILE *pFile, const pps_info_type *pPPS,
 		}
 	}
 	aucLstfInfo = xfree(aucLstfInfo);
-} /* end of vGet8LstInfo */
-
-/*
- * Build the lists with Paragraph Information for Word 8/9/10/11 files
- */
-void
-vGet8PapInfo(FILE *pFile, const pps_info_type *pPPS,
-	const ULONG *aulBBD, size_t tBBDLen,
-	const ULONG *aulSBD, size_t tSBDLen,
-	const UCHAR *aucHeader)
-{
-	row_block_type		tRow;
-	style_block_type	tStyle;
-	ULONG		*aulParfPage;
-	UCHAR	*aucBuffer;
-	ULONG	ulCharPos, ulCharPosFirst, ulCharPosLast;
-	ULONG	ulBeginParfInfo;
-	size_t	tParfInfoLen, tOffset, tLen;
-	int	iIndex, iIndex2, iRun, iFodo, iLen;
-	row_info_enum	eRowInfo;
-	USHORT	usIstd;
-	UCHAR	aucFpage[BIG_BLOCK_SIZE];
-
-	fail(pFile == NULL || pPPS == NULL || aucHeader == NULL);
-	fail(aulBBD == NULL || aulSBD == NULL);
-
-	ulBeginParfInfo = ulGetLong(0x102, aucHeader); /* fcPlcfbtePapx */
-	NO_DBG_HEX(ulBeginParfInfo);
-	tParfInfoLen = (size_t)ulGetLong(0x106, aucHeader); /* lcbPlcfbtePapx */
-	NO_DBG_DEC(tParfInfoLen);
-	if (tParfInfoLen < 4) {
-		DBG_DEC(tParfInfoLen);
-		return;
-	}
-
-	aucBuffer = aucFillInfoBuffer(pFile, &pPPS->tTable,
-			aulBBD, tBBDLen, aulSBD, tSBDLen,
-			ulBeginParfInfo, tParfInfoLen);
-	if (aucBuffer == NULL) {
-		return;
-	}
-	NO_DBG_PRINT_BLOCK(aucBuffer, tParfInfoLen);
+} /* end of vGet8LstInfo */
 
-	tLen = (tParfInfoLen / 4 - 1) / 2;
-	aulParfPage = xcalloc(tLen, sizeof(ULONG));
-	for (iIndex = 0, tOffset = (tLen + 1) * 4;
-	     iIndex < (int)tLen;
-	     iIndex++, tOffset += 4) {
-		 aulParfPage[iIndex] = ulGetLong(tOffset, aucBuffer);
-		 NO_DBG_DEC(aulParfPage[iIndex]);
-	}
-	DBG_HEX(ulGetLong(0, aucBuffer));
-	aucBuffer = xfree(aucBuffer);
-	NO_DBG_PRINT_BLOCK(aucHeader, HEADER_SIZE);
+/*
+ * vGet8PapPage - build the lists with the Paragraph Information of one page
+ *
+ * A table row can span pages, so pRow and pulCharPosFirst keep the row that
+ * is being built from one page to the next
+ */
+static void
+vGet8PapPage(const UCHAR *aucFpage,
+	row_block_type *pRow, ULONG *pulCharPosFirst)
+{
+	style_block_type	tStyle;
+	fkp_run_type		atRun[FKP_RUNS_MAX];
+	ULONG	ulCharPos, ulCharPosLast;
+	int	iIndex2, iRun, iFodo, iLen;
+	row_info_enum	eRowInfo;
+	USHORT	usIstd;
 
-	(void)memset(&tRow, 0, sizeof(tRow));
-	ulCharPosFirst = CP_INVALID;
-	for (iIndex = 0; iIndex < (int)tLen; iIndex++) {
-		fail(aulParfPage[iIndex] > ULONG_MAX / BIG_BLOCK_SIZE);
-		if (!bReadBuffer(pFile, pPPS->tWordDocument.ulSB,
-				aulBBD, tBBDLen, BIG_BLOCK_SIZE,
-				aucFpage,
-				aulParfPage[iIndex] * BIG_BLOCK_SIZE,
-				BIG_BLOCK_SIZE)) {
-			break;
+	fail(aucFpage == NULL || pRow == NULL || pulCharPosFirst == NULL);
+
+	NO_DBG_PRINT_BLOCK(aucFpage, BIG_BLOCK_SIZE);
+	iRun = (int)tGetFkpRuns(aucFpage, 13, atRun);
+	NO_DBG_DEC(iRun);
+	for (iIndex2 = 0; iIndex2 < iRun; iIndex2++) {
+		NO_DBG_HEX(atRun[iIndex2].ulCharPosStart);
+		iFodo = atRun[iIndex2].iFodo;
+		if (iFodo <= 0) {
+			continue;
 		}
-		NO_DBG_PRINT_BLOCK(aucFpage, BIG_BLOCK_SIZE);
-		iRun = (int)ucGetByte(0x1ff, aucFpage);
-		NO_DBG_DEC(iRun);
-		for (iIndex2 = 0; iIndex2 < iRun; iIndex2++) {
-			NO_DBG_HEX(ulGetLong(iIndex2 * 4, aucFpage));
-			iFodo = 2 * (int)ucGetByte(
-				(iRun + 1) * 4 + iIndex2 * 13, aucFpage);
-			if (iFodo <= 0) {
-				continue;
-			}
 
+		iLen = 2 * (int)ucGetByte(iFodo, aucFpage);
+		if (iLen == 0) {
+			iFodo++;
 			iLen = 2 * (int)ucGetByte(iFodo, aucFpage);
-			if (iLen == 0) {
-				iFodo++;
-				iLen = 2 * (int)ucGetByte(iFodo, aucFpage);
-			}
+		}
 
-			usIstd = usGetWord(iFodo + 1, aucFpage);
+		usIstd = usGetWord(iFodo + 1, aucFpage);
+		if (!bGetCachedStyleInfo(usIstd,
+				aucFpage + 3 + iFodo, iLen - 2, &tStyle)) {
 			vFillStyleFromStylesheet(usIstd, &tStyle);
-			vGet8StyleInfo(iFodo, aucFpage + 3, iLen - 3, &tStyle);
-			ulCharPos = ulGetLong(iIndex2 * 4, aucFpage);
-			NO_DBG_HEX(ulCharPos);
-			tStyle.ulFileOffset = ulCharPos2FileOffsetX(
-						ulCharPos, &tStyle.eListID);
-			vAdd2StyleInfoList(&tStyle);
-
-			eRowInfo = eGet8RowInfo(iFodo,
-					aucFpage + 3, iLen - 3, &tRow);
-			switch (eRowInfo) {
-			case found_a_cell:
-				if (ulCharPosFirst != CP_INVALID) {
-					break;
-				}
-				ulCharPosFirst = ulGetLong(
-						iIndex2 * 4, aucFpage);
-				NO_DBG_HEX(ulCharPosFirst);
-				tRow.ulCharPosStart = ulCharPosFirst;
-				tRow.ulFileOffsetStart =
-					ulCharPos2FileOffset(ulCharPosFirst);
-				NO_DBG_HEX_C(
-					tRow.ulFileOffsetStart == FC_INVALID,
-					ulCharPosFirst);
-				break;
-			case found_end_of_row:
-				ulCharPosLast = ulGetLong(
-						iIndex2 * 4, aucFpage);
-				NO_DBG_HEX(ulCharPosLast);
-				tRow.ulCharPosEnd = ulCharPosLast;
-				tRow.ulFileOffsetEnd =
-					ulCharPos2FileOffset(ulCharPosLast);
-				NO_DBG_HEX_C(tRow.ulFileOffsetEnd == FC_INVALID,
-							ulCharPosLast);
-				vAdd2RowInfoList(&tRow);
-				(void)memset(&tRow, 0, sizeof(tRow));
-				ulCharPosFirst = CP_INVALID;
-				break;
-			case found_nothing:
-				break;
-			default:
-				DBG_DEC(eRowInfo);
+			vGet8StyleInfo(iFodo,
+				aucFpage + 3, iLen - 3, &tStyle);
+			vAdd2StyleInfoCache(usIstd,
+				aucFpage + 3 + iFodo, iLen - 2, &tStyle);
+		}
+		ulCharPos = atRun[iIndex2].ulCharPosStart;
+		NO_DBG_HEX(ulCharPos);
+		tStyle.ulFileOffset = ulCharPos2FileOffsetX(
+					ulCharPos, &tStyle.eListID);
+		vAdd2StyleInfoList(&tStyle);
+
+		eRowInfo = eGet8RowInfo(iFodo,
+				aucFpage + 3, iLen - 3, pRow);
+		switch (eRowInfo) {
+		case found_a_cell:
+			if (*pulCharPosFirst != CP_INVALID) {
 				break;
 			}
+			*pulCharPosFirst = atRun[iIndex2].ulCharPosStart;
+			NO_DBG_HEX(*pulCharPosFirst);
+			pRow->ulCharPosStart = *pulCharPosFirst;
+			pRow->ulFileOffsetStart =
+				ulCharPos2FileOffset(*pulCharPosFirst);
+			NO_DBG_HEX_C(
+				pRow->ulFileOffsetStart == FC_INVALID,
+				*pulCharPosFirst);
+			break;
+		case found_end_of_row:
+			ulCharPosLast = atRun[iIndex2].ulCharPosStart;
+			NO_DBG_HEX(ulCharPosLast);
+			pRow->ulCharPosEnd = ulCharPosLast;
+			pRow->ulFileOffsetEnd =
+				ulCharPos2FileOffset(ulCharPosLast);
+			NO_DBG_HEX_C(pRow->ulFileOffsetEnd == FC_INVALID,
+						ulCharPosLast);
+			vAdd2RowInfoList(pRow);
+			(void)memset(pRow, 0, sizeof(*pRow));
+			*pulCharPosFirst = CP_INVALID;
+			break;
+		case found_nothing:
+			break;
+		default:
+			DBG_DEC(eRowInfo);
+			break;
 		}
 	}
-	aulParfPage = xfree(aulParfPage);
-} /* end of vGet8PapInfo */
+} /* end of vGet8PapPage */
 
 /*
  * Fill the font information block with information
@@ -1068,246 +1432,21 @@ void
 vGet8FontInfo(int iFodo, USHORT usIstd,
 	const UCHAR *aucGrpprl, int iBytes, font_block_type *pFont)
 {
-	long	lTmp;
-	int	iFodoOff, iInfoLen;
-	USHORT	usFtc0, usFtc1, usFtc2, usTmp;
-	UCHAR	ucTmp;
+	font_sprm_type	tState;
+	USHORT	usFtc0, usFtc1, usFtc2;
 
 	fail(iFodo < 0 || aucGrpprl == NULL || pFont == NULL);
 
-	usFtc0 = USHRT_MAX;
-	usFtc1 = USHRT_MAX;
-	usFtc2 = USHRT_MAX;
-
-	iFodoOff = 0;
-	while (iBytes >= iFodoOff + 2) {
-		switch (usGetWord(iFodo + iFodoOff, aucGrpprl)) {
-		case 0x0800:	/* fRMarkDel */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			if (ucTmp == 0) {
-				pFont->usFontStyle &= ~FONT_MARKDEL;
-			} else {
-				pFont->usFontStyle |= FONT_MARKDEL;
-			}
-			break;
-		case 0x0835:	/* fBold */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			switch (ucTmp) {
-			case   0:	/* Unset */
-				pFont->usFontStyle &= ~FONT_BOLD;
-				break;
-			case   1:	/* Set */
-				pFont->usFontStyle |= FONT_BOLD;
-				break;
-			case 128:	/* Unchanged */
-				break;
-			case 129:	/* Negation */
-				pFont->usFontStyle ^= FONT_BOLD;
-				break;
-			default:
-				DBG_DEC(ucTmp);
-				DBG_FIXME();
-				break;
-			}
-			break;
-		case 0x0836:	/* fItalic */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			switch (ucTmp) {
-			case   0:	/* Unset */
-				pFont->usFontStyle &= ~FONT_ITALIC;
-				break;
-			case   1:	/* Set */
-				pFont->usFontStyle |= FONT_ITALIC;
-				break;
-			case 128:	/* Unchanged */
-				break;
-			case 129:	/* Negation */
-				pFont->usFontStyle ^= FONT_ITALIC;
-				break;
-			default:
-				DBG_DEC(ucTmp);
-				DBG_FIXME();
-				break;
-			}
-			break;
-		case 0x0837:	/* fStrike */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			switch (ucTmp) {
-			case   0:	/* Unset */
-				pFont->usFontStyle &= ~FONT_STRIKE;
-				break;
-			case   1:	/* Set */
-				pFont->usFontStyle |= FONT_STRIKE;
-				break;
-			case 128:	/* Unchanged */
-				break;
-			case 129:	/* Negation */
-				pFont->usFontStyle ^= FONT_STRIKE;
-				break;
-			default:
-				DBG_DEC(ucTmp);
-				DBG_FIXME();
-				break;
-			}
-			break;
-		case 0x083a:	/* fSmallCaps */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			switch (ucTmp) {
-			case   0:	/* Unset */
-				pFont->usFontStyle &= ~FONT_SMALL_CAPITALS;
-				break;
-			case   1:	/* Set */
-				pFont->usFontStyle |= FONT_SMALL_CAPITALS;
-				break;
-			case 128:	/* Unchanged */
-				break;
-			case 129:	/* Negation */
-				pFont->usFontStyle ^= FONT_SMALL_CAPITALS;
-				break;
-			default:
-				DBG_DEC(ucTmp);
-				DBG_FIXME();
-				break;
-			}
-			break;
-		case 0x083b:	/* fCaps */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			switch (ucTmp) {
-			case   0:	/* Unset */
-				pFont->usFontStyle &= ~FONT_CAPITALS;
-				break;
-			case   1:	/* Set */
-				pFont->usFontStyle |= FONT_CAPITALS;
-				break;
-			case 128:	/* Unchanged */
-				break;
-			case 129:	/* Negation */
-				pFont->usFontStyle ^= FONT_CAPITALS;
-				break;
-			default:
-				DBG_DEC(ucTmp);
-				DBG_FIXME();
-				break;
-			}
-			break;
-		case 0x083c:	/* fVanish */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			switch (ucTmp) {
-			case   0:	/* Unset */
-				pFont->usFontStyle &= ~FONT_HIDDEN;
-				break;
-			case   1:	/* Set */
-				pFont->usFontStyle |= FONT_HIDDEN;
-				break;
-			case 128:	/* Unchanged */
-				break;
-			case 129:	/* Negation */
-				pFont->usFontStyle ^= FONT_HIDDEN;
-				break;
-			default:
-				DBG_DEC(ucTmp);
-				DBG_FIXME();
-				break;
-			}
-			break;
-		case 0x2a32:	/* cDefault */
-			pFont->usFontStyle &= FONT_HIDDEN;
-			pFont->ucFontColor = FONT_COLOR_DEFAULT;
-			break;
-		case 0x2a33:	/* cPlain */
-			DBG_MSG("2a33: cPlain");
-			vFillFontFromStylesheet(usIstd, pFont);
-			break;
-		case 0x2a3e:	/* cKul */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			if (ucTmp == 0 || ucTmp == 5) {
-				pFont->usFontStyle &= ~FONT_UNDERLINE;
-			} else {
-				NO_DBG_MSG("Underline text");
-				pFont->usFontStyle |= FONT_UNDERLINE;
-				if (ucTmp == 6) {
-					DBG_MSG("Bold text");
-					pFont->usFontStyle |= FONT_BOLD;
-				}
-			}
-			break;
-		case 0x2a42:	/* cIco */
-			pFont->ucFontColor =
-				ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			NO_DBG_DEC(pFont->ucFontColor);
-			break;
-		case 0x2a44:	/* cHpsInc */
-			DBG_MSG("0x2a44: sprmCHpsInc");
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			DBG_DEC(ucTmp);
-			break;
-		case 0x2a48:	/* cIss */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			ucTmp &= 0x07;
-			if (ucTmp == 1) {
-				pFont->usFontStyle |= FONT_SUPERSCRIPT;
-				NO_DBG_MSG("Superscript");
-			} else if (ucTmp == 2) {
-				pFont->usFontStyle |= FONT_SUBSCRIPT;
-				NO_DBG_MSG("Subscript");
-			}
-			break;
-		case 0x4a30:	/* cIstd */
-			usTmp = usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			NO_DBG_DEC(usTmp);
-			break;
-		case 0x4a43:	/* cHps */
-			pFont->usFontSize =
-				usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			NO_DBG_DEC(pFont->usFontSize);
-			break;
-		case 0x4a4d:	/* cHpsMul */
-			DBG_MSG("0x4a4d: sprmCHpsMul");
-			usTmp = usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			DBG_DEC(usTmp);
-			break;
-		case 0x4a4f:	/* cFtc0 */
-			usFtc0 = usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			break;
-		case 0x4a50:	/* cFtc1 */
-			usFtc1 = usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			break;
-		case 0x4a51:	/* cFtc2 */
-			usFtc2 = usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			break;
-		case 0xca47:	/* cMajority */
-			DBG_MSG("0xca47: sprmCMajority");
-			break;
-		case 0xca4a:	/* cHpsInc1 */
-			usTmp = usGetWord(iFodo + iFodoOff + 2, aucGrpprl);
-			lTmp = (long)pFont->usFontSize + (long)usTmp;
-			if (lTmp < 8) {
-				pFont->usFontSize = 8;
-			} else if (lTmp > 32766) {
-				pFont->usFontSize = 32766;
-			} else {
-				pFont->usFontSize = (USHORT)lTmp;
-			}
-			break;
-		case 0xca4c:	/* cMajority50 */
-			DBG_MSG("0xca4c: sprmCMajority50");
-			break;
-		case 0xea3f:	/* cHps, cHpsPos */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			DBG_DEC(ucTmp);
-			if (ucTmp != 0) {
-				pFont->usFontSize = (USHORT)ucTmp;
-			}
-			ucTmp = ucGetByte(iFodo + iFodoOff + 3, aucGrpprl);
-			DBG_DEC(ucTmp);
-			break;
-		default:
-			break;
-		}
-		iInfoLen = iGet8InfoLength(iFodo + iFodoOff, aucGrpprl);
-		fail(iInfoLen <= 0);
-		iFodoOff += iInfoLen;
-	}
+	tState.pFont = pFont;
+	tState.usIstd = usIstd;
+	tState.ausFtc[0] = USHRT_MAX;
+	tState.ausFtc[1] = USHRT_MAX;
+	tState.ausFtc[2] = USHRT_MAX;
+	vDecodeGrpprl(&tSprm8Table, sprm_target_font,
+			aucGrpprl + iFodo, iBytes, &tState);
+	usFtc0 = tState.ausFtc[0];
+	usFtc1 = tState.ausFtc[1];
+	usFtc2 = tState.ausFtc[2];
 
 	/* Combine the Ftc's to a FontNumber */
 	NO_DBG_DEC_C(usFtc0 != USHRT_MAX, usFtc0);
@@ -1349,148 +1488,421 @@ static BOOL
 bGet8PicInfo(int iFodo,
 	const UCHAR *aucGrpprl, int iBytes, picture_block_type *pPicture)
 {
-	ULONG	ulTmp;
-	int	iFodoOff, iInfoLen;
-	BOOL	bFound;
-	UCHAR	ucTmp;
+	picture_sprm_type	tState;
 
 	fail(iFodo <= 0 || aucGrpprl == NULL || pPicture == NULL);
 
-	iFodoOff = 0;
-	bFound = FALSE;
-	while (iBytes >= iFodoOff + 2) {
-		switch (usGetWord(iFodo + iFodoOff, aucGrpprl)) {
-#if 0
-		case 0x0806:	/* fData */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			if (ucTmp == 0x01) {
-				/* Not a picture, but a form field */
-				return FALSE;
-			}
-			DBG_DEC_C(ucTmp != 0, ucTmp);
-			break;
-#endif
-		case 0x080a:	/* fOle2 */
-			ucTmp = ucGetByte(iFodo + iFodoOff + 2, aucGrpprl);
-			if (ucTmp == 0x01) {
-				/* Not a picture, but an OLE object */
-				return FALSE;
-			}
-			DBG_DEC_C(ucTmp != 0, ucTmp);
-			break;
-		case 0x680e:	/* fcObj */
-			ulTmp = ulGetLong(iFodo + iFodoOff + 2, aucGrpprl);
-			DBG_HEX(ulTmp);
-			break;
-		case 0x6a03:	/* fcPic */
-			pPicture->ulPictureOffset = ulGetLong(
-					iFodo + iFodoOff + 2, aucGrpprl);
-			bFound = TRUE;
-			break;
-		default:
-			break;
+	tState.pPicture = pPicture;
+	tState.bFound = FALSE;
+	tState.bOle = FALSE;
+	vDecodeGrpprl(&tSprm8Table, sprm_target_picture,
+			aucGrpprl + iFodo, iBytes, &tState);
+	return tState.bFound && !tState.bOle;
+} /* end of bGet8PicInfo */
+
+/*
+ * vGet8ChrPage - build the lists with the Character Information of one page
+ */
+static void
+vGet8ChrPage(const UCHAR *aucFpage)
+{
+	font_block_type		tFont;
+	picture_block_type	tPicture;
+	fkp_run_type		atRun[FKP_RUNS_MAX];
+	ULONG	ulFileOffset, ulCharPos;
+	int	iIndex2, iRun, iFodo, iLen;
+	USHORT	usIstd;
+
+	fail(aucFpage == NULL);
+
+	NO_DBG_PRINT_BLOCK(aucFpage, BIG_BLOCK_SIZE);
+	iRun = (int)tGetFkpRuns(aucFpage, 1, atRun);
+	NO_DBG_DEC(iRun);
+	for (iIndex2 = 0; iIndex2 < iRun; iIndex2++) {
+		ulCharPos = atRun[iIndex2].ulCharPosStart;
+		ulFileOffset = ulCharPos2FileOffset(ulCharPos);
+		iFodo = atRun[iIndex2].iFodo;
+
+		iLen = (int)ucGetByte(iFodo, aucFpage);
+
+		usIstd = usGetIstd(ulFileOffset);
+		if (iFodo == 0) {
+			vFillFontFromStylesheet(usIstd, &tFont);
+		} else if (!bGetCachedFontInfo(usIstd,
+				aucFpage + 1 + iFodo, iLen, &tFont)) {
+			vFillFontFromStylesheet(usIstd, &tFont);
+			vGet8FontInfo(iFodo, usIstd,
+				aucFpage + 1, iLen - 1, &tFont);
+			vAdd2FontInfoCache(usIstd,
+				aucFpage + 1 + iFodo, iLen, &tFont);
+		}
+		tFont.ulFileOffset = ulFileOffset;
+		vAdd2FontInfoList(&tFont);
+
+		if (iFodo <= 0) {
+			continue;
+		}
+
+		(void)memset(&tPicture, 0, sizeof(tPicture));
+		if (bGet8PicInfo(iFodo, aucFpage + 1,
+					iLen - 1, &tPicture)) {
+			tPicture.ulFileOffset = ulFileOffset;
+			tPicture.ulFileOffsetPicture =
+				ulDataPos2FileOffset(
+					tPicture.ulPictureOffset);
+			vAdd2PictInfoList(&tPicture);
 		}
-		iInfoLen = iGet8InfoLength(iFodo + iFodoOff, aucGrpprl);
-		fail(iInfoLen <= 0);
-		iFodoOff += iInfoLen;
 	}
-	return bFound;
-} /* end of bGet8PicInfo */
+} /* end of vGet8ChrPage */
 
 /*
- * Build the lists with Character Information for Word 8/9/10/11 files
+ * vDestroy8ChrStream - stop reading the Character Information on demand
  */
 void
-vGet8ChrInfo(FILE *pFile, const pps_info_type *pPPS,
+vDestroy8ChrStream(void)
+{
+	DBG_MSG("vDestroy8ChrStream");
+
+	pChrStreamFile = NULL;
+	aulChrStreamOffset = xfree(aulChrStreamOffset);
+	tChrStreamPages = 0;
+	tChrStreamNext = 0;
+} /* end of vDestroy8ChrStream */
+
+/*
+ * bGet8NextChrPage - read and decode the next page of Character Information
+ *
+ * Only in use when the Character Information is read on demand
+ *
+ * Returns: TRUE when a page was added, FALSE when there are no more pages
+ */
+BOOL
+bGet8NextChrPage(void)
+{
+	UCHAR	aucFpage[BIG_BLOCK_SIZE];
+
+	if (aulChrStreamOffset == NULL) {
+		return FALSE;
+	}
+	if (tChrStreamNext >= tChrStreamPages ||
+	    aulChrStreamOffset[tChrStreamNext] == 0) {
+		vDestroy8ChrStream();
+		return FALSE;
+	}
+	if (!bReadBytes(aucFpage, BIG_BLOCK_SIZE,
+			aulChrStreamOffset[tChrStreamNext], pChrStreamFile)) {
+		werr(0, "Read big block 0x%lx not possible",
+			aulChrStreamOffset[tChrStreamNext]);
+		vDestroy8ChrStream();
+		return FALSE;
+	}
+	tChrStreamNext++;
+	vGet8ChrPage(aucFpage);
+	return TRUE;
+} /* end of bGet8NextChrPage */
+
+/*
+ * aulGet8BinTable - get the FKP page numbers from a bin table
+ *
+ * Returns: the page numbers (tLen of them) or NULL when there are none
+ */
+static ULONG *
+aulGet8BinTable(FILE *pFile, const pps_type *pTable,
 	const ULONG *aulBBD, size_t tBBDLen,
 	const ULONG *aulSBD, size_t tSBDLen,
-	const UCHAR *aucHeader)
+	ULONG ulBeginInfo, size_t tInfoLen, size_t *ptLen)
 {
-	font_block_type		tFont;
-	picture_block_type	tPicture;
-	ULONG		*aulCharPage;
+	ULONG	*aulPage;
 	UCHAR	*aucBuffer;
-	ULONG	ulFileOffset, ulCharPos, ulBeginCharInfo;
-	size_t	tCharInfoLen, tOffset, tLen;
-	int	iIndex, iIndex2, iRun, iFodo, iLen;
-	USHORT	usIstd;
-	UCHAR	aucFpage[BIG_BLOCK_SIZE];
+	size_t	tIndex, tOffset, tLen;
 
-	fail(pFile == NULL || pPPS == NULL || aucHeader == NULL);
-	fail(aulBBD == NULL || aulSBD == NULL);
+	fail(ptLen == NULL);
 
-	ulBeginCharInfo = ulGetLong(0xfa, aucHeader); /* fcPlcfbteChpx */
-	NO_DBG_HEX(ulBeginCharInfo);
-	tCharInfoLen = (size_t)ulGetLong(0xfe, aucHeader); /* lcbPlcfbteChpx */
-	NO_DBG_DEC(tCharInfoLen);
-	if (tCharInfoLen < 4) {
-		DBG_DEC(tCharInfoLen);
-		return;
+	*ptLen = 0;
+	if (tInfoLen < 4) {
+		DBG_DEC(tInfoLen);
+		return NULL;
 	}
 
-	aucBuffer = aucFillInfoBuffer(pFile, &pPPS->tTable,
+	aucBuffer = aucFillInfoBuffer(pFile, pTable,
 			aulBBD, tBBDLen, aulSBD, tSBDLen,
-			ulBeginCharInfo, tCharInfoLen);
+			ulBeginInfo, tInfoLen);
 	if (aucBuffer == NULL) {
-		return;
+		return NULL;
 	}
-	NO_DBG_PRINT_BLOCK(aucBuffer, tCharInfoLen);
+	NO_DBG_PRINT_BLOCK(aucBuffer, tInfoLen);
 
-	tLen = (tCharInfoLen / 4 - 1) / 2;
-	aulCharPage = xcalloc(tLen, sizeof(ULONG));
-	for (iIndex = 0, tOffset = (tLen + 1) * 4;
-	     iIndex < (int)tLen;
-	     iIndex++, tOffset += 4) {
-		 aulCharPage[iIndex] = ulGetLong(tOffset, aucBuffer);
-		 NO_DBG_DEC(aulCharPage[iIndex]);
+	tLen = (tInfoLen / 4 - 1) / 2;
+	if (tLen == 0) {
+		aucBuffer = xfree(aucBuffer);
+		return NULL;
+	}
+	aulPage = xcalloc(tLen, sizeof(ULONG));
+	for (tIndex = 0, tOffset = (tLen + 1) * 4;
+	     tIndex < tLen;
+	     tIndex++, tOffset += 4) {
+		 aulPage[tIndex] = ulGetLong(tOffset, aucBuffer);
+		 NO_DBG_DEC(aulPage[tIndex]);
 	}
 	DBG_HEX(ulGetLong(0, aucBuffer));
 	aucBuffer = xfree(aucBuffer);
+	*ptLen = tLen;
+	return aulPage;
+} /* end of aulGet8BinTable */
+
+/*
+ * iCompareFkpRead - compare two FKP page reads
+ *
+ * Compares on the file offset and then on the place in the page buffer.
+ * For use by qsort(3C).
+ */
+static int
+iCompareFkpRead(const void *pvRead1, const void *pvRead2)
+{
+	const fkp_read_type	*pRead1, *pRead2;
+
+	pRead1 = (const fkp_read_type *)pvRead1;
+	pRead2 = (const fkp_read_type *)pvRead2;
+	if (pRead1->ulFileOffset != pRead2->ulFileOffset) {
+		return pRead1->ulFileOffset < pRead2->ulFileOffset ? -1 : 1;
+	}
+	if (pRead1->tSlot != pRead2->tSlot) {
+		return pRead1->tSlot < pRead2->tSlot ? -1 : 1;
+	}
+	return 0;
+} /* end of iCompareFkpRead */
+
+/*
+ * vGet8FkpOffsets - get the file offsets of FKP pages
+ *
+ * The block chain of the WordDocument stream is walked only once.
+ * Page aulPage[n] is at file offset aulFileOffset[n], 0 means that the page
+ * is not part of the stream
+ */
+static void
+vGet8FkpOffsets(ULONG ulStartBlock, const ULONG *aulBBD, size_t tBBDLen,
+	const ULONG *aulPage, size_t tPages, ULONG *aulFileOffset)
+{
+	ULONG	*aulBlock;
+	ULONG	ulIndex, ulMaxPage;
+	size_t	tIndex, tBlocks;
+
+	fail(aulBBD == NULL || aulPage == NULL || aulFileOffset == NULL);
+	fail(tPages == 0);
+
+	ulMaxPage = 0;
+	for (tIndex = 0; tIndex < tPages; tIndex++) {
+		if (aulPage[tIndex] > ulMaxPage) {
+			ulMaxPage = aulPage[tIndex];
+		}
+	}
+	/* A chain can never be longer than the depot */
+	tBlocks = (size_t)min(ulMaxPage, (ULONG)tBBDLen) + 1;
+	aulBlock = xcalloc(tBlocks, sizeof(ULONG));
+	for (tIndex = 0; tIndex < tBlocks; tIndex++) {
+		aulBlock[tIndex] = END_OF_CHAIN;
+	}
+	for (ulIndex = ulStartBlock, tIndex = 0;
+	     ulIndex != END_OF_CHAIN && tIndex < tBlocks;
+	     ulIndex = aulBBD[ulIndex], tIndex++) {
+		if (ulIndex >= (ULONG)tBBDLen) {
+			DBG_DEC(ulIndex);
+			DBG_DEC(tBBDLen);
+			werr(1, "The Big Block Depot is damaged");
+		}
+		aulBlock[tIndex] = ulIndex;
+	}
+
+	for (tIndex = 0; tIndex < tPages; tIndex++) {
+		if (aulPage[tIndex] >= (ULONG)tBlocks ||
+		    aulBlock[aulPage[tIndex]] == END_OF_CHAIN) {
+			DBG_DEC(aulPage[tIndex]);
+			aulFileOffset[tIndex] = 0;
+			continue;
+		}
+		aulFileOffset[tIndex] = ulDepotOffset(
+			aulBlock[aulPage[tIndex]], BIG_BLOCK_SIZE);
+	}
+	aulBlock = xfree(aulBlock);
+} /* end of vGet8FkpOffsets */
+
+/*
+ * vRead8FkpPages - read FKP pages from the WordDocument stream
+ *
+ * The pages are read in ascending file order, adjacent pages with a single
+ * read. The page at aulFileOffset[n] goes to slot n of aucPages, abRead[n]
+ * tells if it was read
+ */
+static void
+vRead8FkpPages(FILE *pFile, const ULONG *aulFileOffset, size_t tPages,
+	UCHAR *aucPages, BOOL *abRead)
+{
+	fkp_read_type	*atRead;
+	size_t	tIndex, tReads, tRun, tTmp;
+
+	fail(pFile == NULL || aulFileOffset == NULL);
+	fail(aucPages == NULL || abRead == NULL);
+	fail(tPages == 0);
+
+	/* Sort the pages on their place in the file */
+	atRead = xcalloc(tPages, sizeof(fkp_read_type));
+	tReads = 0;
+	for (tIndex = 0; tIndex < tPages; tIndex++) {
+		abRead[tIndex] = FALSE;
+		if (aulFileOffset[tIndex] == 0) {
+			continue;
+		}
+		atRead[tReads].ulFileOffset = aulFileOffset[tIndex];
+		atRead[tReads].tSlot = tIndex;
+		tReads++;
+	}
+	qsort(atRead, tReads, sizeof(fkp_read_type), iCompareFkpRead);
+
+	/* Read the pages, join the ones that follow each other */
+	for (tIndex = 0; tIndex < tReads; tIndex += tRun) {
+		for (tRun = 1; tIndex + tRun < tReads; tRun++) {
+			if (atRead[tIndex + tRun].ulFileOffset !=
+			    atRead[tIndex].ulFileOffset +
+			    (ULONG)tRun * BIG_BLOCK_SIZE ||
+			    atRead[tIndex + tRun].tSlot !=
+			    atRead[tIndex].tSlot + tRun) {
+				break;
+			}
+		}
+		if (!bReadBytes(
+				aucPages + atRead[tIndex].tSlot * BIG_BLOCK_SIZE,
+				tRun * BIG_BLOCK_SIZE,
+				atRead[tIndex].ulFileOffset, pFile)) {
+			werr(0, "Read big block 0x%lx not possible",
+				atRead[tIndex].ulFileOffset);
+			continue;
+		}
+		for (tTmp = 0; tTmp < tRun; tTmp++) {
+			abRead[atRead[tIndex + tTmp].tSlot] = TRUE;
+		}
+	}
+	atRead = xfree(atRead);
+} /* end of vRead8FkpPages */
+
+/*
+ * Build the lists with Paragraph and Character Information for
+ * Word 8/9/10/11 files
+ *
+ * Both bin tables are read first, then their FKP pages in batches of at
+ * most FKP_PAGES_MAX pages. Every page is decoded as soon as its batch is
+ * read. The character information needs the paragraph styles, so the
+ * paragraph pages are decoded before the character pages.
+ * With bStreamChrInfo the character pages are only read when the Font
+ * Information List asks for them.
+ */
+void
+vGet8PapChrInfo(FILE *pFile, const pps_info_type *pPPS,
+	const ULONG *aulBBD, size_t tBBDLen,
+	const ULONG *aulSBD, size_t tSBDLen,
+	const UCHAR *aucHeader, BOOL bChrInfo, BOOL bStreamChrInfo)
+{
+	row_block_type	tRow;
+	ULONG	*aulParfPage, *aulCharPage, *aulPage, *aulFileOffset;
+	UCHAR	*aucPages;
+	ULONG	ulCharPosFirst;
+	size_t	tParfLen, tCharLen, tPages, tFirst, tBatch, tIndex;
+	BOOL	abRead[FKP_PAGES_MAX];
+	BOOL	bParfDone, bCharDone;
+
+	fail(pFile == NULL || pPPS == NULL || aucHeader == NULL);
+	fail(aulBBD == NULL || aulSBD == NULL);
+
 	NO_DBG_PRINT_BLOCK(aucHeader, HEADER_SIZE);
 
-	for (iIndex = 0; iIndex < (int)tLen; iIndex++) {
-		fail(aulCharPage[iIndex] > ULONG_MAX / BIG_BLOCK_SIZE);
-		if (!bReadBuffer(pFile, pPPS->tWordDocument.ulSB,
-				aulBBD, tBBDLen, BIG_BLOCK_SIZE,
-				aucFpage,
-				aulCharPage[iIndex] * BIG_BLOCK_SIZE,
-				BIG_BLOCK_SIZE)) {
+	aulParfPage = aulGet8BinTable(pFile, &pPPS->tTable,
+			aulBBD, tBBDLen, aulSBD, tSBDLen,
+			ulGetLong(0x102, aucHeader), /* fcPlcfbtePapx */
+			(size_t)ulGetLong(0x106, aucHeader), /* lcbPlcfbtePapx */
+			&tParfLen);
+	aulCharPage = NULL;
+	tCharLen = 0;
+	if (bChrInfo) {
+		aulCharPage = aulGet8BinTable(pFile, &pPPS->tTable,
+			aulBBD, tBBDLen, aulSBD, tSBDLen,
+			ulGetLong(0xfa, aucHeader), /* fcPlcfbteChpx */
+			(size_t)ulGetLong(0xfe, aucHeader), /* lcbPlcfbteChpx */
+			&tCharLen);
+	}
+	tPages = tParfLen + tCharLen;
+	if (tPages == 0) {
+		return;
+	}
+
+	/* One list of pages: first the paragraph pages, then the others */
+	aulPage = xcalloc(tPages, sizeof(ULONG));
+	if (tParfLen != 0) {
+		(void)memcpy(aulPage, aulParfPage, tParfLen * sizeof(ULONG));
+		aulParfPage = xfree(aulParfPage);
+	}
+	if (tCharLen != 0) {
+		(void)memcpy(aulPage + tParfLen, aulCharPage,
+				tCharLen * sizeof(ULONG));
+		aulCharPage = xfree(aulCharPage);
+	}
+	aulFileOffset = xcalloc(tPages, sizeof(ULONG));
+	vGet8FkpOffsets(pPPS->tWordDocument.ulSB, aulBBD, tBBDLen,
+			aulPage, tPages, aulFileOffset);
+	aulPage = xfree(aulPage);
+
+	if (bStreamChrInfo && tCharLen != 0) {
+		/* Keep the character pages for later */
+		vDestroy8ChrStream();
+		pChrStreamFile = pFile;
+		aulChrStreamOffset = xcalloc(tCharLen, sizeof(ULONG));
+		(void)memcpy(aulChrStreamOffset, aulFileOffset + tParfLen,
+				tCharLen * sizeof(ULONG));
+		tChrStreamPages = tCharLen;
+		tChrStreamNext = 0;
+		vSetFontInfoStreaming(TRUE);
+		tPages = tParfLen;
+	}
+
+	if (tPages == 0) {
+		aulFileOffset = xfree(aulFileOffset);
+		return;
+	}
+
+	aucPages = xmalloc(min(tPages, (size_t)FKP_PAGES_MAX) * BIG_BLOCK_SIZE);
+	(void)memset(&tRow, 0, sizeof(tRow));
+	ulCharPosFirst = CP_INVALID;
+	/* Both kinds of information stop at their first unreadable page */
+	bParfDone = tParfLen == 0;
+	bCharDone = tPages == tParfLen;
+	for (tFirst = 0; tFirst < tPages; tFirst += tBatch) {
+		if (bParfDone && bCharDone) {
 			break;
 		}
-		NO_DBG_PRINT_BLOCK(aucFpage, BIG_BLOCK_SIZE);
-		iRun = (int)ucGetByte(0x1ff, aucFpage);
-		NO_DBG_DEC(iRun);
-		for (iIndex2 = 0; iIndex2 < iRun; iIndex2++) {
-			ulCharPos = ulGetLong(iIndex2 * 4, aucFpage);
-			ulFileOffset = ulCharPos2FileOffset(ulCharPos);
-			iFodo = 2 * (int)ucGetByte(
-				(iRun + 1) * 4 + iIndex2, aucFpage);
-
-			iLen = (int)ucGetByte(iFodo, aucFpage);
-
-			usIstd = usGetIstd(ulFileOffset);
-			vFillFontFromStylesheet(usIstd, &tFont);
-			if (iFodo != 0) {
-				vGet8FontInfo(iFodo, usIstd,
-					aucFpage + 1, iLen - 1, &tFont);
+		tBatch = min(tPages - tFirst, (size_t)FKP_PAGES_MAX);
+		vRead8FkpPages(pFile, aulFileOffset + tFirst, tBatch,
+				aucPages, abRead);
+		for (tIndex = 0; tIndex < tBatch; tIndex++) {
+			if (tFirst + tIndex < tParfLen) {
+				if (bParfDone) {
+					continue;
+				}
+				if (!abRead[tIndex]) {
+					bParfDone = TRUE;
+					continue;
+				}
+				vGet8PapPage(aucPages + tIndex * BIG_BLOCK_SIZE,
+						&tRow, &ulCharPosFirst);
+				continue;
 			}
-			tFont.ulFileOffset = ulFileOffset;
-			vAdd2FontInfoList(&tFont);
-
-			if (iFodo <= 0) {
+			if (bCharDone) {
 				continue;
 			}
-
-			(void)memset(&tPicture, 0, sizeof(tPicture));
-			if (bGet8PicInfo(iFodo, aucFpage + 1,
-						iLen - 1, &tPicture)) {
-				tPicture.ulFileOffset = ulFileOffset;
-				tPicture.ulFileOffsetPicture =
-					ulDataPos2FileOffset(
-						tPicture.ulPictureOffset);
-				vAdd2PictInfoList(&tPicture);
+			if (!abRead[tIndex]) {
+				bCharDone = TRUE;
+				continue;
 			}
+			vGet8ChrPage(aucPages + tIndex * BIG_BLOCK_SIZE);
 		}
 	}
-	aulCharPage = xfree(aulCharPage);
-} /* end of vGet8ChrInfo */
+	aucPages = xfree(aucPages);
+	aulFileOffset = xfree(aulFileOffset);
+} /* end of vGet8PapChrInfo */
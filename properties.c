@@ -6,10 +6,200 @@
  * Read the properties information from a MS Word file
  */
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include "antiword.h"
 
+/* Number of buckets in the property cache, must be a power of two */
+#define PROP_CACHE_BUCKETS	512
+
+/*
+ * One decoded run: the raw grpprl bytes and the style index are the key,
+ * the font or style information they decode to is the value
+ */
+typedef struct prop_cache_tag {
+	struct prop_cache_tag	*pNext;
+	union {
+		font_block_type		tFont;
+		style_block_type	tStyle;
+	} uInfo;
+	ULONG	ulHash;
+	size_t	tBytes;
+	USHORT	usIstd;
+	BOOL	bStyle;
+	UCHAR	aucGrpprl[1];	/* Really tBytes long */
+} prop_cache_type;
+
+/* Variables needed to keep the property cache */
+static prop_cache_type	*apPropCache[PROP_CACHE_BUCKETS];
+
+
+/*
+ * tGetFkpRuns - turn a Formatted Disk Page into a table of runs
+ *
+ * tBxSize is the size of the entry that follows the character positions,
+ * 1 for character pages, 7 or 13 for Word 6/7 or Word 8/9/10/11 paragraph
+ * pages. The run table must have room for FKP_RUNS_MAX runs.
+ *
+ * Returns: the number of runs
+ */
+size_t
+tGetFkpRuns(const UCHAR *aucFpage, size_t tBxSize, fkp_run_type *atRun)
+{
+	const UCHAR	*aucBx;
+	size_t	tRun, tIndex;
+
+	fail(aucFpage == NULL || atRun == NULL);
+	fail(tBxSize == 0);
+
+	tRun = (size_t)ucGetByte(BIG_BLOCK_SIZE - 1, aucFpage);
+	if ((tRun + 1) * 4 + tRun * tBxSize >= BIG_BLOCK_SIZE) {
+		/* More runs than fit in the page */
+		DBG_DEC(tRun);
+		tRun = (BIG_BLOCK_SIZE - 1 - 4) / (4 + tBxSize);
+	}
+	fail(tRun > FKP_RUNS_MAX);
+
+	for (tIndex = 0; tIndex < tRun; tIndex++) {
+		atRun[tIndex].ulCharPosStart =
+			ulGetLong(tIndex * 4, aucFpage);
+		atRun[tIndex].ulCharPosEnd =
+			ulGetLong(tIndex * 4 + 4, aucFpage);
+	}
+	aucBx = aucFpage + (tRun + 1) * 4;
+	for (tIndex = 0; tIndex < tRun; tIndex++) {
+		atRun[tIndex].iFodo =
+			2 * (int)ucGetByte(tIndex * tBxSize, aucBx);
+	}
+	return tRun;
+} /* end of tGetFkpRuns */
+
+/*
+ * iGetSprmLength - the length of a sprm in a Word 1/2/6/7 grpprl
+ *
+ * aucSprmLength holds the length of every sprm, including the opcode
+ *
+ * Returns: the number of bytes taken by the sprm at iByteNbr
+ */
+int
+iGetSprmLength(const UCHAR *aucSprmLength, int iByteNbr,
+	const UCHAR *aucGrpprl)
+{
+	int	iTmp, iDel, iAdd;
+
+	fail(aucSprmLength == NULL || aucGrpprl == NULL);
+
+	switch (aucSprmLength[ucGetByte(iByteNbr, aucGrpprl)]) {
+	case SPRM_VAR:
+		return 2 + (int)ucGetByte(iByteNbr + 1, aucGrpprl);
+	case SPRM_TAB:
+		iTmp = (int)ucGetByte(iByteNbr + 1, aucGrpprl);
+		if (iTmp == 255) {
+			iDel = (int)ucGetByte(iByteNbr + 2, aucGrpprl);
+			iAdd = (int)ucGetByte(
+					iByteNbr + 3 + iDel * 4, aucGrpprl);
+			iTmp = 2 + iDel * 4 + iAdd * 3;
+		}
+		return 2 + iTmp;
+	default:
+		return (int)aucSprmLength[ucGetByte(iByteNbr, aucGrpprl)];
+	}
+} /* end of iGetSprmLength */
+
+/*
+ * pGetSprm - find an opcode in an opcode table
+ *
+ * Returns: the table entry, NULL when the opcode is not in the table
+ */
+static const sprm_type *
+pGetSprm(const sprm_table_type *pTable, USHORT usOpCode)
+{
+	size_t	tLow, tHigh, tMiddle;
+
+	tLow = 0;
+	tHigh = pTable->tSprms;
+	while (tLow < tHigh) {
+		tMiddle = tLow + (tHigh - tLow) / 2;
+		if (pTable->atSprm[tMiddle].usOpCode == usOpCode) {
+			return &pTable->atSprm[tMiddle];
+		}
+		if (pTable->atSprm[tMiddle].usOpCode < usOpCode) {
+			tLow = tMiddle + 1;
+		} else {
+			tHigh = tMiddle;
+		}
+	}
+	return NULL;
+} /* end of pGetSprm */
+
+/*
+ * vDecodeGrpprl - decode a grpprl into the information block of a target
+ *
+ * Walks the sprms once and calls the handler of the given target for
+ * every opcode that has one. pvTarget is the decoder state of the target.
+ */
+void
+vDecodeGrpprl(const sprm_table_type *pTable, sprm_target_enum eTarget,
+	const UCHAR *aucGrpprl, int iBytes, void *pvTarget)
+{
+	const sprm_type	*pSprm;
+	int	iFodoOff, iInfoLen;
+	USHORT	usOpCode;
+
+	fail(pTable == NULL || aucGrpprl == NULL || pvTarget == NULL);
+	fail(eTarget >= sprm_target_max);
+	fail(pTable->iOpCodeLen != 1 && pTable->iOpCodeLen != 2);
+
+	iFodoOff = 0;
+	while (iBytes >= iFodoOff + pTable->iOpCodeLen) {
+		if (pTable->iOpCodeLen == 1) {
+			usOpCode = (USHORT)ucGetByte(iFodoOff, aucGrpprl);
+		} else {
+			usOpCode = usGetWord(iFodoOff, aucGrpprl);
+		}
+		iInfoLen = 0;
+		pSprm = pGetSprm(pTable, usOpCode);
+		if (pSprm != NULL && pSprm->apfHandler[eTarget] != NULL) {
+			iInfoLen = pSprm->apfHandler[eTarget](pvTarget,
+					aucGrpprl + iFodoOff,
+					iBytes - iFodoOff,
+					pSprm->usParam);
+		}
+		if (iInfoLen <= 0) {
+			iInfoLen = pTable->piGetLength(iFodoOff, aucGrpprl);
+			fail(iInfoLen <= 0);
+		}
+		iFodoOff += iInfoLen;
+	}
+} /* end of vDecodeGrpprl */
+
+/*
+ * vSetFontToggle - apply the value of a toggling character property
+ */
+void
+vSetFontToggle(font_block_type *pFont, USHORT usFontStyle, UCHAR ucValue)
+{
+	fail(pFont == NULL);
+
+	switch (ucValue) {
+	case   0:	/* Unset */
+		pFont->usFontStyle &= ~usFontStyle;
+		break;
+	case   1:	/* Set */
+		pFont->usFontStyle |= usFontStyle;
+		break;
+	case 128:	/* Unchanged */
+		break;
+	case 129:	/* Negation */
+		pFont->usFontStyle ^= usFontStyle;
+		break;
+	default:
+		DBG_DEC(ucValue);
+		DBG_FIXME();
+		break;
+	}
+} /* end of vSetFontToggle */
 
 /*
  * Build the lists with Property Information
@@ -21,6 +211,7 @@ vGetPropertyInfo(FILE *pFile, const pps_info_type *pPPS,
 	const UCHAR *aucHeader, int iWordVersion)
 {
 	options_type	tOptions;
+	BOOL	bChrInfo, bStreamChrInfo;
 
 	TRACE_MSG("vGetPropertyInfo");
 
@@ -30,8 +221,22 @@ vGetPropertyInfo(FILE *pFile, const pps_info_type *pPPS,
 	fail(aulSBD == NULL && tSBDLen != 0);
 	fail(aucHeader == NULL);
 
+	vStartPhase(stats_phase_properties);
+
 	/* Get the options */
 	vGetOptions(&tOptions);
+	/* The character information holds the fonts and the pictures */
+	bChrInfo = tOptions.eConversionType == conversion_draw ||
+		tOptions.eConversionType == conversion_ps ||
+		tOptions.eConversionType == conversion_xml ||
+		tOptions.eConversionType == conversion_fmt_text ||
+		tOptions.eConversionType == conversion_pdf ||
+		tOptions.szExtractDirectory != NULL;
+	/* Only these conversions walk the font information just once */
+	bStreamChrInfo = tOptions.bStreamFontInfo &&
+		(tOptions.eConversionType == conversion_xml ||
+		 tOptions.eConversionType == conversion_fmt_text) &&
+		tOptions.szExtractDirectory == NULL;
 
 	/* Get the property information per Word version */
 	switch (iWordVersion) {
@@ -39,11 +244,7 @@ vGetPropertyInfo(FILE *pFile, const pps_info_type *pPPS,
 		vGet0DopInfo(pFile, aucHeader);
 		vGet0SepInfo(pFile, aucHeader);
 		vGet0PapInfo(pFile, aucHeader);
-		if (tOptions.eConversionType == conversion_draw ||
-		    tOptions.eConversionType == conversion_ps ||
-		    tOptions.eConversionType == conversion_xml ||
-		    tOptions.eConversionType == conversion_fmt_text ||
-		    tOptions.eConversionType == conversion_pdf) {
+		if (bChrInfo) {
 			vGet0ChrInfo(pFile, aucHeader);
 		}
 		if (tOptions.eConversionType == conversion_draw ||
@@ -63,11 +264,7 @@ vGetPropertyInfo(FILE *pFile, const pps_info_type *pPPS,
 		    tOptions.eConversionType == conversion_pdf) {
 			vGet2HdrFtrInfo(pFile, aucHeader);
 		}
-		if (tOptions.eConversionType == conversion_draw ||
-		    tOptions.eConversionType == conversion_ps ||
-		    tOptions.eConversionType == conversion_xml ||
-		    tOptions.eConversionType == conversion_fmt_text ||
-		    tOptions.eConversionType == conversion_pdf) {
+		if (bChrInfo) {
 			vGet2ChrInfo(pFile, iWordVersion, aucHeader);
 		}
 		if (tOptions.eConversionType == conversion_draw ||
@@ -95,11 +292,7 @@ vGetPropertyInfo(FILE *pFile, const pps_info_type *pPPS,
 			vGet6HdrFtrInfo(pFile, pPPS->tWordDocument.ulSB,
 				aulBBD, tBBDLen, aucHeader);
 		}
-		if (tOptions.eConversionType == conversion_draw ||
-		    tOptions.eConversionType == conversion_ps ||
-		    tOptions.eConversionType == conversion_xml ||
-		    tOptions.eConversionType == conversion_fmt_text ||
-		    tOptions.eConversionType == conversion_pdf) {
+		if (bChrInfo) {
 			vGet6ChrInfo(pFile, pPPS->tWordDocument.ulSB,
 				aulBBD, tBBDLen, aucHeader);
 		}
@@ -121,21 +314,14 @@ vGetPropertyInfo(FILE *pFile, const pps_info_type *pPPS,
 			aulBBD, tBBDLen, aulSBD, tSBDLen, aucHeader);
 		vGet8SepInfo(pFile, pPPS,
 			aulBBD, tBBDLen, aulSBD, tSBDLen, aucHeader);
-		vGet8PapInfo(pFile, pPPS,
-			aulBBD, tBBDLen, aulSBD, tSBDLen, aucHeader);
 		if (tOptions.eConversionType == conversion_ps ||
 		    tOptions.eConversionType == conversion_pdf) {
 			vGet8HdrFtrInfo(pFile, &pPPS->tTable,
 				aulBBD, tBBDLen, aulSBD, tSBDLen, aucHeader);
 		}
-		if (tOptions.eConversionType == conversion_draw ||
-		    tOptions.eConversionType == conversion_ps ||
-		    tOptions.eConversionType == conversion_xml ||
-		    tOptions.eConversionType == conversion_fmt_text ||
-		    tOptions.eConversionType == conversion_pdf) {
-			vGet8ChrInfo(pFile, pPPS,
-				aulBBD, tBBDLen, aulSBD, tSBDLen, aucHeader);
-		}
+		vGet8PapChrInfo(pFile, pPPS,
+			aulBBD, tBBDLen, aulSBD, tSBDLen, aucHeader,
+			bChrInfo, bStreamChrInfo);
 		if (tOptions.eConversionType == conversion_draw ||
 		    tOptions.eConversionType == conversion_ps ||
 		    tOptions.eConversionType == conversion_pdf) {
@@ -154,21 +340,23 @@ vGetPropertyInfo(FILE *pFile, const pps_info_type *pPPS,
 
 	/* Temporarily: Correct the font table */
 	vCorrectFontTable(tOptions.eConversionType, tOptions.eEncoding);
+
+	vStopPhase(stats_phase_properties);
 } /* end of vGetPropertyInfo */
 
 /*
- * ePropMod2RowInfo - Turn the Property Modifier into row information
+ * eDecodePropModRowInfo - decode the row information of a Property Modifier
  *
  * Returns: the row information
  */
-row_info_enum
-ePropMod2RowInfo(USHORT usPropMod, int iWordVersion)
+static row_info_enum
+eDecodePropModRowInfo(USHORT usPropMod, int iWordVersion)
 {
 	row_block_type	tRow;
 	const UCHAR	*aucPropMod;
 	int	iLen;
 
-	TRACE_MSG("ePropMod2RowInfo");
+	TRACE_MSG("eDecodePropModRowInfo");
 
 	aucPropMod = aucReadPropModListItem(usPropMod);
 	if (aucPropMod == NULL) {
@@ -195,4 +383,209 @@ ePropMod2RowInfo(USHORT usPropMod, int iWordVersion)
 		DBG_FIXME();
 		return found_nothing;
 	}
+} /* end of eDecodePropModRowInfo */
+
+/*
+ * ePropMod2RowInfo - Turn the Property Modifier into row information
+ *
+ * The result is the same for every character with this Property Modifier,
+ * so it is decoded only once per document
+ *
+ * Returns: the row information
+ */
+row_info_enum
+ePropMod2RowInfo(USHORT usPropMod, int iWordVersion)
+{
+	row_info_enum	eRowInfo;
+	int	iRowInfo;
+
+	iRowInfo = iGetPropModRowInfo(usPropMod);
+	if (iRowInfo >= 0) {
+		return (row_info_enum)iRowInfo;
+	}
+	eRowInfo = eDecodePropModRowInfo(usPropMod, iWordVersion);
+	vSetPropModRowInfo(usPropMod, eRowInfo);
+	return eRowInfo;
 } /* end of ePropMod2RowInfo */
+
+/*
+ * vDestroyPropertyCache - destroy the property cache
+ */
+void
+vDestroyPropertyCache(void)
+{
+	prop_cache_type	*pCurr, *pNext;
+	size_t	tIndex;
+
+	DBG_MSG("vDestroyPropertyCache");
+
+	for (tIndex = 0; tIndex < elementsof(apPropCache); tIndex++) {
+		pCurr = apPropCache[tIndex];
+		while (pCurr != NULL) {
+			pNext = pCurr->pNext;
+			pCurr = xfree(pCurr);
+			pCurr = pNext;
+		}
+		apPropCache[tIndex] = NULL;
+	}
+} /* end of vDestroyPropertyCache */
+
+/*
+ * ulHashProperties - compute the hash value of a property cache key
+ *
+ * FNV-1a over the style index and the raw grpprl bytes
+ */
+static ULONG
+ulHashProperties(BOOL bStyle, USHORT usIstd,
+	const UCHAR *aucGrpprl, size_t tBytes)
+{
+	ULONG	ulHash;
+	size_t	tIndex;
+
+	ulHash = 2166136261UL;
+	ulHash = ((ulHash ^ (ULONG)bStyle) * 16777619UL) & 0xffffffffUL;
+	ulHash = ((ulHash ^ (usIstd & 0xff)) * 16777619UL) & 0xffffffffUL;
+	ulHash = ((ulHash ^ (usIstd >> 8)) * 16777619UL) & 0xffffffffUL;
+	for (tIndex = 0; tIndex < tBytes; tIndex++) {
+		ulHash ^= (ULONG)aucGrpprl[tIndex];
+		ulHash = (ulHash * 16777619UL) & 0xffffffffUL;
+	}
+	return ulHash;
+} /* end of ulHashProperties */
+
+/*
+ * pFindCachedProperties - find a property cache entry
+ *
+ * Returns: the entry when found, otherwise NULL
+ */
+static const prop_cache_type *
+pFindCachedProperties(BOOL bStyle, USHORT usIstd,
+	const UCHAR *aucGrpprl, size_t tBytes, ULONG ulHash)
+{
+	const prop_cache_type	*pCurr;
+
+	for (pCurr = apPropCache[ulHash & (PROP_CACHE_BUCKETS - 1)];
+	     pCurr != NULL;
+	     pCurr = pCurr->pNext) {
+		if (pCurr->ulHash == ulHash &&
+		    pCurr->bStyle == bStyle &&
+		    pCurr->usIstd == usIstd &&
+		    pCurr->tBytes == tBytes &&
+		    memcmp(pCurr->aucGrpprl, aucGrpprl, tBytes) == 0) {
+			return pCurr;
+		}
+	}
+	return NULL;
+} /* end of pFindCachedProperties */
+
+/*
+ * pAdd2PropertyCache - add a new entry to the property cache
+ *
+ * Returns: the new entry, the caller fills in the value
+ */
+static prop_cache_type *
+pAdd2PropertyCache(BOOL bStyle, USHORT usIstd,
+	const UCHAR *aucGrpprl, size_t tBytes, ULONG ulHash)
+{
+	prop_cache_type	*pNew;
+	size_t	tBucket;
+
+	pNew = xmalloc(offsetof(prop_cache_type, aucGrpprl) + tBytes + 1);
+	pNew->ulHash = ulHash;
+	pNew->tBytes = tBytes;
+	pNew->usIstd = usIstd;
+	pNew->bStyle = bStyle;
+	(void)memcpy(pNew->aucGrpprl, aucGrpprl, tBytes);
+	tBucket = (size_t)(ulHash & (PROP_CACHE_BUCKETS - 1));
+	pNew->pNext = apPropCache[tBucket];
+	apPropCache[tBucket] = pNew;
+	return pNew;
+} /* end of pAdd2PropertyCache */
+
+/*
+ * bGetCachedFontInfo - get the font information of an earlier identical run
+ *
+ * The key must hold every byte the decoder can read. The decoders look at
+ * the operand of a sprm that starts two bytes before their byte count, so
+ * the key is one byte longer than the count they are given.
+ *
+ * Returns: TRUE when found, otherwise FALSE
+ */
+BOOL
+bGetCachedFontInfo(USHORT usIstd, const UCHAR *aucGrpprl, int iBytes,
+	font_block_type *pFont)
+{
+	const prop_cache_type	*pEntry;
+	size_t	tBytes;
+
+	fail(aucGrpprl == NULL || pFont == NULL);
+
+	tBytes = iBytes <= 0 ? 0 : (size_t)iBytes;
+	pEntry = pFindCachedProperties(FALSE, usIstd, aucGrpprl, tBytes,
+		ulHashProperties(FALSE, usIstd, aucGrpprl, tBytes));
+	if (pEntry == NULL) {
+		return FALSE;
+	}
+	*pFont = pEntry->uInfo.tFont;
+	return TRUE;
+} /* end of bGetCachedFontInfo */
+
+/*
+ * vAdd2FontInfoCache - remember the font information of a decoded run
+ */
+void
+vAdd2FontInfoCache(USHORT usIstd, const UCHAR *aucGrpprl, int iBytes,
+	const font_block_type *pFont)
+{
+	prop_cache_type	*pNew;
+	size_t	tBytes;
+
+	fail(aucGrpprl == NULL || pFont == NULL);
+
+	tBytes = iBytes <= 0 ? 0 : (size_t)iBytes;
+	pNew = pAdd2PropertyCache(FALSE, usIstd, aucGrpprl, tBytes,
+		ulHashProperties(FALSE, usIstd, aucGrpprl, tBytes));
+	pNew->uInfo.tFont = *pFont;
+} /* end of vAdd2FontInfoCache */
+
+/*
+ * bGetCachedStyleInfo - get the style information of an earlier identical run
+ *
+ * Returns: TRUE when found, otherwise FALSE
+ */
+BOOL
+bGetCachedStyleInfo(USHORT usIstd, const UCHAR *aucGrpprl, int iBytes,
+	style_block_type *pStyle)
+{
+	const prop_cache_type	*pEntry;
+	size_t	tBytes;
+
+	fail(aucGrpprl == NULL || pStyle == NULL);
+
+	tBytes = iBytes <= 0 ? 0 : (size_t)iBytes;
+	pEntry = pFindCachedProperties(TRUE, usIstd, aucGrpprl, tBytes,
+		ulHashProperties(TRUE, usIstd, aucGrpprl, tBytes));
+	if (pEntry == NULL) {
+		return FALSE;
+	}
+	*pStyle = pEntry->uInfo.tStyle;
+	return TRUE;
+} /* end of bGetCachedStyleInfo */
+
+/*
+ * vAdd2StyleInfoCache - remember the style information of a decoded run
+ */
+void
+vAdd2StyleInfoCache(USHORT usIstd, const UCHAR *aucGrpprl, int iBytes,
+	const style_block_type *pStyle)
+{
+	prop_cache_type	*pNew;
+	size_t	tBytes;
+
+	fail(aucGrpprl == NULL || pStyle == NULL);
+
+	tBytes = iBytes <= 0 ? 0 : (size_t)iBytes;
+	pNew = pAdd2PropertyCache(TRUE, usIstd, aucGrpprl, tBytes,
+		ulHashProperties(TRUE, usIstd, aucGrpprl, tBytes));
+	pNew->uInfo.tStyle = *pStyle;
+} /* end of vAdd2StyleInfoCache */
@@ -8,6 +8,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
 #include "antiword.h"
 
 #if defined(DEBUG)
@@ -20,6 +21,9 @@
 static UCHAR	**ppAnchor = NULL;
 static size_t	tNextFree = 0;
 static size_t	tMaxElements = 0;
+/* The row information per list element, 0 when not known yet */
+static UCHAR	*aucRowInfo = NULL;
+static size_t	tRowInfoLen = 0;
 
 
 /*
@@ -38,7 +42,10 @@ vDestroyPropModList(void)
 	}
 	/* Free the list itself */
 	ppAnchor = xfree(ppAnchor);
+	/* Free the row information */
+	aucRowInfo = xfree(aucRowInfo);
 	/* Reset all control variables */
+	tRowInfoLen = 0;
 	tNextFree = 0;
 	tMaxElements = 0;
 } /* end of vDestroyPropModList */
@@ -108,3 +115,54 @@ aucReadPropModListItem(USHORT usPropMod)
 	}
 	return ppAnchor[tIndex];
 } /* end of aucGetPropModListItem */
+
+/*
+ * iGetPropModRowInfo - get the remembered row information
+ *
+ * Only the property modifiers that refer to the list are remembered, the
+ * others hold the information in themselves
+ *
+ * Returns the row information of the given property modifier or -1 when
+ * it is not known yet
+ */
+int
+iGetPropModRowInfo(USHORT usPropMod)
+{
+	size_t	tIndex;
+
+	if (!odd(usPropMod)) {
+		return -1;
+	}
+	tIndex = (size_t)(usPropMod >> 1);
+	if (tIndex >= tRowInfoLen || aucRowInfo[tIndex] == 0) {
+		return -1;
+	}
+	return (int)aucRowInfo[tIndex] - 1;
+} /* end of iGetPropModRowInfo */
+
+/*
+ * vSetPropModRowInfo - remember the row information of a property modifier
+ */
+void
+vSetPropModRowInfo(USHORT usPropMod, row_info_enum eRowInfo)
+{
+	size_t	tIndex;
+
+	fail((int)eRowInfo < 0 || (int)eRowInfo >= UCHAR_MAX);
+
+	if (!odd(usPropMod)) {
+		return;
+	}
+	tIndex = (size_t)(usPropMod >> 1);
+	if (tIndex >= tNextFree) {
+		return;
+	}
+	if (tIndex >= tRowInfoLen) {
+		/* One entry for every element of the list */
+		aucRowInfo = xrealloc(aucRowInfo, tNextFree * sizeof(UCHAR));
+		(void)memset(aucRowInfo + tRowInfoLen, 0,
+			(tNextFree - tRowInfoLen) * sizeof(UCHAR));
+		tRowInfoLen = tNextFree;
+	}
+	aucRowInfo[tIndex] = (UCHAR)eRowInfo + 1;
+} /* end of vSetPropModRowInfo */
@@ -76,6 +76,7 @@ vAdd2RowInfoList(const row_block_type *pRowBlock)
 	NO_DBG_DEC(pRowBlock->ucNumberOfColumns);
 
 	/* Create the new list member */
+	vCountListItem(stats_list_rows);
 	pListMember = xmalloc(sizeof(row_desc_type));
 	/* Fill the new list member */
 	pListMember->tInfo = *pRowBlock;
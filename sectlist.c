@@ -24,8 +24,29 @@ typedef struct section_mem_tag {
 /* Variables needed to write the Section Information List */
 static section_mem_type	*pAnchor = NULL;
 static section_mem_type	*pSectionLast = NULL;
+/* Variables needed to find the sections without a search */
+static const section_mem_type	**apSectionTable = NULL;
+static size_t		tSectionTableLen = 0;
+static BOOL		bSectionsSorted = TRUE;
+static size_t		tSectionCursor = 0;
+static ULONG		ulCursorCharPos = 0;
 
 
+/*
+ * vDestroySectionTable - destroy the section table
+ *
+ * It is built again when it is needed
+ */
+static void
+vDestroySectionTable(void)
+{
+	apSectionTable = xfree(apSectionTable);
+	tSectionTableLen = 0;
+	bSectionsSorted = TRUE;
+	tSectionCursor = 0;
+	ulCursorCharPos = 0;
+} /* end of vDestroySectionTable */
+
 /*
  * vDestroySectionInfoList - destroy the Section Information List
  */
@@ -36,6 +57,8 @@ vDestroySectionInfoList(void)
 
 	DBG_MSG("vDestroySectionInfoList");
 
+	vDestroySectionTable();
+
 	/* Free the Section Information List */
 	pCurr = pAnchor;
 	while (pCurr != NULL) {
@@ -58,7 +81,11 @@ vAdd2SectionInfoList(const section_block_type *pSection, ULONG ulCharPos)
 
 	fail(pSection == NULL);
 
+	/* The section table is out of date now */
+	vDestroySectionTable();
+
 	/* Create list member */
+	vCountListItem(stats_list_sections);
 	pListMember = xmalloc(sizeof(section_mem_type));
 	/* Fill the list member */
 	pListMember->tInfo = *pSection;
@@ -96,13 +123,49 @@ vDefault2SectionInfoList(ULONG ulCharPos)
 	vAdd2SectionInfoList(&tSection, ulCharPos);
 } /* end of vDefault2SectionInfoList */
 
+/*
+ * vBuildSectionTable - build the table with all the sections in list order
+ */
+static void
+vBuildSectionTable(void)
+{
+	const section_mem_type	*pCurr;
+	size_t	tIndex;
+
+	fail(apSectionTable != NULL);
+
+	tSectionTableLen = 0;
+	for (pCurr = pAnchor; pCurr != NULL; pCurr = pCurr->pNext) {
+		tSectionTableLen++;
+	}
+	apSectionTable = xcalloc(max(tSectionTableLen, 1),
+				sizeof(const section_mem_type *));
+	bSectionsSorted = TRUE;
+	for (tIndex = 0, pCurr = pAnchor;
+	     pCurr != NULL;
+	     tIndex++, pCurr = pCurr->pNext) {
+		apSectionTable[tIndex] = pCurr;
+		if (tIndex != 0 &&
+		    pCurr->ulCharPos < apSectionTable[tIndex - 1]->ulCharPos) {
+			bSectionsSorted = FALSE;
+		}
+	}
+	DBG_MSG_C(!bSectionsSorted, "The sections are not sorted");
+	tSectionCursor = 0;
+	ulCursorCharPos = 0;
+} /* end of vBuildSectionTable */
+
 /*
  * pGetSectionInfo - get the section information
+ *
+ * The character positions usually come in increasing order, so the search
+ * continues from where the previous one stopped
  */
 const section_block_type *
 pGetSectionInfo(const section_block_type *pOld, ULONG ulCharPos)
 {
 	const section_mem_type	*pCurr;
+	size_t	tLow, tHigh, tMid;
 
 	if (pOld == NULL || ulCharPos == 0) {
 		if (pAnchor == NULL) {
@@ -116,13 +179,53 @@ pGetSectionInfo(const section_block_type *pOld, ULONG ulCharPos)
 	}
 
 	NO_DBG_HEX(ulCharPos);
-	for (pCurr = pAnchor; pCurr != NULL; pCurr = pCurr->pNext) {
-		NO_DBG_HEX(pCurr->ulCharPos);
-		if (ulCharPos == pCurr->ulCharPos ||
-		    ulCharPos + 1 == pCurr->ulCharPos) {
+	if (apSectionTable == NULL) {
+		vBuildSectionTable();
+	}
+
+	if (!bSectionsSorted) {
+		/* Search the first match in the whole list */
+		for (pCurr = pAnchor; pCurr != NULL; pCurr = pCurr->pNext) {
 			NO_DBG_HEX(pCurr->ulCharPos);
-			return &pCurr->tInfo;
+			if (ulCharPos == pCurr->ulCharPos ||
+			    ulCharPos + 1 == pCurr->ulCharPos) {
+				NO_DBG_HEX(pCurr->ulCharPos);
+				return &pCurr->tInfo;
+			}
 		}
+		return pOld;
+	}
+
+	/* Find the first section that starts at or after ulCharPos */
+	if (ulCharPos < ulCursorCharPos) {
+		/* Going back; use a binary search */
+		tLow = 0;
+		tHigh = tSectionTableLen;
+		while (tLow < tHigh) {
+			tMid = (tLow + tHigh) / 2;
+			if (apSectionTable[tMid]->ulCharPos < ulCharPos) {
+				tLow = tMid + 1;
+			} else {
+				tHigh = tMid;
+			}
+		}
+		tSectionCursor = tLow;
+	} else {
+		while (tSectionCursor < tSectionTableLen &&
+		       apSectionTable[tSectionCursor]->ulCharPos < ulCharPos) {
+			tSectionCursor++;
+		}
+	}
+	ulCursorCharPos = ulCharPos;
+
+	if (tSectionCursor >= tSectionTableLen) {
+		return pOld;
+	}
+	pCurr = apSectionTable[tSectionCursor];
+	if (ulCharPos == pCurr->ulCharPos ||
+	    ulCharPos + 1 == pCurr->ulCharPos) {
+		NO_DBG_HEX(pCurr->ulCharPos);
+		return &pCurr->tInfo;
 	}
 	return pOld;
 } /* end of pGetSectionInfo */
@@ -133,14 +236,10 @@ pGetSectionInfo(const section_block_type *pOld, ULONG ulCharPos)
 size_t
 tGetNumberOfSections(void)
 {
-	const section_mem_type	*pCurr;
-	size_t	tCounter;
-
-	for (tCounter = 0, pCurr = pAnchor;
-	     pCurr != NULL;
-	     tCounter++, pCurr = pCurr->pNext)
-		;	/* Empty */
-	return tCounter;
+	if (apSectionTable == NULL) {
+		vBuildSectionTable();
+	}
+	return tSectionTableLen;
 } /* end of tGetNumberOfSections */
 
 /*
@@ -149,17 +248,13 @@ tGetNumberOfSections(void)
 UCHAR
 ucGetSepHdrFtrSpecification(size_t tSectionNumber)
 {
-	const section_mem_type	*pCurr;
-	size_t	tIndex;
-
-	for (tIndex = 0, pCurr = pAnchor;
-	     tIndex < tSectionNumber && pCurr != NULL;
-	     tIndex++, pCurr = pCurr->pNext)
-		;	/* Empty */
-	if (pCurr == NULL) {
+	if (apSectionTable == NULL) {
+		vBuildSectionTable();
+	}
+	if (tSectionNumber >= tSectionTableLen) {
 		DBG_DEC(tSectionNumber);
 		DBG_FIXME();
 		return 0x00;
 	}
-	return pCurr->tInfo.ucHdrFtrSpecification;
+	return apSectionTable[tSectionNumber]->tInfo.ucHdrFtrSpecification;
 } /* end of ucGetSepHdrFtrSpecification */
@@ -0,0 +1,200 @@
+/*
+ * stats.c
+ * Released under GNU GPL
+ *
+ * Description:
+ * Collect and show statistics about the conversion of a document
+ */
+
+#include <time.h>
+#include "antiword.h"
+
+/* The names as they appear in the output, in enum order */
+static const char	*aszPhaseNames[] = {
+	"init_document",
+	"properties",
+	"hdrftr_text",
+	"main_text",
+	"images",
+};
+static const char	*aszListNames[] = {
+	"text_blocks",
+	"fonts",
+	"styles",
+	"rows",
+	"pictures",
+	"sections",
+};
+
+/* Only time the phases when the statistics are wanted */
+static BOOL	bTiming = FALSE;
+/* The time spent in each phase (in seconds) */
+static double	adPhaseTotal[elementsof(aszPhaseNames)];
+static double	adPhaseStart[elementsof(aszPhaseNames)];
+/* The number of items added to each list */
+static ULONG	aulListItems[elementsof(aszListNames)];
+/* The input counters */
+static ULONG	ulReadCalls = 0;
+static ULONG	ulReadSeeks = 0;
+static ULONG	ulReadBytes = 0;
+static ULONG	ulNextOffset = 0;
+
+
+/*
+ * dGetTime - get the current time (in seconds)
+ *
+ * Use a monotonic clock when there is one, processor time otherwise
+ */
+static double
+dGetTime(void)
+{
+#if defined(CLOCK_MONOTONIC)
+	struct timespec	tNow;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &tNow) == 0) {
+		return (double)tNow.tv_sec + (double)tNow.tv_nsec / 1.0e9;
+	}
+#endif /* CLOCK_MONOTONIC */
+	return (double)clock() / (double)CLOCKS_PER_SEC;
+} /* end of dGetTime */
+
+/*
+ * vResetStatistics - start collecting for a new document
+ */
+void
+vResetStatistics(BOOL bTimePhases)
+{
+	size_t	tIndex;
+
+	bTiming = bTimePhases;
+	for (tIndex = 0; tIndex < elementsof(adPhaseTotal); tIndex++) {
+		adPhaseTotal[tIndex] = 0.0;
+		adPhaseStart[tIndex] = 0.0;
+	}
+	for (tIndex = 0; tIndex < elementsof(aulListItems); tIndex++) {
+		aulListItems[tIndex] = 0;
+	}
+	ulReadCalls = 0;
+	ulReadSeeks = 0;
+	ulReadBytes = 0;
+	ulNextOffset = 0;
+	vResetAllocStatistics();
+} /* end of vResetStatistics */
+
+/*
+ * vStartPhase - the given conversion phase starts
+ */
+void
+vStartPhase(stats_phase_enum ePhase)
+{
+	fail((size_t)ePhase >= elementsof(adPhaseStart));
+
+	if (!bTiming) {
+		return;
+	}
+	adPhaseStart[ePhase] = dGetTime();
+} /* end of vStartPhase */
+
+/*
+ * vStopPhase - the given conversion phase stops
+ */
+void
+vStopPhase(stats_phase_enum ePhase)
+{
+	fail((size_t)ePhase >= elementsof(adPhaseTotal));
+
+	if (!bTiming) {
+		return;
+	}
+	adPhaseTotal[ePhase] += dGetTime() - adPhaseStart[ePhase];
+} /* end of vStopPhase */
+
+/*
+ * vCountRead - count a read from the input file
+ *
+ * A read that does not start where the previous one ended counts as a seek
+ */
+void
+vCountRead(ULONG ulOffset, size_t tBytes)
+{
+	ulReadCalls++;
+	if (ulOffset != ulNextOffset) {
+		ulReadSeeks++;
+	}
+	ulReadBytes += (ULONG)tBytes;
+	ulNextOffset = ulOffset + (ULONG)tBytes;
+} /* end of vCountRead */
+
+/*
+ * vCountListItem - count an item added to the given list
+ */
+void
+vCountListItem(stats_list_enum eList)
+{
+	fail((size_t)eList >= elementsof(aulListItems));
+
+	aulListItems[eList]++;
+} /* end of vCountListItem */
+
+/*
+ * vPrintJsonString - print a string as a JSON string
+ */
+static void
+vPrintJsonString(FILE *pFile, const char *szString)
+{
+	const UCHAR	*pucChar;
+
+	putc('"', pFile);
+	for (pucChar = (const UCHAR *)szString; *pucChar != '\0'; pucChar++) {
+		if (*pucChar == '"' || *pucChar == '\\') {
+			putc('\\', pFile);
+			putc(*pucChar, pFile);
+		} else if (*pucChar < 0x20) {
+			fprintf(pFile, "\\u%04x", (UINT)*pucChar);
+		} else {
+			putc(*pucChar, pFile);
+		}
+	}
+	putc('"', pFile);
+} /* end of vPrintJsonString */
+
+/*
+ * vPrintStatistics - print the collected statistics as a JSON object
+ *
+ * lOutputBytes is the number of bytes written or -1 when unknown
+ */
+void
+vPrintStatistics(FILE *pFile, const char *szFilename, long lOutputBytes)
+{
+	size_t	tIndex;
+
+	fail(pFile == NULL);
+	fail(szFilename == NULL);
+
+	fprintf(pFile, "{\"file\": ");
+	vPrintJsonString(pFile, szFilename);
+	fprintf(pFile, ",\n \"phases\": {");
+	for (tIndex = 0; tIndex < elementsof(aszPhaseNames); tIndex++) {
+		fprintf(pFile, "%s\"%s\": %.6f",
+			tIndex == 0 ? "" : ", ",
+			aszPhaseNames[tIndex], adPhaseTotal[tIndex]);
+	}
+	fprintf(pFile, "},\n \"reads\": {");
+	fprintf(pFile, "\"calls\": %lu, \"seeks\": %lu, \"bytes\": %lu",
+		ulReadCalls, ulReadSeeks, ulReadBytes);
+	fprintf(pFile, "},\n \"lists\": {");
+	for (tIndex = 0; tIndex < elementsof(aszListNames); tIndex++) {
+		fprintf(pFile, "%s\"%s\": %lu",
+			tIndex == 0 ? "" : ", ",
+			aszListNames[tIndex], aulListItems[tIndex]);
+	}
+	fprintf(pFile, "},\n \"output_bytes\": ");
+	if (lOutputBytes < 0) {
+		fprintf(pFile, "null");
+	} else {
+		fprintf(pFile, "%ld", lOutputBytes);
+	}
+	fprintf(pFile, ",\n \"allocations\": ");
+	vPrintAllocStatistics(pFile);
+	fprintf(pFile, "}\n");
+} /* end of vPrintStatistics */
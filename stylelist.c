@@ -332,6 +332,7 @@ vAdd2StyleInfoList(const style_block_type *pStyleBlock)
 	}
 
 	/* Create list member */
+	vCountListItem(stats_list_styles);
 	pListMember = xmalloc(sizeof(style_mem_type));
 	/* Fill the list member */
 	pListMember->tInfo = *pStyleBlock;
@@ -188,6 +188,7 @@ vStoreChar(ULONG ulChar, BOOL bChangeAllowed, output_type *pOutput)
 				tLen,
 				pOutput->tFontRef,
 				pOutput->usFontSize);
+	vUpdateSplit(pOutput, tLen);
 } /* end of vStoreChar */
 
 /*
@@ -431,6 +432,7 @@ pStartNextOutput(output_type *pCurrent)
 	pNew->szStorage[0] = '\0';
 	pNew->tNextFree = 0;
 	pNew->lStringWidth = 0;
+	vResetSplit(pNew);
 	pNew->ucFontColor = FONT_COLOR_DEFAULT;
 	pNew->usFontStyle = FONT_REGULAR;
 	pNew->tFontRef = (drawfile_fontref)0;
@@ -484,6 +486,7 @@ pStartNewOutput(output_type *pAnchor, output_type *pLeftOver)
 		pLeftOver->szStorage[0] = '\0';
 		pLeftOver->tNextFree = 0;
 		pLeftOver->lStringWidth = 0;
+		vResetSplit(pLeftOver);
 		pLeftOver->ucFontColor = ucFontColor;
 		pLeftOver->usFontStyle = usFontStyle;
 		pLeftOver->tFontRef = tFontRef;
@@ -662,7 +665,9 @@ bWordDecryptor(FILE *pFile, long lFilesize, diagram_type *pDiag)
 
 	TRACE_MSG("bWordDecryptor");
 
+	vStartPhase(stats_phase_init_document);
 	iWordVersion = iInitDocument(pFile, lFilesize);
+	vStopPhase(stats_phase_init_document);
 	if (iWordVersion < 0) {
 		DBG_DEC(iWordVersion);
 		return FALSE;
@@ -670,10 +675,22 @@ bWordDecryptor(FILE *pFile, long lFilesize, diagram_type *pDiag)
 
 	vGetOptions(&tOptions);
 	bOldMacFile = bIsOldMacFile();
-	vPrepareHdrFtrText(pFile);
-	vPrepareFootnoteText(pFile);
+	/* Only prepare the texts the current backend will ask for */
+	vStartPhase(stats_phase_hdrftr_text);
+	switch (tOptions.eConversionType) {
+	case conversion_ps:
+	case conversion_pdf:
+		vPrepareHdrFtrText(pFile);
+		break;
+	case conversion_xml:
+		vPrepareFootnoteText(pFile);
+		break;
+	default:
+		break;
+	}
+	vStopPhase(stats_phase_hdrftr_text);
 
-	vPrologue2(pDiag, iWordVersion);
+	vPrologue2(pDiag, pFile, iWordVersion);
 
 	/* Initialisation */
 #if defined(__riscos)
@@ -748,6 +765,7 @@ bWordDecryptor(FILE *pFile, long lFilesize, diagram_type *pDiag)
 	NO_DBG_DEC(lWidthMax);
 
 	Hourglass_On();
+	vStartPhase(stats_phase_main_text);
 
 	uiFootnoteNumber = 0;
 	uiEndnoteNumber = 0;
@@ -1038,9 +1056,11 @@ bWordDecryptor(FILE *pFile, long lFilesize, diagram_type *pDiag)
 					RESET_LINE();
 				}
 #endif
+				vStartPhase(stats_phase_images);
 				bSuccess = bTranslateImage(pDiag, pFile,
 					eRes == image_minimal_information,
 					ulFileOffsetImage, &tImage);
+				vStopPhase(stats_phase_images);
 				break;
 			default:
 				DBG_DEC(eRes);
@@ -1222,6 +1242,7 @@ bWordDecryptor(FILE *pFile, long lFilesize, diagram_type *pDiag)
 			vSetLeftIndentation(pDiag, lLeftIndentation);
 		}
 	}
+	vStopPhase(stats_phase_main_text);
 
 	pAnchor = pStartNewOutput(pAnchor, NULL);
 	pAnchor->szStorage = xfree(pAnchor->szStorage);
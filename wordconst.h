@@ -28,6 +28,8 @@
 #define MIN_SIZE_FOR_BBD_USE		0x1000
 /* Table sizes */
 #define TABLE_COLUMN_MAX		 31
+/* Maximum number of runs in a Formatted Disk Page (FKP) */
+#define FKP_RUNS_MAX			101
 /* Maximum number of tabs positions in a paragraph */
 #define NUMBER_OF_TABS_MAX		 64
 /* Font sizes (in half-points) */
@@ -70,6 +72,9 @@
 /* Special istd values */
 #define ISTD_INVALID			USHRT_MAX
 #define ISTD_NORMAL			0
+/* Special values in the sprm length tables of Word 1/2/6/7 files */
+#define SPRM_VAR			0	/* Length in the next byte */
+#define SPRM_TAB			1	/* sprmPChgTabs */
 /* Properties modifier without value */
 #define IGNORE_PROPMOD			0
 /* Types of lists */
@@ -346,6 +346,7 @@ vFreeDocument(void)
 	vDestroyListInfoList();
 	vDestroyRowInfoList();
 	vDestroyStyleInfoList();
+	vDestroy8ChrStream();
 	vDestroyFontInfoList();
 	vDestroyStylesheetList();
 	vDestroyPictInfoList();
@@ -353,6 +354,7 @@ vFreeDocument(void)
 	vDestroySectionInfoList();
 	vDestroyHdrFtrInfoList();
 	vDestroyPropModList();
+	vDestroyPropertyCache();
 	vDestroyNotesInfoLists();
 	vDestroyFontTable();
 	vDestroySummaryInfo();
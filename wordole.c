@@ -556,13 +556,15 @@ vGetDocumentData(FILE *pFile, const pps_info_type *pPPS,
 	bHasImages = (usDocStatus & BIT(3)) != 0;
 
 	if (!bHasImages ||
-	    tOptions.eConversionType == conversion_text ||
-	    tOptions.eConversionType == conversion_fmt_text ||
-	    tOptions.eConversionType == conversion_xml ||
-	    tOptions.eImageLevel == level_no_images) {
+	    (tOptions.szExtractDirectory == NULL &&
+	     (tOptions.eConversionType == conversion_text ||
+	      tOptions.eConversionType == conversion_fmt_text ||
+	      tOptions.eConversionType == conversion_xml ||
+	      tOptions.eImageLevel == level_no_images))) {
 		/*
 		 * No images in the document or text-only output or
-		 * no images wanted, so no data blocks will be needed
+		 * no images wanted (and none to extract), so no data
+		 * blocks will be needed
 		 */
 		vDestroyDataBlockList();
 		return;
@@ -47,6 +47,14 @@ typedef struct output_tag {
 	long	lStringWidth;		/* In millipoints */
 	size_t	tStorageSize;
 	size_t	tNextFree;
+	/* The last place to split the string, kept up to date while storing */
+	BOOL	bSplitKnown;		/* FALSE: search the string */
+	size_t	tSplitIndex;		/* Split character plus one, 0: none */
+	long	lSplitWidth;		/* Width up to the split character */
+	size_t	tSplitKeep;		/* Bytes to keep when splitting */
+	long	lSplitKeepWidth;	/* Width of the bytes to keep */
+	size_t	tNonSpace;		/* Bytes up to the last non-space */
+	long	lNonSpaceWidth;		/* Width up to the last non-space */
 	USHORT	usFontStyle;
 	USHORT	usFontSize;
 	UCHAR	ucFontColor;
@@ -105,6 +113,11 @@ typedef struct options_tag {
 	int		iPageHeight;		/* In points */
 	int		iPageWidth;		/* In points */
 	image_level_enum	eImageLevel;
+	BOOL		bShowStatistics;
+	int		iCompressionLevel;	/* 0 = no compression */
+	BOOL		bBinaryImages;
+	const char	*szExtractDirectory;	/* NULL = no extraction */
+	BOOL		bStreamFontInfo;
 #if defined(__riscos)
 	BOOL		bAutofiletypeAllowed;
 	int		iScaleFactor;		/* As a percentage */
@@ -150,6 +163,13 @@ typedef struct document_block_tag {
 	UCHAR	ucHdrFtrSpecification;
 } document_block_type;
 
+/* Record of one run of a Formatted Disk Page (FKP) */
+typedef struct fkp_run_tag {
+	ULONG	ulCharPosStart;
+	ULONG	ulCharPosEnd;
+	int	iFodo;		/* Offset of the properties in the page */
+} fkp_run_type;
+
 /* Record of table-row block information */
 typedef struct row_block_tag {
 	ULONG	ulFileOffsetStart;
@@ -291,6 +311,7 @@ typedef struct imagedata_tag {
 	compression_enum	eCompression;	/* Type of compression */
 	BOOL	bColorImage;	/* Is color image */
 	int	iColorsUsed;	/* 0 = uses the maximum number of colors */
+	size_t	tDataLength;	/* PNG: total length of the IDAT chunks */
 	UCHAR 	aucPalette[256][3];	/* RGB palette */
 } imagedata_type;
 
@@ -302,6 +323,69 @@ typedef enum row_info_tag {
 	found_not_end_of_row
 } row_info_enum;
 
+/* The information blocks a grpprl can be decoded into */
+typedef enum sprm_target_tag {
+	sprm_target_section = 0,
+	sprm_target_row,
+	sprm_target_style,
+	sprm_target_font,
+	sprm_target_picture,
+	sprm_target_max		/* The number of targets */
+} sprm_target_enum;
+
+/*
+ * A sprm handler gets the decoder state of its target, the sprm (starting
+ * at the opcode), the number of bytes left in the grpprl and the parameter
+ * from the opcode table. It returns the number of bytes to skip, or 0 to
+ * skip the length of the sprm.
+ */
+typedef int (*sprm_handler_type)(void *, const UCHAR *, int, USHORT);
+
+/* One entry of an opcode table: a handler per target, NULL to ignore */
+typedef struct sprm_tag {
+	USHORT			usOpCode;
+	USHORT			usParam;
+	sprm_handler_type	apfHandler[sprm_target_max];
+} sprm_type;
+
+/* The opcode table of one version of Word */
+typedef struct sprm_table_tag {
+	const sprm_type	*atSprm;	/* Sorted by opcode */
+	size_t		tSprms;
+	int		iOpCodeLen;	/* The size of an opcode in bytes */
+	int		(*piGetLength)(int, const UCHAR *);
+} sprm_table_type;
+
+/* The decoder state of the row information */
+typedef struct row_sprm_tag {
+	row_block_type	*pRow;
+	BOOL	bCell0;		/* Found fInTable switched off */
+	BOOL	bCell1;		/* Found fInTable switched on */
+	BOOL	bRowEnd0;	/* Found fTtp switched off */
+	BOOL	bRowEnd1;	/* Found fTtp switched on */
+	BOOL	bDefTable;	/* Found the cell definitions */
+} row_sprm_type;
+
+/* The decoder state of the style information */
+typedef struct style_sprm_tag {
+	style_block_type	*pStyle;
+	list_block_type		tList6;	/* Word 6 style list information */
+} style_sprm_type;
+
+/* The decoder state of the font information */
+typedef struct font_sprm_tag {
+	font_block_type	*pFont;
+	USHORT	usIstd;
+	USHORT	ausFtc[3];	/* The Word 8 font numbers, USHRT_MAX if unset */
+} font_sprm_type;
+
+/* The decoder state of the picture information */
+typedef struct picture_sprm_tag {
+	picture_block_type	*pPicture;
+	BOOL	bFound;		/* Found the picture offset */
+	BOOL	bOle;		/* Not a picture, but an OLE object */
+} picture_sprm_type;
+
 typedef enum notetype_tag {
 	notetype_is_footnote,
 	notetype_is_endnote,
@@ -314,4 +398,23 @@ typedef enum image_info_tag {
 	image_full_information
 } image_info_enum;
 
+/* Conversion phases for the run statistics */
+typedef enum stats_phase_tag {
+	stats_phase_init_document = 0,
+	stats_phase_properties,
+	stats_phase_hdrftr_text,
+	stats_phase_main_text,
+	stats_phase_images
+} stats_phase_enum;
+
+/* Lists counted by the run statistics */
+typedef enum stats_list_tag {
+	stats_list_text_blocks = 0,
+	stats_list_fonts,
+	stats_list_styles,
+	stats_list_rows,
+	stats_list_pictures,
+	stats_list_sections
+} stats_list_enum;
+
 #endif /* __wordtypes_h */
@@ -4,12 +4,60 @@
  *
  * Description:
  * Extended malloc and friends
+ *
+ * When compiled with ALLOC_PROFILE every allocation is counted per size
+ * class and per call site and the live bytes are tracked.  The results
+ * are shown with the other statistics (option -S).
  */
 
 #include <stdlib.h>
 #include <string.h>
 #include "antiword.h"
 
+#if defined(ALLOC_PROFILE)
+/* The real functions, the macros from antiword.h add the call site */
+#undef xmalloc
+#undef xcalloc
+#undef xrealloc
+#undef xstrdup
+
+#define ALLOC_SITES_MAX		512
+#define ALLOC_SITES_SHOWN	 10
+
+/* In front of every block, to remember its size */
+typedef union alloc_header_tag {
+	size_t	tSize;
+	long	lAlign;
+	double	dAlign;
+	void	*pvAlign;
+} alloc_header_type;
+
+typedef struct alloc_site_tag {
+	const char	*szFile;
+	int		iLine;
+	ULONG		ulCalls;
+	ULONG		ulBytes;
+} alloc_site_type;
+
+/* The upper limits of the size classes, the last one has no limit */
+static const ULONG	aulClassLimit[] = {
+	16, 64, 256, 1024, 4096, 16384, 65536, ULONG_MAX,
+};
+static ULONG	aulClassCalls[elementsof(aulClassLimit)];
+static ULONG	aulClassBytes[elementsof(aulClassLimit)];
+static alloc_site_type	atSites[ALLOC_SITES_MAX];
+static size_t	tSitesUsed = 0;
+static ULONG	ulMallocCalls = 0;
+static ULONG	ulCallocCalls = 0;
+static ULONG	ulReallocCalls = 0;
+static ULONG	ulFreeCalls = 0;
+static ULONG	ulLiveBytes = 0;
+static ULONG	ulPeakBytes = 0;
+/* The call site of the current allocation */
+static const char	*szSiteFile = NULL;
+static int		iSiteLine = 0;
+#endif /* ALLOC_PROFILE */
+
 static char *szMessage =
 	"Memory allocation failed, unable to continue";
 #if defined(__dos) && !defined(__DJGPP__)
@@ -18,6 +66,193 @@ static char *szDosMessage =
 #endif /* __dos && !__DJGPP__ */
 
 
+#if defined(ALLOC_PROFILE)
+/*
+ * vRecordAllocation - record an allocation of the given size
+ */
+static void
+vRecordAllocation(size_t tSize)
+{
+	alloc_site_type	*pSite;
+	size_t	tIndex;
+
+	for (tIndex = 0; tIndex < elementsof(aulClassLimit) - 1; tIndex++) {
+		if ((ULONG)tSize <= aulClassLimit[tIndex]) {
+			break;
+		}
+	}
+	aulClassCalls[tIndex]++;
+	aulClassBytes[tIndex] += (ULONG)tSize;
+
+	ulLiveBytes += (ULONG)tSize;
+	if (ulLiveBytes > ulPeakBytes) {
+		ulPeakBytes = ulLiveBytes;
+	}
+
+	if (szSiteFile == NULL) {
+		/* Not called via one of the macros */
+		szSiteFile = "unknown";
+		iSiteLine = 0;
+	}
+	for (tIndex = 0; tIndex < tSitesUsed; tIndex++) {
+		pSite = &atSites[tIndex];
+		if (pSite->iLine == iSiteLine &&
+		    (pSite->szFile == szSiteFile ||
+		     STREQ(pSite->szFile, szSiteFile))) {
+			break;
+		}
+	}
+	if (tIndex >= tSitesUsed && tSitesUsed < elementsof(atSites)) {
+		tIndex = tSitesUsed;
+		tSitesUsed++;
+		atSites[tIndex].szFile = szSiteFile;
+		atSites[tIndex].iLine = iSiteLine;
+		atSites[tIndex].ulCalls = 0;
+		atSites[tIndex].ulBytes = 0;
+	}
+	if (tIndex < tSitesUsed) {
+		atSites[tIndex].ulCalls++;
+		atSites[tIndex].ulBytes += (ULONG)tSize;
+	}
+	szSiteFile = NULL;
+	iSiteLine = 0;
+} /* end of vRecordAllocation */
+
+/*
+ * pvAllocated - the block to hand out for the given real block
+ */
+static void *
+pvAllocated(alloc_header_type *pHeader, size_t tSize)
+{
+	pHeader->tSize = tSize;
+	vRecordAllocation(tSize);
+	return pHeader + 1;
+} /* end of pvAllocated */
+
+/*
+ * xmalloc_at - xmalloc with the call site
+ */
+void *
+xmalloc_at(size_t tSize, const char *szFile, int iLine)
+{
+	szSiteFile = szFile;
+	iSiteLine = iLine;
+	return xmalloc(tSize);
+} /* end of xmalloc_at */
+
+/*
+ * xcalloc_at - xcalloc with the call site
+ */
+void *
+xcalloc_at(size_t tNmemb, size_t tSize, const char *szFile, int iLine)
+{
+	szSiteFile = szFile;
+	iSiteLine = iLine;
+	return xcalloc(tNmemb, tSize);
+} /* end of xcalloc_at */
+
+/*
+ * xrealloc_at - xrealloc with the call site
+ */
+void *
+xrealloc_at(void *pvArg, size_t tSize, const char *szFile, int iLine)
+{
+	szSiteFile = szFile;
+	iSiteLine = iLine;
+	return xrealloc(pvArg, tSize);
+} /* end of xrealloc_at */
+
+/*
+ * xstrdup_at - xstrdup with the call site
+ */
+char *
+xstrdup_at(const char *szArg, const char *szFile, int iLine)
+{
+	szSiteFile = szFile;
+	iSiteLine = iLine;
+	return xstrdup(szArg);
+} /* end of xstrdup_at */
+#endif /* ALLOC_PROFILE */
+
+/*
+ * vResetAllocStatistics - start counting the allocations for a new document
+ *
+ * The bytes that are still in use stay in use
+ */
+void
+vResetAllocStatistics(void)
+{
+#if defined(ALLOC_PROFILE)
+	size_t	tIndex;
+
+	for (tIndex = 0; tIndex < elementsof(aulClassLimit); tIndex++) {
+		aulClassCalls[tIndex] = 0;
+		aulClassBytes[tIndex] = 0;
+	}
+	tSitesUsed = 0;
+	ulMallocCalls = 0;
+	ulCallocCalls = 0;
+	ulReallocCalls = 0;
+	ulFreeCalls = 0;
+	ulPeakBytes = ulLiveBytes;
+#endif /* ALLOC_PROFILE */
+} /* end of vResetAllocStatistics */
+
+/*
+ * vPrintAllocStatistics - print the allocation statistics as JSON value
+ *
+ * Prints null when the allocations are not profiled
+ */
+void
+vPrintAllocStatistics(FILE *pFile)
+{
+#if defined(ALLOC_PROFILE)
+	alloc_site_type	tTmp;
+	size_t	tIndex, tSorted;
+
+	fail(pFile == NULL);
+
+	fprintf(pFile, "{\"malloc\": %lu, \"calloc\": %lu, "
+		"\"realloc\": %lu, \"free\": %lu,\n",
+		ulMallocCalls, ulCallocCalls, ulReallocCalls, ulFreeCalls);
+	fprintf(pFile, "  \"live_bytes\": %lu, \"peak_bytes\": %lu,\n",
+		ulLiveBytes, ulPeakBytes);
+	fprintf(pFile, "  \"size_classes\": [");
+	for (tIndex = 0; tIndex < elementsof(aulClassLimit); tIndex++) {
+		fprintf(pFile, "%s{\"max\": ", tIndex == 0 ? "" : ", ");
+		if (aulClassLimit[tIndex] == ULONG_MAX) {
+			fprintf(pFile, "null");
+		} else {
+			fprintf(pFile, "%lu", aulClassLimit[tIndex]);
+		}
+		fprintf(pFile, ", \"calls\": %lu, \"bytes\": %lu}",
+			aulClassCalls[tIndex], aulClassBytes[tIndex]);
+	}
+	fprintf(pFile, "],\n  \"sites\": [");
+	/* Show the sites with the most bytes first */
+	for (tSorted = 0;
+	     tSorted < tSitesUsed && tSorted < ALLOC_SITES_SHOWN;
+	     tSorted++) {
+		for (tIndex = tSorted + 1; tIndex < tSitesUsed; tIndex++) {
+			if (atSites[tIndex].ulBytes >
+			    atSites[tSorted].ulBytes) {
+				tTmp = atSites[tSorted];
+				atSites[tSorted] = atSites[tIndex];
+				atSites[tIndex] = tTmp;
+			}
+		}
+		fprintf(pFile, "%s\n   {\"site\": \"%s:%d\", "
+			"\"calls\": %lu, \"bytes\": %lu}",
+			tSorted == 0 ? "" : ",",
+			atSites[tSorted].szFile, atSites[tSorted].iLine,
+			atSites[tSorted].ulCalls, atSites[tSorted].ulBytes);
+	}
+	fprintf(pFile, "]}");
+#else
+	fprintf(pFile, "null");
+#endif /* ALLOC_PROFILE */
+} /* end of vPrintAllocStatistics */
+
 /*
  * xmalloc - Allocates dynamic memory
  *
@@ -34,13 +269,22 @@ xmalloc(size_t tSize)
 	if (tSize == 0) {
 		tSize = 1;
 	}
+#if defined(ALLOC_PROFILE)
+	ulMallocCalls++;
+	pvTmp = malloc(sizeof(alloc_header_type) + tSize);
+#else
 	pvTmp = malloc(tSize);
+#endif /* ALLOC_PROFILE */
 	if (pvTmp == NULL) {
 		DBG_MSG("xmalloc returned NULL");
 		DBG_DEC(tSize);
 		werr(1, szMessage);
 	}
+#if defined(ALLOC_PROFILE)
+	return pvAllocated(pvTmp, tSize);
+#else
 	return pvTmp;
+#endif /* ALLOC_PROFILE */
 } /* end of xmalloc */
 
 /*
@@ -66,12 +310,26 @@ xcalloc(size_t tNmemb, size_t tSize)
 		tNmemb = 1;
 		tSize = 1;
 	}
+#if defined(ALLOC_PROFILE)
+	ulCallocCalls++;
+	if (tSize > (SIZE_T_MAX - sizeof(alloc_header_type)) / tNmemb) {
+		DBG_MSG("xcalloc overflow");
+		werr(1, szMessage);
+	}
+	tSize *= tNmemb;
+	pvTmp = calloc(1, sizeof(alloc_header_type) + tSize);
+#else
 	pvTmp = calloc(tNmemb, tSize);
+#endif /* ALLOC_PROFILE */
 	if (pvTmp == NULL) {
 		DBG_MSG("xcalloc returned NULL");
 		werr(1, szMessage);
 	}
+#if defined(ALLOC_PROFILE)
+	return pvAllocated(pvTmp, tSize);
+#else
 	return pvTmp;
+#endif /* ALLOC_PROFILE */
 } /* end of xcalloc */
 
 /*
@@ -87,12 +345,25 @@ xrealloc(void *pvArg, size_t tSize)
 
 	TRACE_MSG("xrealloc");
 
+#if defined(ALLOC_PROFILE)
+	ulReallocCalls++;
+	if (pvArg != NULL) {
+		pvArg = (alloc_header_type *)pvArg - 1;
+		ulLiveBytes -= (ULONG)((alloc_header_type *)pvArg)->tSize;
+	}
+	pvTmp = realloc(pvArg, sizeof(alloc_header_type) + tSize);
+#else
 	pvTmp = realloc(pvArg, tSize);
+#endif /* ALLOC_PROFILE */
 	if (pvTmp == NULL) {
 		DBG_MSG("realloc returned NULL");
 		werr(1, szMessage);
 	}
+#if defined(ALLOC_PROFILE)
+	return pvAllocated(pvTmp, tSize);
+#else
 	return pvTmp;
+#endif /* ALLOC_PROFILE */
 } /* end of xrealloc */
 
 /*
@@ -130,6 +401,11 @@ xfree(void *pvArg)
 	TRACE_MSG("xfree");
 
 	if (pvArg != NULL) {
+#if defined(ALLOC_PROFILE)
+		ulFreeCalls++;
+		pvArg = (alloc_header_type *)pvArg - 1;
+		ulLiveBytes -= (ULONG)((alloc_header_type *)pvArg)->tSize;
+#endif /* ALLOC_PROFILE */
 		free(pvArg);
 	}
 	return NULL;